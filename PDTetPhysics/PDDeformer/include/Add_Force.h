@@ -9,3 +9,39 @@ void Add_Force(const T_DATA (&x_Blocked)[4][3],
                const T_DATA &strainMin,
                const T_DATA &strainMax,
                T_DATA (&f_Blocked)[4][3]);
+
+// Instruction sets Add_Force can be built for.  Each non-scalar one lives in its own
+// translation unit compiled with the matching target flags (Add_Force_AVX2.cpp, ...),
+// so the library still loads on CPUs that lack them.
+enum class Add_Force_Architecture { Scalar, AVX2, AVX512, NEON };
+
+#define ADD_FORCE_BLOCK_ARGUMENTS(T,WIDTH)         \
+    const T (&x_Blocked)[4][3][WIDTH],             \
+        const T (&DmInverse_Blocked)[9][WIDTH],    \
+        const T (&restVolume)[WIDTH],              \
+        const T (&muLow)[WIDTH],                   \
+        const T (&muHigh)[WIDTH],                  \
+        const T (&strainMin)[WIDTH],               \
+        const T (&strainMax)[WIDTH],               \
+        T (&f_Blocked)[4][3][WIDTH]
+
+template<class T, int BlockWidth>
+using Add_Force_Block_Type = void (*)(ADD_FORCE_BLOCK_ARGUMENTS(T, BlockWidth));
+
+// Runs Add_Force over one whole BlockWidth-wide block, Tarch::Width lanes at a time.
+template<Add_Force_Architecture Arch, class T, int BlockWidth>
+void Add_Force_Block(ADD_FORCE_BLOCK_ARGUMENTS(T, BlockWidth));
+
+template<> void Add_Force_Block<Add_Force_Architecture::Scalar, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16));
+template<> void Add_Force_Block<Add_Force_Architecture::AVX2, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16));
+template<> void Add_Force_Block<Add_Force_Architecture::AVX512, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16));
+template<> void Add_Force_Block<Add_Force_Architecture::NEON, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16));
+
+// Picks the widest instance that was both built and is supported by the running CPU
+// (AVX-512, then AVX2, then scalar on x86-64; NEON on arm64).
+template<class T, int BlockWidth>
+Add_Force_Block_Type<T, BlockWidth> Select_Add_Force_Block(Add_Force_Architecture &selected);
+
+template<> Add_Force_Block_Type<float, 16> Select_Add_Force_Block<float, 16>(Add_Force_Architecture &selected);
+
+const char* Add_Force_Architecture_Name(const Add_Force_Architecture arch);
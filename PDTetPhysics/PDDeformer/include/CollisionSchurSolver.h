@@ -0,0 +1,162 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+#pragma once
+
+#include <array>
+#include <map>
+#include <vector>
+
+#include "SchurSolver.h"
+
+namespace PhysBAM {
+
+// CPU replacement for CudaSolver. With the nodes split into interior (1) and collision (2) nodes,
+//
+//     K = [ K11 K12 ]      S = K22 - K21 K11^{-1} K12 = Sigma1 + A22
+//         [ K21 K22 ]
+//
+// K11 is factored by an ordinary sparse SchurSolver and S is assembled densely from it, so no
+// Schur complement support is needed from the sparse backend. A22 is the stiffness of the elements
+// whose nodes are all collision nodes; Sigma1 is everything else condensed onto the collision nodes.
+// Hook and suture edits change K by a few rank 1 terms; S is then corrected in place by the matching
+// low rank term instead of being condensed again (see updateSchurComplement()).
+// Collision constraints and self-collision sutures add W^T D W. When the active collision set changes,
+// the added and removed rows of W are applied to the Cholesky factor of S + W^T D W as a rank K
+// update/downdate; LAPACK potrf refactors it only when that fails or has grown too costly.
+template <class Discretization, class IntType> struct CollisionSchurSolver {
+    using InteriorSolverType = SchurSolver<Discretization, IntType>;
+    using DiscretizationType = Discretization;
+    using StateVariableType = typename InteriorSolverType::StateVariableType;
+    using IteratorType = typename InteriorSolverType::IteratorType;
+
+    using IndexType = typename InteriorSolverType::IndexType;
+    using VectorType = typename InteriorSolverType::VectorType;
+    using T = typename InteriorSolverType::T;
+    static constexpr int d = InteriorSolverType::d;
+
+    using GradientMatrixType = typename InteriorSolverType::GradientMatrixType;
+    static constexpr int elementNodes = InteriorSolverType::elementNodes;
+    using ElementType = typename InteriorSolverType::ElementType;
+    using NodeArrayType = typename InteriorSolverType::NodeArrayType;
+    using NumberingArrayType = typename InteriorSolverType::NumberingArrayType;
+
+    using Constraint = typename InteriorSolverType::Constraint;
+    using Suture = typename InteriorSolverType::Suture;
+    using CollisionSuture = typename InteriorSolverType::CollisionSuture;
+    using InternodeConstraint = typename InteriorSolverType::InternodeConstraint;
+
+    // one row of W with its entry of D; rows are in the dense block, -1 for nodes outside it
+    struct CollisionTerm {
+        std::array<IntType, elementNodes * 2> m_rows;
+        std::array<T, elementNodes * 2> m_weights;
+        T m_stiffness;
+        bool operator==(const CollisionTerm& other) const {
+            return m_stiffness == other.m_stiffness && m_rows == other.m_rows && m_weights == other.m_weights;
+        }
+        bool operator<(const CollisionTerm& other) const {
+            if (m_rows != other.m_rows)
+                return m_rows < other.m_rows;
+            if (m_weights != other.m_weights)
+                return m_weights < other.m_weights;
+            return m_stiffness < other.m_stiffness;
+        }
+    };
+
+    IntType schurSize = IntType(0);
+    NumberingArrayType m_schurNumbering; // collision nodes numbered 0..schurSize-1, -1 otherwise
+    InteriorSolverType m_interior; // K11; the collision nodes are left out as if they were Dirichlet
+
+    std::vector<std::map<int, T>> m_elementCoupling; // element part of K12, by collision column
+    std::vector<T> m_elementK22; // element part of K22
+    std::vector<IntType> m_couplingOffsets; // K12 with the current hooks and sutures, compressed by collision column
+    std::vector<IntType> m_couplingRows;
+    std::vector<T> m_couplingValues;
+
+    // dense schurSize x schurSize blocks, row major, only the upper triangle is kept
+    std::vector<T> m_Sigma1;
+    bool m_schurValid = false;
+    std::vector<Constraint> m_schurConstraints; // constraint state Sigma1 was condensed with
+    std::vector<Constraint> m_schurFakeSutures;
+    std::vector<Suture> m_schurSutures;
+    std::vector<InternodeConstraint> m_schurMicroNodes;
+    std::vector<T> m_pendingVectors; // Sigma1 corrections not yet in m_factor: sum_t sign_t x_t x_t^T, x_t contiguous
+    std::vector<T> m_pendingSigns;
+    std::vector<T> m_A22;
+    std::vector<T> m_factor; // Cholesky factor of Sigma1 + A22 + W^T D W + m_factorShift I
+    std::vector<CollisionTerm> m_factoredTerms; // W and D that m_factor was built with, sorted
+    bool m_factorValid = false;
+    T m_factorShift = T(0); // nonzero only when the block had to be regularized to factor
+    int m_factorUpdates = 0; // rank 1 updates and downdates applied to m_factor since it was last refactored
+    static constexpr int maxUpdateRankDivisor = 24; // refactor instead once that would pass schurSize / maxUpdateRankDivisor
+
+    // per coordinate, one after the other
+    std::vector<T> m_interiorX; // K11^{-1} f1
+    std::vector<T> m_f2; // right hand side of the collision block
+    std::vector<T> m_dx2; // collision node displacement accumulated over the inner iterations
+    std::vector<T> m_x2;
+
+    void initialize(const NodeArrayType& nodeType);
+
+    void computeTensor(const std::vector<ElementType>& elements, const std::vector<GradientMatrixType>& gradients, const std::vector<T>& restVol, const std::vector<T>& muLow, const std::vector<T>& muHigh, const std::vector<Suture>& sutures, const std::vector<InternodeConstraint>& microNodes);
+
+    void computeE2Tensor(const std::vector<ElementType>& elements, const std::vector<ElementFlag>& flags, const std::vector<GradientMatrixType>& gradients, const std::vector<T>& restVol, const std::vector<T>& muLow, const std::vector<T>& muHigh);
+
+    void initializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes);
+
+    void reInitializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes);
+
+    inline bool initializeCollision(const std::vector<Constraint>& collisionConstraints, const std::vector<CollisionSuture>& collisionSutures) {
+        m_factorValid = false;
+        return updateCollision(collisionConstraints, collisionSutures);
+    }
+
+    // Refactors the collision block if the active collision constraints or sutures differ from the factored ones.
+    // Returns false, leaving the factor invalid, if the block could not be factored even with a diagonal shift;
+    // solveCollision() must not be called until a later update succeeds.
+    bool updateCollision(const std::vector<Constraint>& collisionConstraints, const std::vector<CollisionSuture>& collisionSutures);
+
+    // potrf on the block in m_factor, regularized once on failure
+    bool factorCollisionBlock();
+
+    // applies the collision terms that changed and the pending Sigma1 corrections as a rank K update/downdate
+    // of m_factor; false means refactor
+    bool updateFactor(const std::vector<CollisionTerm>& added, const std::vector<CollisionTerm>& removed);
+
+    bool choleskyRankUpdate(T* const vectors, const T* const signs, const int rank);
+
+    // condenses f (interior elastic, hook and suture forces) onto the collision nodes
+    void eliminateInterior(const StateVariableType& f);
+
+    // one inner iteration: solves the collision block against the condensed force plus g and
+    // writes the collision node displacement into dx, leaving the other nodes untouched
+    void solveCollision(const StateVariableType& g, StateVariableType& dx);
+
+    // interior displacement that goes with the collision node displacement accumulated since eliminateInterior()
+    void recoverInterior(StateVariableType& dx);
+
+    template <int elementNodesN, class MatrixType>
+    void accumToBlocks(const MatrixType& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex,
+        std::vector<std::map<int, T>>& coupling, std::vector<T>& K22) const;
+
+    // K12 and K22 with the current hooks and sutures; K12 compressed by collision column into m_coupling*
+    void assembleCoupling(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes, std::vector<T>& K22);
+
+    // Sigma1 from scratch, one interior solve per d coupled collision columns; consumes K22
+    void computeSchurComplement(std::vector<T>& K22);
+
+    // Corrects Sigma1 for the constraints that changed since it was condensed. False if there are more than the
+    // interior solver's low rank budget of them, or the correction is singular; Sigma1 is then left untouched.
+    bool updateSchurComplement(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes);
+
+    inline void setLowRankBudget(const int rank) { m_interior.setLowRankBudget(rank); }
+
+    void inline releasePardiso() {
+        m_interior.releasePardiso();
+    }
+
+    void deallocate();
+};
+
+} // namespace PhysBAM
@@ -7,6 +7,7 @@
 
 #include <PhysBAM_Tools/Matrices/MATRIX_2X2.h>
 #include <PhysBAM_Tools/Matrices/MATRIX_3X3.h>
+#include <PhysBAM_Tools/Matrices/MATRIX_4X4.h>
 #include <PhysBAM_Tools/Matrices/MATRIX_MXN.h>
 
 #include <PhysBAM_Tools/Math_Tools/FACTORIAL.h>
@@ -39,6 +40,7 @@ template <class StateVariable> struct TetrahedralDiscretization {
     using ShapeMatrixType = MATRIX<T, d>;
     using GradientMatrixType = MATRIX<T, d>;
     using MatrixType = MATRIX<T, d>;
+    using ElementMatrixType = MATRIX<T, elementNodes>;
 
     static inline ElementIndexType &getElementIndex(ElementType &element) { return element; }
 
@@ -205,6 +207,28 @@ template <class StateVariable> struct TetrahedralDiscretization {
         stiffnessMatrix = S * DmInverse * DmInverse.Transposed() * S.Transposed() * constant;
     }
 
+    // Same tensor without the heap temporaries, for the per element assembly loops. B = S * DmInverse is
+    // DmInverse with minus the sum of its rows stacked on top, and the tensor is B * B^T * constant.
+    static void computeElementTensor(ElementMatrixType& stiffnessMatrix,
+                              const GradientMatrixType &gradientMatrix,
+                              const T constant) {
+        T B[elementNodes][d];
+        for (int j = 0; j < d; j++) {
+            B[0][j] = 0;
+            for (int i = 0; i < d; i++) {
+                B[i + 1][j] = gradientMatrix(i + 1, j + 1);
+                B[0][j] -= gradientMatrix(i + 1, j + 1);
+            }
+        }
+        for (int i = 0; i < elementNodes; i++)
+            for (int j = i; j < elementNodes; j++) {
+                T sum = 0;
+                for (int k = 0; k < d; k++)
+                    sum += B[i][k] * B[j][k];
+                stiffnessMatrix(i + 1, j + 1) = stiffnessMatrix(j + 1, i + 1) = sum * constant;
+            }
+    }
+
     static void computeMicroNodeTensor(MATRIX_MXN<T>& stiffnessMatrix, std::array<IndexType, d+1>& elementIndex, const InternodeConstraint& microNode) {
         for (int i = 0; i < d; i++) {
             elementIndex[i] = microNode.m_macroNodes[i];
@@ -12,10 +12,12 @@
 // #include "Algebra.h"
 #include "SimulationFlags.h"
 #include "PDConstraints.h"
+#include "Telemetry.h"
 
 
 #include <Common/KernelCommon.h>
 #include "ReshapeDataStructure.h"
+#include "Add_Force.h"
 
 #include <PhysBAM_Tools/Math_Tools/FACTORIAL.h>
 
@@ -59,7 +61,6 @@ namespace PhysBAM {
         using DiagonalMatrixType = DIAGONAL_MATRIX<T, d>;
         using NodeArrayType = typename IteratorType::template ContainerType<NodeType>;
 
-        using Tarch = typename SIMD_Numeric_Kernel::template SIMDArchitectureScalar<T>;
         static constexpr int BlockWidth = 16;
         static constexpr int Alignment = 64;
         using BlockedShapeMatrixType = T (*) [d+1][d][BlockWidth];
@@ -88,6 +89,16 @@ namespace PhysBAM {
         std::vector<CollisionSuture> m_collisionSutures;
         std::vector<InternodeConstraint> m_InternodeConstraints;  // COURT added
 
+        // Hooks and sutures are addressed through handles that survive compactConstraints().  Deleting one zeroes its stiffness
+        // and retires the handle; compaction later squeezes the dead entries out of the arrays walked on every solve.
+        std::vector<int> m_constraintSlots;     // hook handle -> index in m_constraints, -1 once deleted
+        std::vector<int> m_constraintHandles;   // index in m_constraints -> hook handle, -1 once deleted
+        std::vector<int> m_sutureSlots;         // suture handle -> index in m_sutures, or -2 - pair index in m_fakeSutures; -1 once deleted
+        std::vector<int> m_sutureHandles;       // index in m_sutures -> suture handle, -1 once deleted
+        std::vector<int> m_fakeSutureHandles;   // pair index in m_fakeSutures -> suture handle, -1 once deleted
+        int m_deadConstraints = 0;              // entries retired since the last compaction, a fake suture pair counting once
+        static constexpr int CompactionSlack = 64;
+
         std::vector<GradientMatrixType> m_gradientMatrix;
 
         // reshaped data
@@ -110,6 +121,10 @@ namespace PhysBAM {
         BlockedScalarType m_reshapeUncollisionRangeMin = nullptr;
         BlockedScalarType m_reshapeUncollisionRangeMax = nullptr;
 
+        // force blocks filled by addElasticForce(), kept between calls instead of allocated per solve
+        BlockedShapeMatrixType m_reshapeUncollisionf = nullptr;
+        BlockedShapeMatrixType m_reshapeCollisionf = nullptr;
+
         // auxilary structure
         std::vector<int> m_reshapeUncollisionIndicesOffsets;
         std::vector<int> m_reshapeCollisionIndicesOffsets;
@@ -118,6 +133,10 @@ namespace PhysBAM {
         BlockedElementType m_reshapeUncollisionElement;
         BlockedElementType m_reshapeCollisionElement;
 
+        // Widest Add_Force instance the running CPU supports, chosen once at construction.
+        Add_Force_Block_Type<T, BlockWidth> m_addForceBlock;
+        Add_Force_Architecture m_addForceArchitecture;
+
         // std::function<void(const GeometryType &, const NodeArrayType &, StateVariableType &)> m_clearDirichlet;
 
 		GridDeformerTet() /*:m_uniformMu(muIn)*/ {
@@ -135,6 +154,8 @@ namespace PhysBAM {
 			m_reshapeCollisionElement = nullptr;
 
 			static_assert((BlockWidth * sizeof(T)) % Alignment == 0, "Blocks don't have requisite alignment");
+
+			m_addForceBlock = Select_Add_Force_Block<T, BlockWidth>(m_addForceArchitecture);
 		}
 
         void initializeDeformer();
@@ -142,7 +163,8 @@ namespace PhysBAM {
 		void initializeAuxiliaryStructures();
         void updatePositionBasedState(const ElementFlag flag/*, const T rangeMin = 1, const T rangeMax = 1*/);
         void addCollisionForce(StateVariableType &f) const;
-        void addConstraintForce(StateVariableType &f) const;
+        // stats, when given, collects the hook displacement/force maxima and safety clamps
+        void addConstraintForce(StateVariableType &f, SolveStats<T>* stats = nullptr) const;
         void addElasticForce(StateVariableType &SIMDf, const ElementFlag flag /*, const T rangeMin, const T rangeMax, const T weightProportion */ ) const;
         void clearDirichlet(StateVariableType &var) {
             /*
@@ -161,6 +183,22 @@ namespace PhysBAM {
 
         void deallocateAuxiliaryStructures();
         void initializeElementFlags();
+
+        int addConstraint(const Constraint& constraint);  // returns hook handle
+        inline Constraint* constraint(const int handle) {  // nullptr once deleted
+            const int slot = (handle < 0 || handle >= (int)m_constraintSlots.size()) ? -1 : m_constraintSlots[handle];
+            return slot < 0 ? nullptr : &m_constraints[slot];
+        }
+        bool deleteConstraint(const int handle);
+        int addFakeSuture(const Constraint& constraint0, const Constraint& constraint1);  // returns suture handle
+        bool deleteSuture(const int handle);
+        void promoteFakeSutures();  // fake suture pairs become real sutures, keeping their handles
+        void clearConstraints();
+        // Compaction shifts the survivors, so the solver has to refactor afterwards rather than diff against what it factored.
+        bool compactConstraints();
+        inline bool compactionDue() const {
+            return m_deadConstraints > CompactionSlack && m_deadConstraints > (int)(m_constraints.size() + m_sutures.size() + m_fakeSutures.size() / 2) - m_deadConstraints;
+        }
     };
 
 } // namespace PhysBAM
@@ -0,0 +1,193 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace PhysBAM {
+
+enum class IterationAcceleration { None, Anderson, Chebyshev };
+
+// Turns the update dx = K^{-1} f(x) of one local/global iteration of PDTetSolver::solve() into the next
+// iterate. The plain fixed point iteration is x <- g(x) = x + dx; Anderson mixing (type II, over the last
+// m_andersonDepth iterates) and Chebyshev semi-iteration reuse earlier iterates to reach the fixed point in
+// fewer steps. The history belongs to one solver and is dropped by restart() whenever the system changes
+// under it, or by step() itself when the plain update grows by more than m_restartGrowth.
+//
+// Positions are handled as flat arrays of n nodes with d coordinates each.
+template <class T, int d> struct IterationPolicy {
+    IterationAcceleration m_acceleration = IterationAcceleration::Anderson;
+    int m_andersonDepth = 5;
+    T m_chebyshevRho = T(.95); // spectral radius estimate of the plain iteration
+    T m_relaxation = 1; // fraction of the accelerated step that is taken
+    T m_maxDisplacement = 0; // per node and iteration, 0 for no limit
+    T m_restartGrowth = 2;
+    T m_tolerance = T(1e-3); // converged once no node moves more than this many length scales
+    T m_lengthScale = 1; // tet size, set by PDTetSolver::initializeDeformer
+    int m_maxIterations = 4; // per solve() call, which returns early once converged; soft collision pairs are found once per call
+    bool m_guardPositions = false; // reset NaN/Inf and runaway coordinates around every iteration; also on at telemetry level Stats
+
+private:
+    size_t m_size = 0;
+    int m_history = 0; // iterates seen since the last restart
+    int m_next = 0; // Anderson column overwritten next
+    double m_previousResidual = 0;
+    double m_omega = 1;
+    std::vector<T> m_previousF, m_previousG, m_previousX;
+    std::vector<std::vector<T>> m_dF, m_dG;
+    std::vector<double> m_gram, m_rhs, m_gamma;
+
+    static double dot(const T* a, const T* b, const size_t n) {
+        double result = 0;
+        for (size_t i = 0; i < n; i++)
+            result += double(a[i]) * double(b[i]);
+        return result;
+    }
+
+    // Solves the regularized normal equations of min |f - dF gamma| by Cholesky; false if they aren't SPD.
+    bool andersonCoefficients(const T* f, const int m) {
+        m_gram.assign(m * m, 0);
+        m_rhs.assign(m, 0);
+        m_gamma.assign(m, 0);
+        double trace = 0;
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j <= i; j++)
+                m_gram[i * m + j] = dot(m_dF[i].data(), m_dF[j].data(), m_size);
+            m_rhs[i] = dot(m_dF[i].data(), f, m_size);
+            trace += m_gram[i * m + i];
+        }
+        for (int i = 0; i < m; i++)
+            m_gram[i * m + i] += 1e-10 * trace;
+        for (int j = 0; j < m; j++) {
+            double pivot = m_gram[j * m + j];
+            for (int k = 0; k < j; k++)
+                pivot -= m_gram[j * m + k] * m_gram[j * m + k];
+            if (!(pivot > 0))
+                return false;
+            m_gram[j * m + j] = std::sqrt(pivot);
+            for (int i = j + 1; i < m; i++) {
+                double sum = m_gram[i * m + j];
+                for (int k = 0; k < j; k++)
+                    sum -= m_gram[i * m + k] * m_gram[j * m + k];
+                m_gram[i * m + j] = sum / m_gram[j * m + j];
+            }
+        }
+        for (int i = 0; i < m; i++) {
+            double sum = m_rhs[i];
+            for (int k = 0; k < i; k++)
+                sum -= m_gram[i * m + k] * m_gamma[k];
+            m_gamma[i] = sum / m_gram[i * m + i];
+        }
+        for (int i = m - 1; i >= 0; i--) {
+            double sum = m_gamma[i];
+            for (int k = i + 1; k < m; k++)
+                sum -= m_gram[k * m + i] * m_gamma[k];
+            m_gamma[i] = sum / m_gram[i * m + i];
+        }
+        for (int i = 0; i < m; i++)
+            if (!std::isfinite(m_gamma[i]))
+                return false;
+        return true;
+    }
+
+public:
+    void restart() {
+        m_history = 0;
+        m_next = 0;
+        m_previousResidual = 0;
+        m_omega = 1;
+    }
+
+    // x holds n nodes of the current iterate and dx their plain update. x is overwritten with the next
+    // iterate and dx with the step actually taken. Returns whether the plain update is within tolerance.
+    bool step(T* x, T* dx, const size_t n) {
+        const size_t size = n * d;
+        if (size != m_size) {
+            m_size = size;
+            restart();
+        }
+
+        T maxResidual = 0;
+        for (size_t i = 0; i < n; i++) {
+            T squared = 0;
+            for (int v = 0; v < d; v++)
+                squared += dx[i * d + v] * dx[i * d + v];
+            maxResidual = std::max(maxResidual, std::sqrt(squared));
+        }
+        const double residual = std::sqrt(dot(dx, dx, size));
+        if (!std::isfinite(residual) || (m_history && residual > m_restartGrowth * m_previousResidual))
+            restart();
+        m_previousResidual = residual;
+
+        if (m_acceleration == IterationAcceleration::Anderson && std::isfinite(residual)) {
+            const size_t depth = size_t(std::max(1, m_andersonDepth));
+            if (m_dF.size() != depth || m_previousF.size() != size) {
+                m_dF.assign(depth, std::vector<T>(size));
+                m_dG.assign(depth, std::vector<T>(size));
+                m_previousF.resize(size);
+                m_previousG.resize(size);
+                m_history = 0;
+                m_next = 0;
+            }
+            int columns = 0;
+            if (m_history) {
+                for (size_t i = 0; i < size; i++) {
+                    m_dF[m_next][i] = dx[i] - m_previousF[i];
+                    m_dG[m_next][i] = x[i] + dx[i] - m_previousG[i];
+                }
+                m_next = (m_next + 1) % int(depth);
+                columns = std::min(m_history, int(depth));
+            }
+            for (size_t i = 0; i < size; i++) {
+                m_previousF[i] = dx[i];
+                m_previousG[i] = x[i] + dx[i];
+            }
+            if (columns && !andersonCoefficients(dx, columns))
+                columns = 0;
+            for (size_t i = 0; i < size; i++) {
+                T g = x[i] + dx[i];
+                for (int j = 0; j < columns; j++)
+                    g -= T(m_gamma[j]) * m_dG[j][i];
+                dx[i] = m_relaxation * (g - x[i]);
+            }
+            m_history++;
+        }
+        else if (m_acceleration == IterationAcceleration::Chebyshev && std::isfinite(residual)) {
+            // x_{k+1} = omega_{k+1} (g(x_k) - x_{k-1}) + x_{k-1}
+            const double rho2 = double(m_chebyshevRho) * m_chebyshevRho;
+            m_omega = m_history == 0 ? 1 : m_history == 1 ? 2 / (2 - rho2) : 4 / (4 - rho2 * m_omega);
+            m_previousX.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                const T previous = m_history ? m_previousX[i] : x[i];
+                const T next = previous + T(m_omega) * (x[i] + dx[i] - previous);
+                m_previousX[i] = x[i];
+                dx[i] = m_relaxation * (next - x[i]);
+            }
+            m_history++;
+        }
+        else
+            for (size_t i = 0; i < size; i++)
+                dx[i] *= m_relaxation;
+
+        if (m_maxDisplacement > 0)
+            for (size_t i = 0; i < n; i++) {
+                T squared = 0;
+                for (int v = 0; v < d; v++)
+                    squared += dx[i * d + v] * dx[i * d + v];
+                if (squared > m_maxDisplacement * m_maxDisplacement)
+                    for (int v = 0; v < d; v++)
+                        dx[i * d + v] *= m_maxDisplacement / std::sqrt(squared);
+            }
+
+        for (size_t i = 0; i < size; i++)
+            x[i] += dx[i];
+        return maxResidual <= m_tolerance * m_lengthScale;
+    }
+};
+
+} // namespace PhysBAM
@@ -0,0 +1,123 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+enum class OrderingMatch { None, Exact, Grown };
+
+// Fill-reducing orderings of the CSR patterns PardisoWrapper has analyzed, keyed on a hash of rowIndex/column.
+// Constraint edits and many surgical actions rebuild the solver without changing the node graph, so the
+// ordering (the expensive part of symbolic analysis) is looked up here before it is recomputed.
+//
+// An ordering is stored as order[k] = row eliminated k-th. A pattern that only gained entries, and possibly
+// a few rows at the end, is warm started from the ordering of the one it grew from with the new rows
+// eliminated last; after maxWarmStarts such steps in a row the ordering is computed afresh.
+template <class IntType> class OrderingCache {
+    struct Entry {
+        std::uint64_t m_hash;
+        std::vector<IntType> m_rowIndex;
+        std::vector<IntType> m_column;
+        std::vector<IntType> m_order;
+        int m_warmStarts;
+        std::uint64_t m_lastUse;
+    };
+
+    static constexpr size_t capacity = 4;
+    static constexpr int maxWarmStarts = 4;
+
+    std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::uint64_t m_clock = 0;
+
+    static bool contains(const Entry& entry, const IntType* rowIndex, const IntType* column) {
+        // rows are sorted, so each old row must be a subsequence of the new one
+        const IntType oldN = (IntType)entry.m_rowIndex.size() - 1;
+        for (IntType i = 0; i < oldN; i++) {
+            IntType k = rowIndex[i];
+            for (IntType l = entry.m_rowIndex[i]; l < entry.m_rowIndex[i + 1]; l++) {
+                while (k < rowIndex[i + 1] && column[k] < entry.m_column[l])
+                    k++;
+                if (k == rowIndex[i + 1] || column[k] != entry.m_column[l])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    static OrderingCache& instance() {
+        static OrderingCache cache;
+        return cache;
+    }
+
+    static std::uint64_t hash(const IntType n, const IntType* rowIndex, const IntType* column) {
+        std::uint64_t h = 1469598103934665603ull; // FNV-1a
+        auto mix = [&h](const IntType* data, const IntType count) {
+            for (IntType i = 0; i < count; i++) {
+                h ^= (std::uint64_t)data[i];
+                h *= 1099511628211ull;
+            }
+        };
+        mix(rowIndex, n + 1);
+        mix(column, rowIndex[n]);
+        return h;
+    }
+
+    // Fills order and returns how it was found; order is left alone on None. warmStarts is what to hand
+    // to store() along with the ordering the analysis ends up using.
+    OrderingMatch lookup(const IntType n, const IntType* rowIndex, const IntType* column, std::vector<IntType>& order, int& warmStarts) {
+        warmStarts = 0;
+        const std::uint64_t h = hash(n, rowIndex, column);
+        const IntType nnz = rowIndex[n];
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& entry : m_entries)
+            if (entry.m_hash == h && entry.m_rowIndex.size() == size_t(n + 1)
+                && std::equal(rowIndex, rowIndex + n + 1, entry.m_rowIndex.begin())
+                && std::equal(column, column + nnz, entry.m_column.begin())) {
+                entry.m_lastUse = ++m_clock;
+                order = entry.m_order;
+                warmStarts = entry.m_warmStarts;
+                return OrderingMatch::Exact;
+            }
+
+        Entry* base = nullptr;
+        for (auto& entry : m_entries) {
+            const IntType oldN = (IntType)entry.m_rowIndex.size() - 1;
+            const IntType oldNnz = (IntType)entry.m_column.size();
+            if (entry.m_warmStarts >= maxWarmStarts || oldN > n || (n - oldN) * 16 > n || nnz < oldNnz || (nnz - oldNnz) * 8 > oldNnz)
+                continue;
+            if ((!base || oldNnz > (IntType)base->m_column.size()) && contains(entry, rowIndex, column))
+                base = &entry;
+        }
+        if (!base)
+            return OrderingMatch::None;
+        base->m_lastUse = ++m_clock;
+        order = base->m_order;
+        warmStarts = base->m_warmStarts + 1;
+        for (IntType i = (IntType)base->m_order.size(); i < n; i++)
+            order.push_back(i);
+        return OrderingMatch::Grown;
+    }
+
+    void store(const IntType n, const IntType* rowIndex, const IntType* column, const std::vector<IntType>& order, const int warmStarts) {
+        const std::uint64_t h = hash(n, rowIndex, column);
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_entries.size() == capacity)
+            m_entries.erase(std::min_element(m_entries.begin(), m_entries.end(),
+                [](const Entry& a, const Entry& b) { return a.m_lastUse < b.m_lastUse; }));
+        m_entries.push_back({ h, std::vector<IntType>(rowIndex, rowIndex + n + 1), std::vector<IntType>(column, column + rowIndex[n]), order, warmStarts, ++m_clock });
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+};
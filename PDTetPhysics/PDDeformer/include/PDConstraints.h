@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
@@ -34,4 +35,72 @@ namespace PhysBAM {
         std::array<typename VectorType::ELEMENT, VectorType::dimension> m_macroWeights;
         int m_microNodeNumber;
     };
+
+    // Every hook, suture and micro-node tensor is k * w * w^T. tensorVector() writes the nodes and weights of w
+    // (at most 2 * elementNodeNum of them) and returns their count.
+    template <class VectorType, int elementNodeNum, class IndexType>
+    inline int tensorVector(const SoftConstraint<VectorType, elementNodeNum, IndexType>& c, IndexType* nodes, typename VectorType::ELEMENT* weights) {
+        for (int i = 0; i < elementNodeNum; i++) {
+            nodes[i] = c.m_elementIndex[i];
+            weights[i] = c.m_weights[i];
+        }
+        return elementNodeNum;
+    }
+
+    template <class VectorType, int elementNodeNum, class IndexType>
+    inline int tensorVector(const SutureConstraint<VectorType, elementNodeNum, IndexType>& c, IndexType* nodes, typename VectorType::ELEMENT* weights) {
+        for (int i = 0; i < elementNodeNum; i++) {
+            nodes[i] = c.m_elementIndex1[i];
+            nodes[i + elementNodeNum] = c.m_elementIndex2[i];
+            weights[i] = c.m_weights1[i];
+            weights[i + elementNodeNum] = -c.m_weights2[i];
+        }
+        return elementNodeNum * 2;
+    }
+
+    template <class VectorType, class IndexType>
+    inline int tensorVector(const NodeToNodesConstraint<VectorType, IndexType>& c, IndexType* nodes, typename VectorType::ELEMENT* weights) {
+        constexpr int d = VectorType::dimension;
+        for (int i = 0; i < d; i++) {
+            nodes[i] = c.m_macroNodes[i];
+            weights[i] = c.m_macroWeights[i];
+        }
+        nodes[d] = c.m_microNodeNumber;
+        weights[d] = -1;
+        return d + 1;
+    }
+
+    // Two constraints contribute the same tensor if they couple the same nodes with the same weights and stiffness.
+    template <class VectorType, int elementNodeNum, class IndexType>
+    inline bool sameTensor(const SoftConstraint<VectorType, elementNodeNum, IndexType>& a, const SoftConstraint<VectorType, elementNodeNum, IndexType>& b) {
+        return a.m_stiffness == b.m_stiffness && a.m_elementIndex == b.m_elementIndex && a.m_weights == b.m_weights;
+    }
+
+    template <class VectorType, int elementNodeNum, class IndexType>
+    inline bool sameTensor(const SutureConstraint<VectorType, elementNodeNum, IndexType>& a, const SutureConstraint<VectorType, elementNodeNum, IndexType>& b) {
+        return a.m_stiffness == b.m_stiffness && a.m_elementIndex1 == b.m_elementIndex1 && a.m_elementIndex2 == b.m_elementIndex2
+            && a.m_weights1 == b.m_weights1 && a.m_weights2 == b.m_weights2;
+    }
+
+    template <class VectorType, class IndexType>
+    inline bool sameTensor(const NodeToNodesConstraint<VectorType, IndexType>& a, const NodeToNodesConstraint<VectorType, IndexType>& b) {
+        return a.m_stiffness == b.m_stiffness && a.m_microNodeNumber == b.m_microNodeNumber && a.m_macroNodes == b.m_macroNodes
+            && a.m_macroWeights == b.m_macroWeights;
+    }
+
+    // Calls visit(constraint, sign) for each slot whose tensor differs between the factored and the current list,
+    // with sign -1 for the factored constraint and +1 for the current one. Hooks and sutures keep their slots
+    // (dead ones are zeroed until compaction), so this is the set of edits since the factorization.
+    template <class ConstraintType, class Visitor>
+    inline void diffConstraintTensors(const std::vector<ConstraintType>& current, const std::vector<ConstraintType>& factored, Visitor&& visit) {
+        for (size_t c = 0; c < std::max(current.size(), factored.size()); c++) {
+            const bool before = c < factored.size(), after = c < current.size();
+            if (before && after && sameTensor(factored[c], current[c]))
+                continue;
+            if (before)
+                visit(factored[c], -1);
+            if (after)
+                visit(current[c], 1);
+        }
+    }
 }
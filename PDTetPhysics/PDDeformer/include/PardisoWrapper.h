@@ -4,6 +4,9 @@
 //#####################################################################
 #pragma once
 #include <iostream>
+#include <vector>
+
+#include "SparseSPDSolver.h"
 
 
 template <class T, class IntType_> struct PardisoWrapper {
@@ -41,6 +44,20 @@ template <class T, class IntType_> struct PardisoWrapper {
     IntType iparm[64]{}; // Pardiso control parameters.
     IntType maxfct=0, mnum=0, msglvl=0;
 
+    // Taken from defaultSparseSPDBackend() in initialize(). For anything but Pardiso the phases below are
+    // forwarded to sparseSolver, which is created by the first symbolicFact() and kept until releasePardisoInternal().
+    SparseSPDBackend backend = SparseSPDBackend::Pardiso;
+    SparseSPDSolver<T, IntType> *sparseSolver = nullptr;
+
+    // With a Schur block and sparseSolver, only the leading n - m rows (K11) are factored and numericFact() forms
+    // schur = K22 - K12^T K11^{-1} K12 from interior solves against the columns of K12, as CollisionSchurSolver does.
+    // forwardSubstitution() then leaves K11^{-1} b1 and b2 - K12^T K11^{-1} b1, and backwardSubstitution() takes the
+    // Schur solution back to the interior, so chaining them around a Schur solve gives what Pardiso's phases give.
+    // The slots index value, so a refactorization only gathers again.
+    std::vector<IntType> interiorRowIndex, interiorColumn, interiorSlots;
+    std::vector<IntType> couplingRowIndex, couplingColumn, couplingSlots; // K12 by interior row, columns counted from n - m
+    std::vector<T> interiorValue, interiorRhs, interiorX;
+
     void initialize(const IntType _n, const IntType _nnz, const IntType _m = 0);
 
     void  factSchur();
@@ -56,9 +73,14 @@ template <class T, class IntType_> struct PardisoWrapper {
     void releasePardisoInternal();
     void deallocate();
 
-    void forwardSubstitution(T* const _rhs, T* const _x);
-    void diagSolve(T* const _rhs, T* const _x);
-    void backwardSubstitution(T* const _rhs, T* const _x);
+    // _rhs and _x hold _nrhs right hand sides of length n, one after the other
+    void forwardSubstitution(T* const _rhs, T* const _x, const IntType _nrhs = 1);
+    void diagSolve(T* const _rhs, T* const _x, const IntType _nrhs = 1);
+    void backwardSubstitution(T* const _rhs, T* const _x, const IntType _nrhs = 1);
+
+    void splitSchurPattern();
+    void sparseSchurComplement();
+    void interiorSolve(const IntType _nrhs);
 
     void printSchur () {
         std::cout<<std::endl;
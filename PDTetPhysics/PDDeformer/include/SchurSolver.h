@@ -10,11 +10,13 @@
 #include <mkl.h>
 #endif
 #include <array>
+#include <cmath>
 
 #include "MKLWrapper.h"
 #include "PardisoWrapper.h"
 #include "SimulationFlags.h"
 #include "PDConstraints.h"
+#include "Telemetry.h"
 // #include "CudaWrapper.h"
 
 #include "Discretization.h"
@@ -49,10 +51,48 @@ template <class Discretization, class IntType> struct SchurSolver {
     using CollisionSuture = SlidingConstraint <VectorType, elementNodes, IndexType>;
     using InternodeConstraint = NodeToNodesConstraint<VectorType, IndexType>; 
 
+    // CSR slot each (i,j) entry of a constraint tensor scatters into; -1 where the entry is dropped
+    // (inactive node or lower triangle). Cached per constraint so refactorization is a direct indexed add.
+    template <int elementNodesN> struct ScatterSlots {
+        std::array<IndexType, elementNodesN> m_elementIndex;
+        std::array<IntType, elementNodesN * elementNodesN> m_slot;
+    };
+
 
     IntType schurSize = IntType(0);
     NumberingArrayType m_numbering; // only number the active nodes, collisionNodes at the bottom
-    std::vector<std::map<int, T>> m_tensor;
+    // Upper triangle entries of the element and constraint tensors, duplicates not yet summed. One bucket per
+    // contiguous range of elements, filled in parallel, then one for sutures and micro nodes; initializePardiso
+    // merges them into the CSR matrix and releases them.
+    struct TensorEntry {
+        IntType m_row;
+        IntType m_col;
+        T m_value;
+    };
+    IntType m_tensorRows = IntType(0);
+    std::vector<std::vector<TensorEntry>> m_tensor;
+    std::vector<T> m_baseValue; // constraint-free values of the CSR matrix, copied into m_pardiso.value on refactorization
+    std::vector<ScatterSlots<elementNodes>> m_constraintSlots;
+    std::vector<ScatterSlots<elementNodes>> m_fakeSutureSlots;
+    std::vector<ScatterSlots<elementNodes * 2>> m_sutureSlots;
+    std::vector<ScatterSlots<d + 1>> m_microNodeSlots;
+
+    // Hook/suture edits made since the last numeric factorization, A' = A + sum_j c_j u_j u_j^T,
+    // applied in solve() through the Woodbury identity. Past m_lowRankBudget terms we refactorize.
+    struct LowRankTerm {
+        std::vector<IntType> m_rows;
+        std::vector<T> m_u;
+        T m_coefficient;
+        std::vector<T> m_z; // A^{-1} u
+    };
+    int m_lowRankBudget = 16;
+    std::vector<LowRankTerm> m_lowRankTerms;
+    MATRIX_MXN<double> m_capacitanceL, m_capacitanceU; // PLU factors of C^{-1} + U^T A^{-1} U
+    VECTOR_ND<int> m_capacitancePermutation;
+    std::vector<Constraint> m_factoredConstraints; // constraint state baked into the numeric factor
+    std::vector<Constraint> m_factoredFakeSutures;
+    std::vector<Suture> m_factoredSutures;
+    std::vector<InternodeConstraint> m_factoredMicroNodes;
     T *m_originalValue = nullptr;
     T *m_schur = nullptr;
     T *m_x = nullptr;
@@ -61,12 +101,15 @@ template <class Discretization, class IntType> struct SchurSolver {
 
     void initialize(const NodeArrayType& nodeType);
 
-    template <int elementNodesN>
-    void accumToTensor(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix,
-        const std::array<IndexType, elementNodesN>& elementIndex);
+    template <int elementNodesN, class MatrixType>
+    void accumToTensor(const MatrixType& stiffnessMatrix,
+        const std::array<IndexType, elementNodesN>& elementIndex, std::vector<TensorEntry>& bucket) const;
 
-    template <int elementNodesN>
-    void accumToTensor_debug(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex);  // COURT added to separate out microNode crash in Release
+    // constant(e) scales the tensor of element e
+    template <class ElementConstant>
+    void accumElementTensors(const std::vector<ElementType>& elements, const std::vector<GradientMatrixType>& gradients, const ElementConstant& constant);
+
+    void accumConstraintTensors(const std::vector<Suture>& sutures, const std::vector<InternodeConstraint>& microNodes);
 
     template <int elementNodesN>
     void updateTensor(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix,
@@ -95,18 +138,22 @@ template <class Discretization, class IntType> struct SchurSolver {
     );
 #endif
 
-    inline void reInitializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes) {
-        factPardiso(constraints, sutures, fakeSutures, microNodes);  
-        if (schurSize) {
-            for (IntType i = 0; i < schurSize * schurSize; i++)
-                m_originalValue[i] = m_pardiso.schur[i];
-            m_pardiso.factSchur();
-        }
-    }
+    void reInitializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes);
+
+    inline void setLowRankBudget(const int rank) { m_lowRankBudget = rank; }
+
+    bool updateLowRank(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes);
+
+    void applyLowRankCorrection(T* const x) const;
+
+    IntType findSlot(const IntType row, const IntType col) const;
 
     template <int elementNodesN>
-    void accumToPardiso(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix,
-        const std::array<IndexType, elementNodesN>& elementIndex);
+    const ScatterSlots<elementNodesN>& scatterSlots(std::vector<ScatterSlots<elementNodesN>>& cache, const size_t c,
+        const std::array<IndexType, elementNodesN>& elementIndex) const;
+
+    template <int elementNodesN>
+    void scatterToPardiso(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const ScatterSlots<elementNodesN>& slots);
 
 #if 0
     void initializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures);
@@ -114,18 +161,11 @@ template <class Discretization, class IntType> struct SchurSolver {
 
     void copyIn(const StateVariableType &f, const int v) const {
         // copy in x
-        int copiedCount = 0;
-        int skippedCount = 0;
         for (Iterator<StateVariableType> iterator(f); !iterator.isEnd(); iterator.next()) {
             const int number = iterator.value(m_numbering);
-            if (number >= 0) {
+            if (number >= 0)
                 m_rhs[number] = iterator.value(f)(v + 1);
-                copiedCount++;
-            } else {
-                skippedCount++;
-            }
         }
-        std::cout << "DEBUG: copyIn - copied " << copiedCount << " values, skipped " << skippedCount << " inactive nodes" << std::endl;
     }
 
     void copyOut(StateVariableType &f, const int v) const {
@@ -137,39 +177,55 @@ template <class Discretization, class IntType> struct SchurSolver {
         }
     }
 
-    void solve() const {
+    // all d coordinates at once, coordinate v in m_rhs[v * n, (v + 1) * n), for solve(d)
+    void copyIn(const StateVariableType &f) const {
+        const IntType n = m_pardiso.n;
+        for (Iterator<StateVariableType> iterator(f); !iterator.isEnd(); iterator.next()) {
+            const int number = iterator.value(m_numbering);
+            if (number >= 0)
+                for (int v = 0; v < d; v++)
+                    m_rhs[v * n + number] = iterator.value(f)(v + 1);
+        }
+    }
+
+    void copyOut(StateVariableType &f) const {
+        const IntType n = m_pardiso.n;
+        for (Iterator<StateVariableType> iterator(f); !iterator.isEnd(); iterator.next()) {
+            const int number = iterator.value(m_numbering);
+            if (number >= 0)
+                for (int v = 0; v < d; v++)
+                    iterator.value(f)(v + 1) = m_x[v * n + number];
+        }
+    }
+
+    // Solves for the first nrhs (at most d) right hand sides in m_rhs with a single sweep over the factor.
+    void solve(const int nrhs = 1) const {
 #if TIMING
         auto start1 = std::chrono::steady_clock::now();
 #endif
-        // Debug: Check RHS
-        T rhsNorm = 0;
-        for (int i = 0; i < m_pardiso.n; ++i) {
-            rhsNorm += m_rhs[i] * m_rhs[i];
-        }
-        rhsNorm = std::sqrt(rhsNorm);
-        std::cout << "DEBUG: SchurSolver - RHS norm = " << rhsNorm << std::endl;
-        
-        m_pardiso.forwardSubstitution(m_rhs, m_x);
+        if (PDTET_TELEMETRY_ON(Verbose))
+            std::cout << "SchurSolver: rhs norm = " << norm(m_rhs, nrhs) << std::endl;
+
+        m_pardiso.forwardSubstitution(m_rhs, m_x, nrhs);
 #if TIMING
          auto end1 = std::chrono::steady_clock::now();
          std::chrono::duration<double> elapsed_seconds1 = end1 - start1;
          std::cout<<"Forward Substitution Time: "<<elapsed_seconds1.count()<<" s"<<std::endl;
 #endif
 
-        m_pardiso.diagSolve(m_x, m_rhs);
+        m_pardiso.diagSolve(m_x, m_rhs, nrhs);
 
 #if TIMING
         auto start2 = std::chrono::steady_clock::now();
 #endif
-        m_pardiso.backwardSubstitution(m_rhs, m_x);
+        m_pardiso.backwardSubstitution(m_rhs, m_x, nrhs);
 
-        // Debug: Check solution
-        T solNorm = 0;
-        for (int i = 0; i < m_pardiso.n; ++i) {
-            solNorm += m_x[i] * m_x[i];
-        }
-        solNorm = std::sqrt(solNorm);
-        std::cout << "DEBUG: SchurSolver - Solution norm = " << solNorm << std::endl;
+        if (m_lowRankTerms.size())
+            for (int c = 0; c < nrhs; c++)
+                applyLowRankCorrection(m_x + c * m_pardiso.n);
+
+        if (PDTET_TELEMETRY_ON(Verbose))
+            std::cout << "SchurSolver: solution norm = " << norm(m_x, nrhs) << std::endl;
 
 #if TIMING
          auto end2 = std::chrono::steady_clock::now();
@@ -178,6 +234,13 @@ template <class Discretization, class IntType> struct SchurSolver {
 #endif
     }
 
+    T norm(const T* const x, const int nrhs) const {
+        T sum = 0;
+        for (IntType i = 0; i < m_pardiso.n * nrhs; i++)
+            sum += x[i] * x[i];
+        return std::sqrt(sum);
+    }
+
     void inline releasePardiso() {
         m_pardiso.releasePardisoInternal();
         m_pardiso.deallocate();
@@ -0,0 +1,46 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+#pragma once
+
+// Direct solvers PardisoWrapper can hand its symmetric positive definite system to instead of Pardiso.
+// Which one is used is chosen at runtime. With a Schur block PardisoWrapper factors only the interior rows with
+// them and forms the Schur complement itself, the part Pardiso does in its own factorization.
+enum class SparseSPDBackend { Pardiso, Cholmod, EigenLDLT };
+
+// The matrix is the upper triangle in 0-based CSR, the layout PardisoWrapper keeps. Read as CSC that is the
+// lower triangle, so backends take the arrays as they are. analyze() looks at the pattern only and is done
+// once per pattern; factorize() can then be repeated with new values in the same slots. It computes its own
+// fill-reducing ordering unless one is given as order[k] = row eliminated k-th; ordering() reports the one
+// the analysis ended up with, in the same form.
+//
+// With A = P^T L D L^T P the solve is split the way Pardiso phases 331, 332 and 333 split it. rhs and x
+// hold nrhs columns of length n, one after the other, and must not overlap.
+template <class T, class IntType> struct SparseSPDSolver {
+    virtual ~SparseSPDSolver() = default;
+
+    virtual bool analyze(const IntType n, const IntType* rowIndex, const IntType* column, const IntType* order = nullptr) = 0;
+    virtual void ordering(IntType* order) const = 0;
+    virtual bool factorize(const T* value) = 0;
+
+    virtual bool forwardSubstitution(const T* rhs, T* x, const IntType nrhs) = 0; // x = L^{-1} P rhs
+    virtual bool diagSolve(const T* rhs, T* x, const IntType nrhs) = 0; // x = D^{-1} rhs
+    virtual bool backwardSubstitution(const T* rhs, T* x, const IntType nrhs) = 0; // x = P^T L^{-T} rhs
+};
+
+const char* sparseSPDBackendName(const SparseSPDBackend backend);
+
+// Whether the backend was compiled in (USE_CHOLMOD, USE_EIGEN_SPARSE; Pardiso wherever MKL is used).
+bool sparseSPDBackendAvailable(const SparseSPDBackend backend);
+
+// Backend PardisoWrapper::initialize() picks up. Starts out as PDTET_SPARSE_SOLVER=pardiso|cholmod|eigen from
+// the environment if that one is available, otherwise as the best one compiled in.
+SparseSPDBackend defaultSparseSPDBackend();
+
+// Returns false and leaves the default alone if the backend isn't compiled in. Solvers that are already
+// initialized keep the backend they have.
+bool setDefaultSparseSPDBackend(const SparseSPDBackend backend);
+
+// nullptr for Pardiso, which PardisoWrapper drives itself, and for backends that aren't compiled in.
+template <class T, class IntType> SparseSPDSolver<T, IntType>* createSparseSPDSolver(const SparseSPDBackend backend);
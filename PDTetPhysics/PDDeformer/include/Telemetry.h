@@ -0,0 +1,97 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Highest telemetry level compiled in: 0 strips everything, 1 keeps the per-iteration stats record,
+// 2 also keeps the verbose console trace. What actually runs is chosen at runtime with
+// PhysBAM::Telemetry::setLevel(), up to this ceiling.
+#ifndef PDTET_TELEMETRY
+#define PDTET_TELEMETRY 0
+#endif
+
+// Use as `if (PDTET_TELEMETRY_ON(Stats)) { ... }`; with the level compiled out the branch folds away.
+#define PDTET_TELEMETRY_ON(level) \
+    (PDTET_TELEMETRY >= int(PhysBAM::Telemetry::Level::level) && PhysBAM::Telemetry::enabled(PhysBAM::Telemetry::Level::level))
+
+namespace PhysBAM {
+
+namespace Telemetry {
+    enum class Level { Off = 0, Stats = 1, Verbose = 2 };
+
+    inline std::atomic<int>& runtimeLevel() {
+        static std::atomic<int> level{ int(Level::Off) };
+        return level;
+    }
+
+    inline void setLevel(const Level level) { runtimeLevel().store(int(level), std::memory_order_relaxed); }
+
+    inline bool enabled(const Level level) { return runtimeLevel().load(std::memory_order_relaxed) >= int(level); }
+}
+
+// One record per PDTetSolver::solve() call.
+template <class T> struct SolveStats {
+    std::uint64_t m_iteration = 0;
+    int m_steps = 0; // local/global iterations the call ran
+    bool m_converged = false;
+    T m_forceNorm = 0; // of the right hand side handed to the last linear solve
+    T m_deltaNorm = 0; // of the last step taken
+    T m_maxDelta = 0;
+    T m_maxConstraintDisplacement = 0;
+    T m_maxConstraintForce = 0;
+    int m_constraintClamps = 0; // hook displacements or forces cut back by the safety limits
+    int m_clampedPositions = 0; // invalid node coordinates reset before or after the solve
+    int m_collisionStepsSkipped = 0; // collision inner steps dropped because the collision block would not factor
+    double m_seconds = 0;
+};
+
+// Running totals over PDTetSolver::initializeSolver(), a full factorization, and reInitializeSolver(), which updates the
+// constraint terms of the current one.  Written by the physics thread; read it while the solver is idle.
+struct FactorizationStats {
+    int m_factorizations = 0;
+    int m_reFactorizations = 0;
+    double m_factorSeconds = 0;
+    double m_reFactorSeconds = 0;
+};
+
+// Single producer, single consumer: the physics thread pushes, one reader (UI, logger) pops.
+// Neither side blocks; records pushed while the buffer is full are dropped and counted.
+template <class Record, std::size_t Capacity> class TelemetryRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    std::array<Record, Capacity> m_records;
+    std::atomic<std::size_t> m_head{ 0 }; // next slot to write, owned by the producer
+    std::atomic<std::size_t> m_tail{ 0 }; // next slot to read, owned by the consumer
+    std::atomic<std::size_t> m_dropped{ 0 };
+
+public:
+    bool push(const Record& record) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_records[head & (Capacity - 1)] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Record& record) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+        record = m_records[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+};
+
+} // namespace PhysBAM
@@ -1,5 +1,6 @@
 // #pragma once
 #include <Common/KernelCommon.h>
+#include "Add_Force.h"
 
 #ifdef FORCE_INLINE
 #include <Kernels/Matrix_Times_Matrix/Matrix_Times_Matrix.h>
@@ -37,7 +38,7 @@ void Add_Force(const T_DATA (&x_Blocked)[4][3],
     using WideVectorType = Vector3<WideNumberType>;
 
     using T = typename Tarch::Scalar;
-    T TWO[Tarch::Width]{};
+    alignas(sizeof(T_DATA)) T TWO[Tarch::Width]{};
     for (int i=0; i<Tarch::Width; i++) TWO[i] = 2;
 
     alignas(sizeof(T_DATA)) T_DATA  F_Blocked[d * d]{};
@@ -169,6 +170,25 @@ void Add_Force(const T_DATA (&x_Blocked)[4][3],
     v3.Store(f_Blocked[3]);
 }
 
+// Sweeps one BlockWidth-wide block with the given architecture; the ISA translation
+// units (Add_Force_AVX2.cpp, ...) include this file to build their own instance of it.
+template<class Tarch,class T,int BlockWidth>
+void Add_Force_Sweep(ADD_FORCE_BLOCK_ARGUMENTS(T, BlockWidth))
+{
+    static_assert(BlockWidth % Tarch::Width == 0, "Block width must be a multiple of the SIMD width");
+    for (int ee = 0; ee < BlockWidth; ee += Tarch::Width)
+        Add_Force<Tarch, T[BlockWidth]>(reinterpret_cast<const T(&)[4][3][BlockWidth]>(x_Blocked[0][0][ee]),
+                                        reinterpret_cast<const T(&)[9][BlockWidth]>(DmInverse_Blocked[0][ee]),
+                                        reinterpret_cast<const T(&)[BlockWidth]>(restVolume[ee]),
+                                        reinterpret_cast<const T(&)[BlockWidth]>(muLow[ee]),
+                                        reinterpret_cast<const T(&)[BlockWidth]>(muHigh[ee]),
+                                        reinterpret_cast<const T(&)[BlockWidth]>(strainMin[ee]),
+                                        reinterpret_cast<const T(&)[BlockWidth]>(strainMax[ee]),
+                                        reinterpret_cast<T(&)[4][3][BlockWidth]>(f_Blocked[0][0][ee]));
+}
+
+#ifndef ADD_FORCE_ISA_VARIANT
+
 #define INSTANCE_KERNEL_Add_Force(WIDTH,TYPE)               \
     const WIDETYPE(TYPE,WIDTH) (&x_Blocked)[4][3],          \
         const WIDETYPE(TYPE,WIDTH) (&DmInverse_Blocked)[9], \
@@ -179,10 +199,88 @@ void Add_Force(const T_DATA (&x_Blocked)[4][3],
         const WIDETYPE(TYPE,WIDTH) &strainMax,              \
         WIDETYPE(TYPE,WIDTH) (&f_Blocked)[4][3]
 
-INSTANCE_KERNEL_SIMD_AVX_FLOAT( Add_Force, 16)
-INSTANCE_KERNEL_SIMD_MIC_FLOAT( Add_Force, 16)
-#ifdef __APPLE__
-// Add Apple Silicon / scalar architecture instantiation
 INSTANCE_KERNEL_SCALAR_FLOAT( Add_Force, 16)
-#endif
 #undef INSTANCE_KERNEL_Add_Force
+
+template<>
+void Add_Force_Block<Add_Force_Architecture::Scalar, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16))
+{
+    Add_Force_Sweep<SIMD_Numeric_Kernel::SIMDArchitectureScalar<float>, float, 16>(x_Blocked, DmInverse_Blocked, restVolume,
+                                                                                    muLow, muHigh, strainMin, strainMax, f_Blocked);
+}
+
+#if defined(USE_AVX2_KERNELS) || defined(USE_AVX512_KERNELS)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// The OS has to save the wider register state too, not just the CPU advertise the ISA.
+bool cpuSupports(const Add_Force_Architecture arch)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return false;
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    if (arch == Add_Force_Architecture::AVX2)
+        return (info[1] & (1 << 5)) != 0;
+    if (arch == Add_Force_Architecture::AVX512)
+        return (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+    return false;
+#else
+    __builtin_cpu_init();
+    if (arch == Add_Force_Architecture::AVX2)
+        return __builtin_cpu_supports("avx2");
+    if (arch == Add_Force_Architecture::AVX512)
+        return __builtin_cpu_supports("avx512f");
+    return false;
+#endif
+}
+
+}
+#endif
+
+template<>
+Add_Force_Block_Type<float, 16> Select_Add_Force_Block<float, 16>(Add_Force_Architecture &selected)
+{
+#if defined(USE_AVX512_KERNELS)
+    if (cpuSupports(Add_Force_Architecture::AVX512)) {
+        selected = Add_Force_Architecture::AVX512;
+        return &Add_Force_Block<Add_Force_Architecture::AVX512, float, 16>;
+    }
+#endif
+#if defined(USE_AVX2_KERNELS)
+    if (cpuSupports(Add_Force_Architecture::AVX2)) {
+        selected = Add_Force_Architecture::AVX2;
+        return &Add_Force_Block<Add_Force_Architecture::AVX2, float, 16>;
+    }
+#endif
+#if defined(USE_NEON_KERNELS) && (defined(__aarch64__) || defined(_M_ARM64))
+    // Advanced SIMD is mandatory on AArch64, so no runtime query is needed.
+    selected = Add_Force_Architecture::NEON;
+    return &Add_Force_Block<Add_Force_Architecture::NEON, float, 16>;
+#else
+    selected = Add_Force_Architecture::Scalar;
+    return &Add_Force_Block<Add_Force_Architecture::Scalar, float, 16>;
+#endif
+}
+
+const char* Add_Force_Architecture_Name(const Add_Force_Architecture arch)
+{
+    switch (arch) {
+    case Add_Force_Architecture::AVX2: return "AVX2";
+    case Add_Force_Architecture::AVX512: return "AVX-512";
+    case Add_Force_Architecture::NEON: return "NEON";
+    default: return "scalar";
+    }
+}
+
+#endif
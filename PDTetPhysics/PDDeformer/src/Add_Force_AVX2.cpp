@@ -0,0 +1,12 @@
+// Built with the AVX2 target flags (see PDTetPhysics/CMakeLists.txt); only reached
+// through Select_Add_Force_Block once the running CPU is known to support it.
+#define ENABLE_AVX_INSTRUCTION_SET
+#define ADD_FORCE_ISA_VARIANT
+#include "Add_Force.cpp"
+
+template<>
+void Add_Force_Block<Add_Force_Architecture::AVX2, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16))
+{
+    Add_Force_Sweep<SIMD_Numeric_Kernel::SIMDArchitectureAVX2<float>, float, 16>(x_Blocked, DmInverse_Blocked, restVolume,
+                                                                            muLow, muHigh, strainMin, strainMax, f_Blocked);
+}
@@ -0,0 +1,15 @@
+// Advanced SIMD is part of the AArch64 base ISA, so this needs no extra target flags
+// (see PDTetPhysics/CMakeLists.txt).  Empty on anything else, e.g. the x86-64 slice
+// of a universal macOS build.
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ENABLE_NEON_INSTRUCTION_SET
+#define ADD_FORCE_ISA_VARIANT
+#include "Add_Force.cpp"
+
+template<>
+void Add_Force_Block<Add_Force_Architecture::NEON, float, 16>(ADD_FORCE_BLOCK_ARGUMENTS(float, 16))
+{
+    Add_Force_Sweep<SIMD_Numeric_Kernel::SIMDArchitectureNEON<float>, float, 16>(x_Blocked, DmInverse_Blocked, restVolume,
+                                                                            muLow, muHigh, strainMin, strainMax, f_Blocked);
+}
+#endif
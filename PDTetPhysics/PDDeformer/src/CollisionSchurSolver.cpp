@@ -0,0 +1,763 @@
+#include "CollisionSchurSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+    // Cyclic Jacobi for a small dense symmetric r x r matrix A (row major, destroyed): A = Q diag(lambda) Q^T,
+    // eigenvector t in column t of Q.
+    void symmetricEigen(std::vector<double>& A, const int r, std::vector<double>& Q, std::vector<double>& lambda)
+    {
+        Q.assign((size_t)r * r, 0.);
+        for (int i = 0; i < r; i++)
+            Q[(size_t)i * r + i] = 1.;
+        for (int sweep = 0; sweep < 50; sweep++) {
+            double off = 0, diagonal = 0;
+            for (int i = 0; i < r; i++) {
+                diagonal += A[(size_t)i * r + i] * A[(size_t)i * r + i];
+                for (int j = i + 1; j < r; j++)
+                    off += A[(size_t)i * r + j] * A[(size_t)i * r + j];
+            }
+            if (off <= 1e-30 * diagonal)
+                break;
+            for (int p = 0; p < r; p++)
+                for (int q = p + 1; q < r; q++) {
+                    const double apq = A[(size_t)p * r + q];
+                    if (apq == 0)
+                        continue;
+                    const double theta = (A[(size_t)q * r + q] - A[(size_t)p * r + p]) / (2 * apq);
+                    const double t = (theta >= 0 ? 1. : -1.) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                    const double c = 1 / std::sqrt(t * t + 1), s = t * c;
+                    // A = J^T A J, Q = Q J with J the rotation by (c, s) in the (p, q) plane
+                    for (int k = 0; k < r; k++) {
+                        const double akp = A[(size_t)k * r + p], akq = A[(size_t)k * r + q];
+                        A[(size_t)k * r + p] = c * akp - s * akq;
+                        A[(size_t)k * r + q] = s * akp + c * akq;
+                    }
+                    for (int k = 0; k < r; k++) {
+                        const double apk = A[(size_t)p * r + k], aqk = A[(size_t)q * r + k];
+                        A[(size_t)p * r + k] = c * apk - s * aqk;
+                        A[(size_t)q * r + k] = s * apk + c * aqk;
+                    }
+                    for (int k = 0; k < r; k++) {
+                        const double qkp = Q[(size_t)k * r + p], qkq = Q[(size_t)k * r + q];
+                        Q[(size_t)k * r + p] = c * qkp - s * qkq;
+                        Q[(size_t)k * r + q] = s * qkp + c * qkq;
+                    }
+                }
+        }
+        lambda.resize(r);
+        for (int i = 0; i < r; i++)
+            lambda[i] = A[(size_t)i * r + i];
+    }
+}
+
+namespace PhysBAM {
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::initialize(const NodeArrayType& nodeType)
+    {
+        using IteratorType = Iterator<NodeArrayType>;
+        IteratorType iterator(nodeType);
+        iterator.resize(m_schurNumbering);
+
+        // the interior solver only numbers Active nodes; collision nodes are held fixed while K11 is eliminated
+        NodeArrayType interiorNodeType(nodeType);
+        schurSize = 0;
+        for (iterator.begin(); !iterator.isEnd(); iterator.next())
+            if (iterator.value(nodeType) == NodeType::Collision) {
+                iterator.value(m_schurNumbering) = schurSize++;
+                iterator.value(interiorNodeType) = NodeType::Dirichlet;
+            }
+            else
+                iterator.value(m_schurNumbering) = -1;
+        LOG::cout << "    collision block = " << schurSize << std::endl;
+
+        m_interior.initialize(interiorNodeType);
+
+        m_elementCoupling.clear();
+        m_elementCoupling.resize(schurSize);
+        m_elementK22.assign((size_t)schurSize * schurSize, T(0));
+        m_A22.assign((size_t)schurSize * schurSize, T(0));
+        m_Sigma1.assign((size_t)schurSize * schurSize, T(0));
+        m_factor.assign((size_t)schurSize * schurSize, T(0));
+        m_factoredTerms.clear();
+        m_factorValid = false;
+        m_schurValid = false;
+        m_pendingVectors.clear();
+        m_pendingSigns.clear();
+
+        m_f2.assign((size_t)schurSize * d, T(0));
+        m_dx2.assign((size_t)schurSize * d, T(0));
+        m_x2.assign((size_t)schurSize * d, T(0));
+    }
+
+    template<class Discretization, class IntType>
+    template<int elementNodesN, class MatrixType>
+    void CollisionSchurSolver<Discretization, IntType>::accumToBlocks(const MatrixType& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex,
+        std::vector<std::map<int, T>>& coupling, std::vector<T>& K22) const
+    {
+        // stiffnessMatrix is negative definite; K12 keeps every interior row, K22 only its upper triangle
+        using IteratorType = Iterator<NodeArrayType>;
+        for (int j = 0; j < elementNodesN; j++) {
+            const int col = IteratorType::at(m_schurNumbering, elementIndex[j]);
+            if (col < 0)
+                continue;
+            for (int i = 0; i < elementNodesN; i++) {
+                const int row = IteratorType::at(m_interior.m_numbering, elementIndex[i]);
+                if (row >= 0)
+                    coupling[col][row] -= stiffnessMatrix(i + 1, j + 1);
+                const int schurRow = IteratorType::at(m_schurNumbering, elementIndex[i]);
+                if (schurRow >= 0 && schurRow <= col)
+                    K22[(size_t)schurRow * schurSize + col] -= stiffnessMatrix(i + 1, j + 1);
+            }
+        }
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::computeTensor(const std::vector<ElementType>& elements,
+        const std::vector<GradientMatrixType>& gradients,
+        const std::vector<T>& restVol,
+        const std::vector<T>& muLow,
+        const std::vector<T>& muHigh,
+        const std::vector<Suture>& sutures,
+        const std::vector<InternodeConstraint>& microNodes)
+    {
+        m_interior.computeTensor(elements, gradients, restVol, muLow, muHigh, sutures, microNodes);
+
+        using IteratorType = Iterator<NodeArrayType>;
+        for (int e = 0; e < elements.size(); e++) {
+            const auto& elementIndex = DiscretizationType::getElementIndex(elements[e]);
+            bool touchesCollision = false;
+            for (int v = 0; v < elementNodes; v++)
+                touchesCollision |= IteratorType::at(m_schurNumbering, elementIndex[v]) >= 0;
+            if (!touchesCollision)
+                continue;
+            typename DiscretizationType::ElementMatrixType stiffnessMatrix;
+            DiscretizationType::computeElementTensor(stiffnessMatrix, gradients[e], -2 * (muLow[e] + muHigh[e]) * restVol[e]);
+            accumToBlocks<elementNodes>(stiffnessMatrix, elementIndex, m_elementCoupling, m_elementK22);
+        }
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::computeE2Tensor(const std::vector<ElementType>& elements,
+        const std::vector<ElementFlag>& flags,
+        const std::vector<GradientMatrixType>& gradients,
+        const std::vector<T>& restVol,
+        const std::vector<T>& muLow,
+        const std::vector<T>& muHigh)
+    {
+        using IteratorType = Iterator<NodeArrayType>;
+        std::fill(m_A22.begin(), m_A22.end(), T(0));
+        for (int e = 0; e < elements.size(); e++)
+            if (flags[e] == ElementFlag::CollisionEl) {
+                typename DiscretizationType::ElementMatrixType stiffnessMatrix;
+                DiscretizationType::computeElementTensor(stiffnessMatrix, gradients[e], -2 * (muLow[e] + muHigh[e]) * restVol[e]);
+                const auto& elementIndex = DiscretizationType::getElementIndex(elements[e]);
+                for (int i = 0; i < elementNodes; i++) {
+                    const int row = IteratorType::at(m_schurNumbering, elementIndex[i]);
+                    if (row < 0)
+                        continue;
+                    for (int j = 0; j < elementNodes; j++) {
+                        const int col = IteratorType::at(m_schurNumbering, elementIndex[j]);
+                        if (col >= row)
+                            m_A22[(size_t)row * schurSize + col] -= stiffnessMatrix(i + 1, j + 1);
+                    }
+                }
+            }
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::initializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        m_interior.initializePardiso(constraints, sutures, fakeSutures, microNodes);
+        m_interiorX.assign((size_t)m_interior.m_pardiso.n * d, T(0));
+        std::vector<T> K22;
+        assembleCoupling(constraints, sutures, fakeSutures, microNodes, K22);
+        computeSchurComplement(K22);
+        m_schurConstraints = constraints;
+        m_schurFakeSutures = fakeSutures;
+        m_schurSutures = sutures;
+        m_schurMicroNodes = microNodes;
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::reInitializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        // the interior solver either takes the edits as its own low rank update or refactors; both leave solve() exact
+        m_interior.reInitializePardiso(constraints, sutures, fakeSutures, microNodes);
+        std::vector<T> K22;
+        assembleCoupling(constraints, sutures, fakeSutures, microNodes, K22);
+        if (!updateSchurComplement(constraints, sutures, fakeSutures, microNodes))
+            computeSchurComplement(K22);
+        m_schurConstraints = constraints;
+        m_schurFakeSutures = fakeSutures;
+        m_schurSutures = sutures;
+        m_schurMicroNodes = microNodes;
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::assembleCoupling(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes, std::vector<T>& K22)
+    {
+        const IntType m = schurSize;
+        std::vector<std::map<int, T>> coupling(m_elementCoupling);
+        K22 = m_elementK22;
+
+        for (const auto& c : constraints)
+            if (c.m_stiffness != 0) {
+                MATRIX_MXN<T> stiffnessMatrix;
+                DiscretizationType::computeConstraintTensor(stiffnessMatrix, c);
+                accumToBlocks<elementNodes>(stiffnessMatrix, c.m_elementIndex, coupling, K22);
+            }
+        for (const auto& c : fakeSutures)
+            if (c.m_stiffness != 0) {
+                MATRIX_MXN<T> stiffnessMatrix;
+                DiscretizationType::computeConstraintTensor(stiffnessMatrix, c);
+                accumToBlocks<elementNodes>(stiffnessMatrix, c.m_elementIndex, coupling, K22);
+            }
+        for (const auto& c : sutures)
+            if (c.m_stiffness != 0) {
+                MATRIX_MXN<T> stiffnessMatrix;
+                std::array<IndexType, elementNodes * 2> elementIndex;
+                DiscretizationType::computeSutureTensor(stiffnessMatrix, elementIndex, c);
+                accumToBlocks<elementNodes * 2>(stiffnessMatrix, elementIndex, coupling, K22);
+            }
+        for (const auto& c : microNodes)
+            if (c.m_stiffness != 0) {
+                MATRIX_MXN<T> stiffnessMatrix;
+                std::array<IndexType, d + 1> elementIndex;
+                DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, c);
+                accumToBlocks<d + 1>(stiffnessMatrix, elementIndex, coupling, K22);
+            }
+
+        m_couplingOffsets.resize(m + 1);
+        m_couplingRows.clear();
+        m_couplingValues.clear();
+        m_couplingOffsets[0] = 0;
+        for (IntType j = 0; j < m; j++) {
+            for (const auto& e : coupling[j])
+                if (e.second != 0) {
+                    m_couplingRows.push_back(e.first);
+                    m_couplingValues.push_back(e.second);
+                }
+            m_couplingOffsets[j + 1] = (IntType)m_couplingRows.size();
+        }
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::computeSchurComplement(std::vector<T>& K22)
+    {
+        const IntType m = schurSize;
+
+        // S = K22 - K12^T K11^{-1} K12, interior solves for the collision columns that couple to the interior,
+        // d columns per sweep over the factor
+        const IntType n1 = m_interior.m_pardiso.n;
+        m_Sigma1.swap(K22);
+        std::vector<IntType> columns;
+        for (IntType j = 0; j < m; j++)
+            if (m_couplingOffsets[j] != m_couplingOffsets[j + 1])
+                columns.push_back(j);
+        for (size_t first = 0; first < columns.size(); first += d) {
+            const int batch = (int)std::min(columns.size() - first, (size_t)d);
+            std::fill(m_interior.m_rhs, m_interior.m_rhs + (size_t)n1 * batch, T(0));
+            for (int c = 0; c < batch; c++) {
+                const IntType j = columns[first + c];
+                for (IntType k = m_couplingOffsets[j]; k < m_couplingOffsets[j + 1]; k++)
+                    m_interior.m_rhs[(size_t)c * n1 + m_couplingRows[k]] = m_couplingValues[k];
+            }
+            m_interior.solve(batch);
+            for (int c = 0; c < batch; c++) {
+                const IntType j = columns[first + c];
+                const T* const z = m_interior.m_x + (size_t)c * n1;
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+                for (IntType i = 0; i <= j; i++) {
+                    T sum = 0;
+                    for (IntType k = m_couplingOffsets[i]; k < m_couplingOffsets[i + 1]; k++)
+                        sum += m_couplingValues[k] * z[m_couplingRows[k]];
+                    m_Sigma1[(size_t)i * m + j] -= sum;
+                }
+            }
+        }
+
+        // keep only what is not re-projected every inner iteration
+        for (size_t i = 0; i < m_Sigma1.size(); i++)
+            m_Sigma1[i] -= m_A22[i];
+        m_schurValid = true;
+        m_pendingVectors.clear();
+        m_pendingSigns.clear();
+        m_factorValid = false;
+    }
+
+    template<class Discretization, class IntType>
+    bool CollisionSchurSolver<Discretization, IntType>::updateSchurComplement(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        // The edits since Sigma1 was condensed are K' = K + U C U^T, one column u = [u1; u2] per constraint removed
+        // (c = -k) or added (c = k). With Z = K11'^{-1} U1 from the already updated interior solver and
+        // V = U2 - K12'^T Z,
+        //     S' = S + V (C^{-1} - U1^T Z)^{-1} V^T
+        // which costs r interior solves and a rank r dense update instead of one solve per coupled column.
+        using IteratorType = Iterator<NodeArrayType>;
+        const IntType m = schurSize;
+        const IntType n1 = m_interior.m_pardiso.n;
+        const int budget = m_interior.m_lowRankBudget;
+        if (!m_schurValid || budget <= 0)
+            return false;
+
+        struct Column {
+            std::vector<IntType> m_interiorRows, m_schurRows;
+            std::vector<T> m_interiorU, m_schurU;
+            T m_coefficient;
+        };
+        std::vector<Column> columns;
+        bool overBudget = false;
+        auto addColumn = [&](const auto& c, const int sign) {
+            if (c.m_stiffness == 0 || overBudget)
+                return;
+            std::array<IndexType, elementNodes * 2> nodes;
+            std::array<T, elementNodes * 2> weights;
+            const int count = tensorVector(c, nodes.data(), weights.data());
+            Column column;
+            column.m_coefficient = sign * c.m_stiffness;
+            for (int i = 0; i < count; i++) {
+                const int row = IteratorType::at(m_interior.m_numbering, nodes[i]);
+                const int schurRow = IteratorType::at(m_schurNumbering, nodes[i]);
+                if (row >= 0) {
+                    column.m_interiorRows.push_back(row);
+                    column.m_interiorU.push_back(weights[i]);
+                }
+                else if (schurRow >= 0) {
+                    column.m_schurRows.push_back(schurRow);
+                    column.m_schurU.push_back(weights[i]);
+                }
+            }
+            if (column.m_interiorRows.empty() && column.m_schurRows.empty())
+                return; // only Dirichlet nodes, K11 and K22 don't see it
+            if ((int)columns.size() == budget) {
+                overBudget = true;
+                return;
+            }
+            columns.push_back(std::move(column));
+        };
+        diffConstraintTensors(constraints, m_schurConstraints, addColumn);
+        diffConstraintTensors(fakeSutures, m_schurFakeSutures, addColumn);
+        diffConstraintTensors(sutures, m_schurSutures, addColumn);
+        diffConstraintTensors(microNodes, m_schurMicroNodes, addColumn);
+        if (overBudget)
+            return false;
+        const int r = (int)columns.size();
+        if (!r)
+            return true;
+
+        // Z, d columns per sweep over the factor
+        std::vector<T> Z((size_t)r * n1);
+        for (int first = 0; first < r; first += d) {
+            const int batch = std::min(r - first, d);
+            std::fill(m_interior.m_rhs, m_interior.m_rhs + (size_t)n1 * batch, T(0));
+            for (int c = 0; c < batch; c++) {
+                const Column& column = columns[first + c];
+                for (size_t k = 0; k < column.m_interiorRows.size(); k++)
+                    m_interior.m_rhs[(size_t)c * n1 + column.m_interiorRows[k]] += column.m_interiorU[k];
+            }
+            m_interior.solve(batch);
+            std::copy(m_interior.m_x, m_interior.m_x + (size_t)n1 * batch, Z.begin() + (size_t)first * n1);
+        }
+
+        // capacitance C^{-1} - U1^T Z, symmetric up to rounding
+        std::vector<double> capacitance((size_t)r * r);
+        for (int i = 0; i < r; i++)
+            for (int j = 0; j < r; j++) {
+                double uz = 0;
+                const T* const z = Z.data() + (size_t)j * n1;
+                for (size_t k = 0; k < columns[i].m_interiorRows.size(); k++)
+                    uz += (double)columns[i].m_interiorU[k] * z[columns[i].m_interiorRows[k]];
+                capacitance[(size_t)i * r + j] = (i == j ? 1. / columns[i].m_coefficient : 0.) - uz;
+            }
+        for (int i = 0; i < r; i++)
+            for (int j = i + 1; j < r; j++)
+                capacitance[(size_t)i * r + j] = capacitance[(size_t)j * r + i] = (capacitance[(size_t)i * r + j] + capacitance[(size_t)j * r + i]) * .5;
+
+        // V = U2 - K12'^T Z
+        std::vector<T> V((size_t)r * m);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (IntType j = 0; j < m; j++)
+            for (int c = 0; c < r; c++) {
+                const T* const z = Z.data() + (size_t)c * n1;
+                T sum = 0;
+                for (IntType k = m_couplingOffsets[j]; k < m_couplingOffsets[j + 1]; k++)
+                    sum += m_couplingValues[k] * z[m_couplingRows[k]];
+                V[(size_t)c * m + j] = -sum;
+            }
+        for (int c = 0; c < r; c++)
+            for (size_t k = 0; k < columns[c].m_schurRows.size(); k++)
+                V[(size_t)c * m + columns[c].m_schurRows[k]] += columns[c].m_schurU[k];
+
+        // With the capacitance = Q diag(mu) Q^T the correction is sum_t (1 / mu_t) (V q_t) (V q_t)^T, which is also
+        // the form the collision block factor takes as a rank r update/downdate.
+        std::vector<double> Q, mu;
+        symmetricEigen(capacitance, r, Q, mu);
+        double muMax = 0;
+        for (int t = 0; t < r; t++)
+            muMax = std::max(muMax, std::abs(mu[t]));
+        for (int t = 0; t < r; t++)
+            if (!std::isfinite(mu[t]) || std::abs(mu[t]) <= 1e-12 * muMax)
+                return false;
+        std::vector<T> W((size_t)r * m, T(0)), coefficients(r);
+        for (int t = 0; t < r; t++) {
+            coefficients[t] = (T)(1. / mu[t]);
+            T* const w = W.data() + (size_t)t * m;
+            for (int s = 0; s < r; s++) {
+                const T q = (T)Q[(size_t)s * r + t];
+                const T* const v = V.data() + (size_t)s * m;
+                for (IntType i = 0; i < m; i++)
+                    w[i] += q * v[i];
+            }
+        }
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (IntType i = 0; i < m; i++)
+            for (int t = 0; t < r; t++) {
+                const T* const w = W.data() + (size_t)t * m;
+                const T wi = coefficients[t] * w[i];
+                if (wi == 0)
+                    continue;
+                T* const row = m_Sigma1.data() + (size_t)i * m;
+                for (IntType j = i; j < m; j++)
+                    row[j] += wi * w[j];
+            }
+
+        for (int t = 0; t < r; t++) {
+            const T scale = std::sqrt(std::abs(coefficients[t]));
+            for (IntType i = 0; i < m; i++)
+                m_pendingVectors.push_back(scale * W[(size_t)t * m + i]);
+            m_pendingSigns.push_back(coefficients[t] > 0 ? T(1) : T(-1));
+        }
+        return true;
+    }
+
+    template<class Discretization, class IntType>
+    bool CollisionSchurSolver<Discretization, IntType>::updateCollision(const std::vector<Constraint>& collisionConstraints, const std::vector<CollisionSuture>& collisionSutures)
+    {
+        using IteratorType = Iterator<NodeArrayType>;
+        const IntType m = schurSize;
+
+        std::vector<CollisionTerm> terms;
+        for (const auto& c : collisionConstraints)
+            if (c.m_stiffness != 0) {
+                CollisionTerm term;
+                term.m_rows.fill(IntType(-1));
+                term.m_weights.fill(T(0));
+                for (int v = 0; v < elementNodes; v++) {
+                    term.m_rows[v] = IteratorType::at(m_schurNumbering, c.m_elementIndex[v]);
+                    term.m_weights[v] = c.m_weights[v];
+                }
+                term.m_stiffness = c.m_stiffness;
+                terms.push_back(term);
+            }
+        for (const auto& c : collisionSutures)
+            if (c.m_stiffness != 0) {
+                CollisionTerm term;
+                for (int v = 0; v < elementNodes; v++) {
+                    term.m_rows[v] = IteratorType::at(m_schurNumbering, c.m_elementIndex1[v]);
+                    term.m_rows[v + elementNodes] = IteratorType::at(m_schurNumbering, c.m_elementIndex2[v]);
+                    term.m_weights[v] = c.m_weights1[v];
+                    term.m_weights[v + elementNodes] = -c.m_weights2[v];
+                }
+                term.m_stiffness = c.m_stiffness;
+                terms.push_back(term);
+            }
+
+        // the collision constraints are regenerated every inner step, so compare them as sets
+        std::sort(terms.begin(), terms.end());
+        if (m_factorValid && terms == m_factoredTerms && m_pendingSigns.empty())
+            return true;
+
+        if (m_factorValid) {
+            std::vector<CollisionTerm> added, removed;
+            std::set_difference(terms.begin(), terms.end(), m_factoredTerms.begin(), m_factoredTerms.end(), std::back_inserter(added));
+            std::set_difference(m_factoredTerms.begin(), m_factoredTerms.end(), terms.begin(), terms.end(), std::back_inserter(removed));
+            if (updateFactor(added, removed)) {
+                m_factoredTerms.swap(terms);
+                return true;
+            }
+        }
+
+        m_pendingVectors.clear(); // already in Sigma1
+        m_pendingSigns.clear();
+
+        // W has at most 2 * elementNodes nonzeros per row, so W^T D W is scattered rather than formed with syrk
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (IntType i = 0; i < m; i++)
+            for (IntType j = i; j < m; j++)
+                m_factor[(size_t)i * m + j] = m_Sigma1[(size_t)i * m + j] + m_A22[(size_t)i * m + j];
+
+        for (const auto& term : terms)
+            for (int a = 0; a < elementNodes * 2; a++) {
+                const IntType row = term.m_rows[a];
+                if (row < 0 || term.m_weights[a] == 0)
+                    continue;
+                for (int b = 0; b < elementNodes * 2; b++) {
+                    const IntType col = term.m_rows[b];
+                    if (col >= row)
+                        m_factor[(size_t)row * m + col] += term.m_stiffness * term.m_weights[a] * term.m_weights[b];
+                }
+            }
+
+        m_factoredTerms.swap(terms);
+        m_factorValid = factorCollisionBlock();
+        return m_factorValid;
+    }
+
+    template<class Discretization, class IntType>
+    bool CollisionSchurSolver<Discretization, IntType>::updateFactor(const std::vector<CollisionTerm>& added, const std::vector<CollisionTerm>& removed)
+    {
+        // Each collision term is k w w^T. Added terms and the positive Sigma1 corrections update the factor, removed
+        // terms and the negative corrections downdate it, updates first so the intermediate matrices stay as well
+        // conditioned as possible. The pending corrections are consumed either way: a refactor starts from Sigma1.
+        const IntType m = schurSize;
+        std::vector<T> pendingVectors, pendingSigns;
+        pendingVectors.swap(m_pendingVectors);
+        pendingSigns.swap(m_pendingSigns);
+        const int rank = (int)(added.size() + removed.size() + pendingSigns.size());
+        if (rank == 0)
+            return true;
+        // past this many rank 1 sweeps a blocked potrf is cheaper, and it also clears the accumulated rounding
+        if ((m_factorUpdates + rank) * maxUpdateRankDivisor > m)
+            return false;
+
+        std::vector<T> vectors((size_t)rank * m, T(0)), signs(rank);
+        int k = 0;
+        auto addVector = [&](const CollisionTerm& term, const T coefficient) {
+            const T scale = std::sqrt(std::abs(coefficient));
+            T* const x = vectors.data() + (size_t)k * m;
+            for (int a = 0; a < elementNodes * 2; a++)
+                if (term.m_rows[a] >= 0)
+                    x[term.m_rows[a]] += scale * term.m_weights[a];
+            signs[k++] = coefficient > 0 ? T(1) : T(-1);
+        };
+        auto addPending = [&](const T sign) {
+            for (size_t t = 0; t < pendingSigns.size(); t++)
+                if (pendingSigns[t] == sign) {
+                    std::copy(pendingVectors.begin() + t * m, pendingVectors.begin() + (t + 1) * m, vectors.begin() + (size_t)k * m);
+                    signs[k++] = sign;
+                }
+        };
+        for (const auto& term : added)
+            addVector(term, term.m_stiffness);
+        addPending(T(1));
+        addPending(T(-1));
+        for (const auto& term : removed)
+            addVector(term, -term.m_stiffness);
+
+        m_factorUpdates += rank;
+        return choleskyRankUpdate(vectors.data(), signs.data(), rank);
+    }
+
+    template<class Discretization, class IntType>
+    bool CollisionSchurSolver<Discretization, IntType>::choleskyRankUpdate(T* const vectors, const T* const signs, const int rank)
+    {
+        // m_factor = U with A = U^T U, U upper and row major. Replaces U by the factor of A + sum_t signs[t] x_t x_t^T,
+        // overwriting the vectors x_t. Column k of every rotation only depends on earlier columns, so all the vectors
+        // are swept through column k before moving on: their rotations are found in order from the diagonal, then
+        // applied to the rest of row k and of the vectors in parallel. Returns false if a downdate would leave the
+        // matrix (nearly) indefinite, with m_factor then only partially updated.
+        const IntType m = schurSize;
+        IntType first = m;
+        for (int t = 0; t < rank; t++)
+            for (IntType i = 0; i < first; i++)
+                if (vectors[(size_t)t * m + i] != 0) {
+                    first = i;
+                    break;
+                }
+
+        std::vector<T> c(rank), s(rank);
+        for (IntType k = first; k < m; k++) {
+            T* const row = m_factor.data() + (size_t)k * m;
+            bool rotated = false;
+            for (int t = 0; t < rank; t++) {
+                const T xk = vectors[(size_t)t * m + k];
+                if (xk == 0) {
+                    c[t] = T(1);
+                    s[t] = T(0);
+                    continue;
+                }
+                const T r2 = row[k] * row[k] + signs[t] * xk * xk;
+                if (!(r2 > T(1e-4) * row[k] * row[k]))
+                    return false;
+                const T r = std::sqrt(r2);
+                c[t] = r / row[k];
+                s[t] = xk / row[k];
+                row[k] = r;
+                rotated = true;
+            }
+            if (!rotated)
+                continue;
+#ifdef USE_OPENMP
+#pragma omp parallel for if ((size_t)(m - k) * rank > 16384)
+#endif
+            for (IntType i = k + 1; i < m; i++) {
+                T u = row[i];
+                for (int t = 0; t < rank; t++)
+                    if (s[t] != 0) {
+                        T& x = vectors[(size_t)t * m + i];
+                        u = (u + signs[t] * s[t] * x) / c[t];
+                        x = c[t] * x - s[t] * u;
+                    }
+                row[i] = u;
+            }
+        }
+        return true;
+    }
+
+    template<class Discretization, class IntType>
+    bool CollisionSchurSolver<Discretization, IntType>::factorCollisionBlock()
+    {
+        // m_factor holds the upper triangle of the block on entry. If it is not numerically positive definite,
+        // retry once with a small diagonal shift; the outer iterations absorb the difference.
+        const IntType m = schurSize;
+        std::vector<T> block(m_factor);
+        IntType info = LAPACKPolicy<T>::fact(m, m_factor.data());
+        m_factorShift = T(0);
+        m_factorUpdates = 0;
+        if (info == 0)
+            return true;
+        T maxDiagonal = T(0);
+        for (IntType i = 0; i < m; i++)
+            maxDiagonal = std::max(maxDiagonal, std::abs(block[(size_t)i * m + i]));
+        m_factorShift = std::max(maxDiagonal, T(1)) * T(1e-4);
+        for (IntType i = 0; i < m; i++)
+            block[(size_t)i * m + i] += m_factorShift;
+        m_factor.swap(block);
+        const IntType shiftedInfo = LAPACKPolicy<T>::fact(m, m_factor.data());
+        LOG::cout << "CollisionSchurSolver: collision block factorization failed, info = " << info
+            << (shiftedInfo == 0 ? "; factored with a diagonal shift of " : "; still failing with a diagonal shift of ") << m_factorShift << std::endl;
+        return shiftedInfo == 0;
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::eliminateInterior(const StateVariableType& f)
+    {
+        const IntType m = schurSize;
+        const IntType n1 = m_interior.m_pardiso.n;
+
+        m_interior.copyIn(f);
+        m_interior.solve(d);
+        std::copy(m_interior.m_x, m_interior.m_x + (size_t)n1 * d, m_interiorX.begin());
+
+        for (Iterator<StateVariableType> iterator(f); !iterator.isEnd(); iterator.next()) {
+            const int row = iterator.value(m_schurNumbering);
+            if (row >= 0)
+                for (int v = 0; v < d; v++)
+                    m_f2[(size_t)v * m + row] = iterator.value(f)(v + 1);
+        }
+        for (int v = 0; v < d; v++) {
+            T* const f2 = m_f2.data() + (size_t)v * m;
+            const T* const z1 = m_interiorX.data() + (size_t)v * n1;
+            for (IntType j = 0; j < m; j++)
+                for (IntType k = m_couplingOffsets[j]; k < m_couplingOffsets[j + 1]; k++)
+                    f2[j] -= m_couplingValues[k] * z1[m_couplingRows[k]];
+        }
+
+        std::fill(m_dx2.begin(), m_dx2.end(), T(0));
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::solveCollision(const StateVariableType& g, StateVariableType& dx)
+    {
+        const IntType m = schurSize;
+        if (!m_factorValid)
+            throw std::logic_error("CollisionSchurSolver::solveCollision() without a valid collision block factor");
+        T* const x2 = m_x2.data();
+
+        for (Iterator<StateVariableType> iterator(g); !iterator.isEnd(); iterator.next()) {
+            const int row = iterator.value(m_schurNumbering);
+            if (row >= 0)
+                for (int v = 0; v < d; v++)
+                    x2[(size_t)v * m + row] = m_f2[(size_t)v * m + row] + iterator.value(g)(v + 1);
+        }
+        // one potrs per coordinate; Accelerate's row-major wrapper passes the wrong leading dimension for nrhs > 1
+        for (int v = 0; v < d; v++)
+            LAPACKPolicy<T>::solve(m, 1, m_factor.data(), x2 + (size_t)v * m);
+
+        // the elastic part of Sigma1 * x2 is now accounted for in the collision node positions
+        for (int v = 0; v < d; v++)
+            CBLASPolicy<T>::mutiplyAdd(m_f2.data() + (size_t)v * m, m, T(-1), m_Sigma1.data(), x2 + (size_t)v * m, T(1));
+        for (size_t i = 0; i < m_dx2.size(); i++)
+            m_dx2[i] += x2[i];
+
+        for (Iterator<StateVariableType> iterator(dx); !iterator.isEnd(); iterator.next()) {
+            const int row = iterator.value(m_schurNumbering);
+            if (row >= 0)
+                for (int v = 0; v < d; v++)
+                    iterator.value(dx)(v + 1) = x2[(size_t)v * m + row];
+        }
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::recoverInterior(StateVariableType& dx)
+    {
+        const IntType m = schurSize;
+        const IntType n1 = m_interior.m_pardiso.n;
+
+        // x1 = K11^{-1} (f1 - K12 dx2)
+        std::fill(m_interior.m_rhs, m_interior.m_rhs + (size_t)n1 * d, T(0));
+        for (int v = 0; v < d; v++) {
+            T* const rhs = m_interior.m_rhs + (size_t)v * n1;
+            const T* const dx2 = m_dx2.data() + (size_t)v * m;
+            for (IntType j = 0; j < m; j++)
+                if (dx2[j] != 0)
+                    for (IntType k = m_couplingOffsets[j]; k < m_couplingOffsets[j + 1]; k++)
+                        rhs[m_couplingRows[k]] += m_couplingValues[k] * dx2[j];
+        }
+        m_interior.solve(d);
+
+        for (size_t i = 0; i < (size_t)n1 * d; i++)
+            m_interior.m_x[i] = m_interiorX[i] - m_interior.m_x[i];
+        m_interior.copyOut(dx);
+    }
+
+    template<class Discretization, class IntType>
+    void CollisionSchurSolver<Discretization, IntType>::deallocate()
+    {
+        m_interior.deallocate();
+        std::vector<std::map<int, T>>().swap(m_elementCoupling);
+        std::vector<T>().swap(m_elementK22);
+        std::vector<T>().swap(m_couplingValues);
+        std::vector<IntType>().swap(m_couplingRows);
+        m_couplingOffsets.clear();
+        std::vector<T>().swap(m_Sigma1);
+        m_schurValid = false;
+        m_schurConstraints.clear();
+        m_schurFakeSutures.clear();
+        m_schurSutures.clear();
+        m_schurMicroNodes.clear();
+        std::vector<T>().swap(m_pendingVectors);
+        m_pendingSigns.clear();
+        std::vector<T>().swap(m_A22);
+        std::vector<T>().swap(m_factor);
+        m_factoredTerms.clear();
+        m_factorValid = false;
+        m_factorShift = T(0);
+        m_factorUpdates = 0;
+        std::vector<T>().swap(m_interiorX);
+        m_f2.clear();
+        m_dx2.clear();
+        m_x2.clear();
+        schurSize = 0;
+    }
+}
+
+namespace PhysBAM {
+    template struct CollisionSchurSolver<TetrahedralDiscretization<std::vector<VECTOR<float, 3>>>, int>;
+}
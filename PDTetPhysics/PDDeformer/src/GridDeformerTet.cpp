@@ -1,5 +1,4 @@
 #include "../include/GridDeformerTet.h"
-#include "Add_Force.h"
 #include <chrono>
 
 #ifdef USE_OPENMP
@@ -84,6 +83,9 @@ namespace PhysBAM {
 		m_reshapeUncollisionRangeMax = reinterpret_cast<BlockedScalarType>(_aligned_malloc(m_nUncollisionBlocks * BlockWidth * sizeof(T), Alignment));
 		m_reshapeCollisionRangeMax = reinterpret_cast<BlockedScalarType>(_aligned_malloc(m_nCollisionBlocks * BlockWidth * sizeof(T), Alignment));
 
+		m_reshapeUncollisionf = reinterpret_cast<BlockedShapeMatrixType>(_aligned_malloc(m_nUncollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T), Alignment));
+		m_reshapeCollisionf = reinterpret_cast<BlockedShapeMatrixType>(_aligned_malloc(m_nCollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T), Alignment));
+
 #else
 
 		m_reshapeUncollisionX = reinterpret_cast<BlockedShapeMatrixType>(aligned_alloc(Alignment, m_nUncollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T)));
@@ -106,6 +108,9 @@ namespace PhysBAM {
 
 		m_reshapeUncollisionRangeMax = reinterpret_cast<BlockedScalarType>(aligned_alloc(Alignment, m_nUncollisionBlocks * BlockWidth * sizeof(T)));
 		m_reshapeCollisionRangeMax = reinterpret_cast<BlockedScalarType>(aligned_alloc(Alignment, m_nCollisionBlocks * BlockWidth * sizeof(T)));
+
+		m_reshapeUncollisionf = reinterpret_cast<BlockedShapeMatrixType>(aligned_alloc(Alignment, m_nUncollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T)));
+		m_reshapeCollisionf = reinterpret_cast<BlockedShapeMatrixType>(aligned_alloc(Alignment, m_nCollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T)));
 #endif
 		if (m_reshapeUncollisionX == nullptr || m_reshapeCollisionX == nullptr ||
 			m_reshapeUncollisionGradientMatrix == nullptr || m_reshapeCollisionGradientMatrix == nullptr ||
@@ -293,61 +298,56 @@ namespace PhysBAM {
     }
 
     template <class dataType, int dim>
-    void GridDeformerTet<std::vector<VECTOR<dataType,dim>>>:: addConstraintForce(StateVariableType &f) const
+    void GridDeformerTet<std::vector<VECTOR<dataType,dim>>>:: addConstraintForce(StateVariableType &f, SolveStats<T>* stats) const
     {
         StateVariableType fLocal;
         {
-            std::cout << "DEBUG: addConstraintForce - processing " << m_constraints.size() << " constraints" << std::endl;
-            int warningCount = 0;
+            int clampCount = 0;
             T maxDisplacement = 0;
             T maxForce = 0;
-            
+
             for (int c = 0; c < m_constraints.size(); c++) {
 				const auto &constraint = m_constraints[c];
 				if (constraint.m_stiffness) {
 					VectorType x;
 					x = DiscretizationType::template interpolateX<elementNodes>(constraint.m_elementIndex, constraint.m_weights, m_X);
-					
-					// Debug: Print current and target positions only for first few constraints
-					if (c < 3) {
-						std::cout << "  Constraint " << c << ": stiffness=" << constraint.m_stiffness 
+
+					if (PDTET_TELEMETRY_ON(Verbose) && c < 3)
+						std::cout << "  Constraint " << c << ": stiffness=" << constraint.m_stiffness
 						         << ", current=(" << x(1) << "," << x(2) << "," << x(3) << ")"
 						         << ", target=(" << constraint.m_xT(1) << "," << constraint.m_xT(2) << "," << constraint.m_xT(3) << ")" << std::endl;
-					}
-					
+
 					x -= constraint.m_xT;
 					const T length = x.Lp_Norm(2);
-					
-					if (length > maxDisplacement) maxDisplacement = length;
-					
+					maxDisplacement = std::max(maxDisplacement, length);
+
 					// MACOS PORT: Add safety check for extreme displacements
 					if (length > 100.0) {  // If displacement is more than 10cm, something is wrong
-						warningCount++;
+						clampCount++;
 						x *= 100.0 / length;
 					}
-					
+
 					if (length > constraint.m_stressLimit)
 						x *= constraint.m_stressLimit / length;
 					x *= -constraint.m_stiffness;
-					
-					// Debug: Print resulting force
-					T forceMagnitude = x.Lp_Norm(2);
-					if (forceMagnitude > maxForce) maxForce = forceMagnitude;
-					
+
 					// MACOS PORT: Additional safety check for extreme forces
+					const T forceMagnitude = x.Lp_Norm(2);
+					maxForce = std::max(maxForce, forceMagnitude);
 					if (forceMagnitude > 10000.0) {  // Cap forces at a reasonable maximum
-						warningCount++;
+						clampCount++;
 						x *= 10000.0 / forceMagnitude;
 					}
 
 					DiscretizationType::template distributeForces<elementNodes>(x, constraint.m_elementIndex, constraint.m_weights, f);
 				}
             }
-            
-            std::cout << "  Summary: max displacement = " << maxDisplacement 
-                      << ", max force = " << maxForce 
-                      << ", warnings = " << warningCount << std::endl;
 
+            if (stats) {
+                stats->m_maxConstraintDisplacement = maxDisplacement;
+                stats->m_maxConstraintForce = maxForce;
+                stats->m_constraintClamps = clampCount;
+            }
         }
 
         {
@@ -419,6 +419,153 @@ namespace PhysBAM {
 		}
 	}
 
+	template<class dataType, int dim>
+	int GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::addConstraint(const Constraint& constraint)
+	{
+		const int handle = (int)m_constraintSlots.size();
+		m_constraintSlots.push_back((int)m_constraints.size());
+		m_constraintHandles.push_back(handle);
+		m_constraints.push_back(constraint);
+		return handle;
+	}
+
+	template<class dataType, int dim>
+	bool GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::deleteConstraint(const int handle)
+	{
+		if (handle < 0 || handle >= (int)m_constraintSlots.size() || m_constraintSlots[handle] < 0)
+			return false;
+		const int slot = m_constraintSlots[handle];
+		m_constraints[slot].m_stiffness = 0;
+		m_constraintHandles[slot] = -1;
+		m_constraintSlots[handle] = -1;
+		++m_deadConstraints;
+		return true;
+	}
+
+	template<class dataType, int dim>
+	int GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::addFakeSuture(const Constraint& constraint0, const Constraint& constraint1)
+	{
+		const int handle = (int)m_sutureSlots.size();
+		m_sutureSlots.push_back(-2 - (int)m_fakeSutureHandles.size());
+		m_fakeSutureHandles.push_back(handle);
+		m_fakeSutures.push_back(constraint0);
+		m_fakeSutures.push_back(constraint1);
+		return handle;
+	}
+
+	template<class dataType, int dim>
+	bool GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::deleteSuture(const int handle)
+	{
+		if (handle < 0 || handle >= (int)m_sutureSlots.size() || m_sutureSlots[handle] == -1)
+			return false;
+		const int slot = m_sutureSlots[handle];
+		if (slot >= 0) {
+			m_sutures[slot].m_stiffness = 0;
+			m_sutureHandles[slot] = -1;
+		}
+		else {
+			const int pair = -2 - slot;
+			m_fakeSutures[pair * 2].m_stiffness = 0;
+			m_fakeSutures[pair * 2 + 1].m_stiffness = 0;
+			m_fakeSutureHandles[pair] = -1;
+		}
+		m_sutureSlots[handle] = -1;
+		++m_deadConstraints;
+		return true;
+	}
+
+	template<class dataType, int dim>
+	void GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::promoteFakeSutures()
+	{
+		for (int pair = 0; pair < (int)m_fakeSutureHandles.size(); ++pair) {
+			const int handle = m_fakeSutureHandles[pair];
+			if (handle < 0) {  // deleted, nothing to promote
+				--m_deadConstraints;
+				continue;
+			}
+			const Constraint& c0 = m_fakeSutures[pair * 2];
+			const Constraint& c1 = m_fakeSutures[pair * 2 + 1];
+			Suture suture{};
+			suture.m_elementIndex1 = c0.m_elementIndex;
+			suture.m_elementIndex2 = c1.m_elementIndex;
+			suture.m_weights1 = c0.m_weights;
+			suture.m_weights2 = c1.m_weights;
+			suture.m_stiffness = c0.m_stiffness / 2;
+			m_sutureSlots[handle] = (int)m_sutures.size();
+			m_sutureHandles.push_back(handle);
+			m_sutures.push_back(suture);
+		}
+		m_fakeSutures.clear();
+		m_fakeSutureHandles.clear();
+	}
+
+	template<class dataType, int dim>
+	void GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::clearConstraints()
+	{
+		m_constraints.clear();
+		m_sutures.clear();
+		m_fakeSutures.clear();
+		m_constraintSlots.clear();
+		m_constraintHandles.clear();
+		m_sutureSlots.clear();
+		m_sutureHandles.clear();
+		m_fakeSutureHandles.clear();
+		m_deadConstraints = 0;
+	}
+
+	template<class dataType, int dim>
+	bool GridDeformerTet<std::vector<VECTOR<dataType, dim>>>::compactConstraints()
+	{
+		if (!m_deadConstraints)
+			return false;
+		// survivors keep their order, so the result only depends on which handles were deleted
+		int n = 0;
+		for (int i = 0; i < (int)m_constraints.size(); ++i) {
+			const int handle = m_constraintHandles[i];
+			if (handle < 0)
+				continue;
+			if (n != i) {
+				m_constraints[n] = m_constraints[i];
+				m_constraintHandles[n] = handle;
+			}
+			m_constraintSlots[handle] = n++;
+		}
+		m_constraints.resize(n);
+		m_constraintHandles.resize(n);
+
+		n = 0;
+		for (int i = 0; i < (int)m_sutures.size(); ++i) {
+			const int handle = m_sutureHandles[i];
+			if (handle < 0)
+				continue;
+			if (n != i) {
+				m_sutures[n] = m_sutures[i];
+				m_sutureHandles[n] = handle;
+			}
+			m_sutureSlots[handle] = n++;
+		}
+		m_sutures.resize(n);
+		m_sutureHandles.resize(n);
+
+		n = 0;
+		for (int i = 0; i < (int)m_fakeSutureHandles.size(); ++i) {
+			const int handle = m_fakeSutureHandles[i];
+			if (handle < 0)
+				continue;
+			if (n != i) {
+				m_fakeSutures[n * 2] = m_fakeSutures[i * 2];
+				m_fakeSutures[n * 2 + 1] = m_fakeSutures[i * 2 + 1];
+				m_fakeSutureHandles[n] = handle;
+			}
+			m_sutureSlots[handle] = -2 - n++;
+		}
+		m_fakeSutures.resize(n * 2);
+		m_fakeSutureHandles.resize(n);
+
+		m_deadConstraints = 0;
+		return true;
+	}
+
     template <class dataType, int dim>
     void GridDeformerTet<std::vector<VECTOR<dataType,dim>>>::addElasticForce(std::vector<VECTOR<dataType, dim>> &SIMDf, const ElementFlag flag /*, const dataType rangeMin, const dataType rangeMax, const dataType weightProportion */ ) const
     {
@@ -433,11 +580,7 @@ namespace PhysBAM {
         //for (int i = 0; i < BlockWidth; i++) strainMax[i] = rangeMax;
 
         if (flag == ElementFlag::unCollisionEl) {
-#ifdef _WIN32
-			BlockedShapeMatrixType reshapeUncollisionf = reinterpret_cast<BlockedShapeMatrixType>(_aligned_malloc(m_nUncollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T), Alignment));
-#else
-			BlockedShapeMatrixType reshapeUncollisionf = reinterpret_cast<BlockedShapeMatrixType>(aligned_alloc(Alignment, m_nUncollisionBlocks*BlockWidth*(d+1)*d*sizeof(T)));
-#endif
+			BlockedShapeMatrixType reshapeUncollisionf = m_reshapeUncollisionf;
 			if (reshapeUncollisionf) {
 				for (int b = 0; b < m_nUncollisionBlocks; b++)
 					for (int v = 0; v < d + 1; v++)
@@ -449,35 +592,19 @@ namespace PhysBAM {
 #pragma omp parallel for
 #endif
 				for (int be = 0; be < m_nUncollisionBlocks; be++) {
-					for (int ee = 0; ee < BlockWidth; ee += Tarch::Width)
-						Add_Force<Tarch, T[BlockWidth]>(reinterpret_cast<T(&)[d + 1][d][BlockWidth]>(m_reshapeUncollisionX[be][0][0][ee]),
-							reinterpret_cast<T(&)[d * d][BlockWidth]>(m_reshapeUncollisionGradientMatrix[be][0][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeUncollisionElementRestVolume[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeUncollisionMuLow[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeUncollisionMuHigh[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeUncollisionRangeMin[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeUncollisionRangeMax[be][ee]),
-							reinterpret_cast<T(&)[d + 1][d][BlockWidth]>(reshapeUncollisionf[be][0][0][ee]));
+					m_addForceBlock(m_reshapeUncollisionX[be], m_reshapeUncollisionGradientMatrix[be], m_reshapeUncollisionElementRestVolume[be],
+						m_reshapeUncollisionMuLow[be], m_reshapeUncollisionMuHigh[be], m_reshapeUncollisionRangeMin[be], m_reshapeUncollisionRangeMax[be], reshapeUncollisionf[be]);
 				}
 
 				unblockAddForce<T, BlockWidth>(&reshapeUncollisionf[0][0][0][0], &m_reshapeUncollisionIndicesOffsets[0], &m_reshapeUncollisionIndicesValues[0], (int)m_X.size(), &SIMDf[0](1));
-#ifdef _WIN32
-				_aligned_free(reshapeUncollisionf);
-#else
-				free(reshapeUncollisionf);
-#endif
 			}
 			else {
-				std::cerr << "Not enough space for reshapeUncollisionf" << std::endl;
+				std::cerr << "reshapeUncollisionf not allocated" << std::endl;
 				exit(1);
 			}
         }
         else if (flag == ElementFlag::CollisionEl) {
-#ifdef _WIN32
-			BlockedShapeMatrixType reshapeCollisionf = reinterpret_cast<BlockedShapeMatrixType>(_aligned_malloc(m_nCollisionBlocks*BlockWidth*(d + 1)*d * sizeof(T), Alignment));
-#else
-			BlockedShapeMatrixType reshapeCollisionf = reinterpret_cast<BlockedShapeMatrixType>(aligned_alloc(Alignment, m_nCollisionBlocks*BlockWidth*(d+1)*d*sizeof(T)));
-#endif
+			BlockedShapeMatrixType reshapeCollisionf = m_reshapeCollisionf;
 			if (reshapeCollisionf) {
 				for (int b = 0; b < m_nCollisionBlocks; b++)
 					for (int v = 0; v < d + 1; v++)
@@ -489,26 +616,14 @@ namespace PhysBAM {
 #pragma omp parallel for
 #endif
 				for (int be = 0; be < m_nCollisionBlocks; be++) {
-					for (int ee = 0; ee < BlockWidth; ee += Tarch::Width)
-						Add_Force<Tarch, T[BlockWidth]>(reinterpret_cast<T(&)[d + 1][d][BlockWidth]>(m_reshapeCollisionX[be][0][0][ee]),
-							reinterpret_cast<T(&)[d * d][BlockWidth]>(m_reshapeCollisionGradientMatrix[be][0][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeCollisionElementRestVolume[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeCollisionMuLow[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeCollisionMuHigh[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeCollisionRangeMin[be][ee]),
-							reinterpret_cast<T(&)[BlockWidth]>(m_reshapeCollisionRangeMax[be][ee]),
-							reinterpret_cast<T(&)[d + 1][d][BlockWidth]>(reshapeCollisionf[be][0][0][ee]));
+					m_addForceBlock(m_reshapeCollisionX[be], m_reshapeCollisionGradientMatrix[be], m_reshapeCollisionElementRestVolume[be],
+						m_reshapeCollisionMuLow[be], m_reshapeCollisionMuHigh[be], m_reshapeCollisionRangeMin[be], m_reshapeCollisionRangeMax[be], reshapeCollisionf[be]);
 				}
 
 				unblockAddForce<T, BlockWidth>(&reshapeCollisionf[0][0][0][0], &m_reshapeCollisionIndicesOffsets[0], &m_reshapeCollisionIndicesValues[0], (int)m_X.size(), &SIMDf[0](1));
-#ifdef _WIN32
-				_aligned_free(reshapeCollisionf);
-#else
-				free(reshapeCollisionf);
-#endif
 			}
 			else {
-				std::cerr << "Not enough space for reshapeCollisionf" << std::endl;
+				std::cerr << "reshapeCollisionf not allocated" << std::endl;
 				exit(1);
 			}
         }
@@ -534,6 +649,8 @@ namespace PhysBAM {
 		if (m_reshapeCollisionRangeMin) _aligned_free(m_reshapeCollisionRangeMin);
 		if (m_reshapeUncollisionRangeMax) _aligned_free(m_reshapeUncollisionRangeMax);
 		if (m_reshapeCollisionRangeMax) _aligned_free(m_reshapeCollisionRangeMax);
+		if (m_reshapeUncollisionf) _aligned_free(m_reshapeUncollisionf);
+		if (m_reshapeCollisionf) _aligned_free(m_reshapeCollisionf);
 #else
         free(m_reshapeUncollisionX);
         free(m_reshapeCollisionX);
@@ -552,7 +669,8 @@ namespace PhysBAM {
 		free(m_reshapeCollisionRangeMin);
 		free(m_reshapeUncollisionRangeMax);
 		free(m_reshapeCollisionRangeMax);
-
+		free(m_reshapeUncollisionf);
+		free(m_reshapeCollisionf);
 #endif
 		m_reshapeUncollisionX = nullptr;
 		m_reshapeCollisionX = nullptr;
@@ -571,9 +689,9 @@ namespace PhysBAM {
 		m_reshapeCollisionRangeMax = nullptr;
 		m_reshapeUncollisionRangeMin = nullptr;
 		m_reshapeCollisionRangeMin = nullptr;
+		m_reshapeUncollisionf = nullptr;
+		m_reshapeCollisionf = nullptr;
 
-
-		
     }
 
 /*void addElasticForce(StateVariableType &f, const ElementFlag flag, const T weightProportion) const {
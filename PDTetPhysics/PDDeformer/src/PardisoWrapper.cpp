@@ -5,12 +5,16 @@
 
 #include "PardisoWrapper.h"
 #include "MKLWrapper.h"
+#include "OrderingCache.h"
+#include "Telemetry.h"
 
 #if TIMING
 #include "chrono" // for timing only
 #endif
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 
 
@@ -21,6 +25,13 @@ void PardisoWrapper<T, IntType>::initialize(const IntType _n, const IntType _nnz
         n = _n;
         m = (int)_m;
 
+        const SparseSPDBackend selected = defaultSparseSPDBackend();
+        if (sparseSolver && selected != backend) {
+            delete sparseSolver;
+            sparseSolver = nullptr;
+        }
+        backend = selected;
+
         // allocate spaces
         rowIndex = new IntType[n+1];
         column = new IntType[_nnz];
@@ -108,6 +119,37 @@ void PardisoWrapper<T, IntType>::symbolicFact() {
     IntType idum; /* Integer dummy. */
     IntType phase = 11;
 
+    // The ordering depends on the pattern alone, which often outlives a reinitialization unchanged. With
+    // a Schur complement perm marks the Schur rows instead, so those are always ordered afresh.
+    std::vector<IntType> order;
+    int warmStarts = 0;
+    const OrderingMatch match = m ? OrderingMatch::None : OrderingCache<IntType>::instance().lookup(n, rowIndex, column, order, warmStarts);
+    if (PDTET_TELEMETRY_ON(Verbose))
+        std::cout << "PardisoWrapper: ordering " << (match == OrderingMatch::Exact ? "reused" : match == OrderingMatch::Grown ? "warm started" : "computed")
+                  << " for n = " << n << ", nnz = " << rowIndex[n] << std::endl;
+
+    if (backend != SparseSPDBackend::Pardiso) {
+        if (!sparseSolver)
+            sparseSolver = createSparseSPDSolver<T, IntType>(backend);
+        if (!sparseSolver)
+            throw std::logic_error(std::string(sparseSPDBackendName(backend)) + " sparse solver was not compiled in");
+        if (m) {
+            splitSchurPattern();
+            if (!sparseSolver->analyze(n - m, interiorRowIndex.data(), interiorColumn.data()))
+                throw std::logic_error(std::string("ERROR during symbolic factorization with ") + sparseSPDBackendName(backend));
+            return;
+        }
+        if (!sparseSolver->analyze(n, rowIndex, column, match == OrderingMatch::None ? nullptr : order.data()))
+            throw std::logic_error(std::string("ERROR during symbolic factorization with ") + sparseSPDBackendName(backend));
+        if (match != OrderingMatch::Exact) {
+            order.resize(n);
+            sparseSolver->ordering(order.data());
+            OrderingCache<IntType>::instance().store(n, rowIndex, column, order, warmStarts);
+        }
+        return;
+    }
+
+#ifndef __APPLE__
     if (m) {
         for (IntType i=0; i<n-m; i++)
             schurNodes[i] = 0;
@@ -118,12 +160,29 @@ void PardisoWrapper<T, IntType>::symbolicFact() {
                                                 n, value, rowIndex, column, schurNodes, nrhs,
                                                 iparm, msglvl, &ddum, &ddum);
     } else {
-        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, nrhs, iparm, msglvl, &ddum, &ddum);
+        // Pardiso's perm is the inverse of order: row i of A becomes row perm[i]
+        std::vector<IntType> perm(n);
+        if (match != OrderingMatch::None) {
+            for (IntType k = 0; k < n; k++)
+                perm[order[k]] = k;
+            iparm[4] = 1; /* use the permutation in perm */
+        }
+        else
+            iparm[4] = 2; /* return the computed permutation in perm */
+        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, perm.data(), nrhs, iparm, msglvl, &ddum, &ddum);
+        iparm[4] = 0;
+        if (error == 0 && match != OrderingMatch::Exact) {
+            order.resize(n);
+            for (IntType i = 0; i < n; i++)
+                order[perm[i]] = i;
+            OrderingCache<IntType>::instance().store(n, rowIndex, column, order, warmStarts);
+        }
     }
 
     if ( error != 0 ) {
         throw std::logic_error("ERROR during symbolic factorization (phase " + std::to_string(phase) + ") with error " + std::to_string(error));
     }
+#endif
 #if TIMING
     endStamp = std::chrono::steady_clock::now();
     elapsed_second = endStamp - startStamp;
@@ -145,6 +204,21 @@ void PardisoWrapper<T, IntType>::numericFact() {
     IntType idum; /* Integer dummy. */
     IntType phase = 22;
 
+    if (sparseSolver) {
+        if (m) {
+            interiorValue.resize(interiorSlots.size());
+            for (size_t k = 0; k < interiorSlots.size(); k++)
+                interiorValue[k] = value[interiorSlots[k]];
+            if (!sparseSolver->factorize(interiorValue.data()))
+                throw std::logic_error(std::string("ERROR during numerical factorization with ") + sparseSPDBackendName(backend));
+            sparseSchurComplement();
+        }
+        else if (!sparseSolver->factorize(value))
+            throw std::logic_error(std::string("ERROR during numerical factorization with ") + sparseSPDBackendName(backend));
+        return;
+    }
+
+#ifndef __APPLE__
     if (m) {
         error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase,
                                                 n, value, rowIndex, column, schurNodes, nrhs,
@@ -164,6 +238,7 @@ void PardisoWrapper<T, IntType>::numericFact() {
     if ( error != 0 ) {
         throw std::logic_error("ERROR during numerical factorization (phase " + std::to_string(phase) + ") with error " + std::to_string(error));
     }
+#endif
 #if TIMING
     endStamp = std::chrono::steady_clock::now();
     elapsed_second = endStamp - startStamp;
@@ -174,6 +249,13 @@ void PardisoWrapper<T, IntType>::numericFact() {
 
 template<class T, class IntType>
 void PardisoWrapper<T, IntType>::releasePardisoInternal() {
+        if (backend != SparseSPDBackend::Pardiso) {
+            delete sparseSolver;
+            sparseSolver = nullptr;
+            return;
+        }
+
+#ifndef __APPLE__
         // Termination and release of memory.
         IntType phase = -1; /* Release internal memory. */
         IntType error;
@@ -184,6 +266,7 @@ void PardisoWrapper<T, IntType>::releasePardisoInternal() {
             throw std::logic_error("ERROR during release (phase " + std::to_string(phase) + ") with error " + std::to_string(error));
 
         }
+#endif
     }
 
 template<class T, class IntType>
@@ -208,7 +291,32 @@ void PardisoWrapper<T, IntType>::deallocate() {
     }
 
 template<class T, class IntType>
-void PardisoWrapper<T, IntType>::forwardSubstitution(T* const _rhs, T* const _x) {
+void PardisoWrapper<T, IntType>::forwardSubstitution(T* const _rhs, T* const _x, const IntType _nrhs) {
+    if (sparseSolver && m) {
+        // x1 = K11^{-1} b1, x2 = b2 - K12^T x1
+        const IntType n1 = n - m;
+        interiorRhs.resize((size_t)n1 * _nrhs);
+        for (IntType c = 0; c < _nrhs; c++)
+            std::copy(_rhs + (size_t)c * n, _rhs + (size_t)c * n + n1, interiorRhs.begin() + (size_t)c * n1);
+        interiorSolve(_nrhs);
+        for (IntType c = 0; c < _nrhs; c++) {
+            T* const x = _x + (size_t)c * n;
+            const T* const x1 = interiorX.data() + (size_t)c * n1;
+            std::copy(x1, x1 + n1, x);
+            std::copy(_rhs + (size_t)c * n + n1, _rhs + (size_t)(c + 1) * n, x + n1);
+            for (IntType i = 0; i < n1; i++)
+                for (IntType k = couplingRowIndex[i]; k < couplingRowIndex[i + 1]; k++)
+                    x[n1 + couplingColumn[k]] -= value[couplingSlots[k]] * x1[i];
+        }
+        return;
+    }
+    if (sparseSolver) {
+        if (!sparseSolver->forwardSubstitution(_rhs, _x, _nrhs))
+            throw std::logic_error(std::string("ERROR during forward substitution with ") + sparseSPDBackendName(backend));
+        return;
+    }
+
+#ifndef __APPLE__
     IntType error;
     const IntType phase = 331;
     iparm[7] = 0; /* Max numbers of iterative refinement steps. */
@@ -216,7 +324,7 @@ void PardisoWrapper<T, IntType>::forwardSubstitution(T* const _rhs, T* const _x)
     IntType idum;
 
     if (m) {
-        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, schurNodes, nrhs, iparm, msglvl, _rhs, _x);
+        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, schurNodes, _nrhs, iparm, msglvl, _rhs, _x);
 
         if ( error != 0 ) {
             throw std::logic_error("ERROR during solution (phase " + std::to_string(phase) + ") with error " + std::to_string(error));
@@ -224,47 +332,87 @@ void PardisoWrapper<T, IntType>::forwardSubstitution(T* const _rhs, T* const _x)
 
     } else {
 
-        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, nrhs, iparm, msglvl, _rhs, _x);
+        error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, _nrhs, iparm, msglvl, _rhs, _x);
         if (error != 0) {
             throw std::logic_error("ERROR during solution (phase " + std::to_string(331) + ") with error " + std::to_string(error));
 
         }
     }
+#endif
 }
 
 template<class T, class IntType>
-void PardisoWrapper<T, IntType>::diagSolve(T* const _rhs, T* const _x) {
+void PardisoWrapper<T, IntType>::diagSolve(T* const _rhs, T* const _x, const IntType _nrhs) {
+        if (sparseSolver && !m) {
+            if (!sparseSolver->diagSolve(_rhs, _x, _nrhs))
+                throw std::logic_error(std::string("ERROR during diagonal solve with ") + sparseSPDBackendName(backend));
+            return;
+        }
+
         // this may not support 64 bit ints
         const IntType phase = 332;
         if (m) {
 
-            IntType info = LAPACKPolicy<T>::solve(m,nrhs,schur,&_rhs[n-m]);
-            if (info != 0)
-            {
-                throw std::logic_error("info after LAPACKE_dspotrs = " + std::to_string(info));
+            // one right hand side at a time: the Schur block of each sits at the end of its own column
+            for (IntType c = 0; c < _nrhs; c++) {
+                IntType info = LAPACKPolicy<T>::solve(m,1,schur,&_rhs[c*n+n-m]);
+                if (info != 0)
+                {
+                    throw std::logic_error("info after LAPACKE_dspotrs = " + std::to_string(info));
+                }
             }
-            for (IntType i = 0; i < n; i++ ) {
+            for (IntType i = 0; i < n*_nrhs; i++ ) {
                 _x[i] = _rhs[i];
             }
 
         } else {
+#ifndef __APPLE__
             IntType error;
             iparm[7] = 0; /* Max numbers of iterative refinement steps. */
             IntType idum;
             // T ddum;
 
-            error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, nrhs, iparm, msglvl, _rhs,
+            error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, _nrhs, iparm, msglvl, _rhs,
                     _x);
             if (error != 0) {
                 throw std::logic_error("ERROR during solution (phase " + std::to_string(33) + ") with error " + std::to_string(error));
             }
-
+#endif
         }
     }
 
 
 template<class T, class IntType>
-void PardisoWrapper<T, IntType>::backwardSubstitution(T* const _rhs, T* const _x) {
+void PardisoWrapper<T, IntType>::backwardSubstitution(T* const _rhs, T* const _x, const IntType _nrhs) {
+        if (sparseSolver && m) {
+            // x1 = b1 - K11^{-1} K12 b2, x2 = b2
+            const IntType n1 = n - m;
+            interiorRhs.assign((size_t)n1 * _nrhs, T(0));
+            for (IntType c = 0; c < _nrhs; c++) {
+                const T* const b2 = _rhs + (size_t)c * n + n1;
+                T* const w = interiorRhs.data() + (size_t)c * n1;
+                for (IntType i = 0; i < n1; i++)
+                    for (IntType k = couplingRowIndex[i]; k < couplingRowIndex[i + 1]; k++)
+                        w[i] += value[couplingSlots[k]] * b2[couplingColumn[k]];
+            }
+            interiorSolve(_nrhs);
+            for (IntType c = 0; c < _nrhs; c++) {
+                const T* const b = _rhs + (size_t)c * n;
+                const T* const z = interiorX.data() + (size_t)c * n1;
+                T* const x = _x + (size_t)c * n;
+                for (IntType i = 0; i < n1; i++)
+                    x[i] = b[i] - z[i];
+                std::copy(b + n1, b + n, x + n1);
+            }
+            return;
+        }
+        if (sparseSolver) {
+            if (!sparseSolver->backwardSubstitution(_rhs, _x, _nrhs))
+                throw std::logic_error(std::string("ERROR during backward substitution with ") + sparseSPDBackendName(backend));
+            return;
+        }
+
+#ifndef __APPLE__
         const IntType phase = 333;
         IntType error;
         IntType idum;
@@ -272,22 +420,87 @@ void PardisoWrapper<T, IntType>::backwardSubstitution(T* const _rhs, T* const _x
 
         if (m) {
             error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase,
-                    n, value, rowIndex, column, schurNodes, nrhs,
+                    n, value, rowIndex, column, schurNodes, _nrhs,
                     iparm, msglvl, _rhs, _x);
             if ( error != 0 )
             {
                 throw std::logic_error("ERROR during solution (phase " + std::to_string(phase) + ") with error " + std::to_string(error));
             }
         } else {
-            error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, nrhs, iparm, msglvl, _rhs,
+            error = PardisoPolicy<T, IntType>::exec(pt, maxfct, mnum, mtype, phase, n, value, rowIndex, column, &idum, _nrhs, iparm, msglvl, _rhs,
                     _x);
 
             if (error != 0) {
                 throw std::logic_error("ERROR during solution (phase " + std::to_string(33) + ") with error " + std::to_string(error));
             }
         }
+#endif
     }
 
+template<class T, class IntType>
+void PardisoWrapper<T, IntType>::splitSchurPattern() {
+    // upper triangle CSR with sorted columns, so in each interior row the K11 entries come before the K12 ones
+    const IntType n1 = n - m;
+    interiorRowIndex.assign(n1 + 1, 0);
+    couplingRowIndex.assign(n1 + 1, 0);
+    interiorColumn.clear();
+    interiorSlots.clear();
+    couplingColumn.clear();
+    couplingSlots.clear();
+    for (IntType i = 0; i < n1; i++) {
+        for (IntType k = rowIndex[i]; k < rowIndex[i + 1]; k++)
+            if (column[k] < n1) {
+                interiorColumn.push_back(column[k]);
+                interiorSlots.push_back(k);
+            }
+            else {
+                couplingColumn.push_back(column[k] - n1);
+                couplingSlots.push_back(k);
+            }
+        interiorRowIndex[i + 1] = (IntType)interiorColumn.size();
+        couplingRowIndex[i + 1] = (IntType)couplingColumn.size();
+    }
+}
+
+template<class T, class IntType>
+void PardisoWrapper<T, IntType>::sparseSchurComplement() {
+    // schur = K22 - K12^T K11^{-1} K12 in both triangles, row major as Pardiso returns it
+    const IntType n1 = n - m;
+    std::fill(schur, schur + (size_t)m * m, T(0));
+    for (IntType i = n1; i < n; i++)
+        for (IntType k = rowIndex[i]; k < rowIndex[i + 1]; k++) {
+            const IntType j = column[k] - n1;
+            schur[(size_t)(i - n1) * m + j] = schur[(size_t)j * m + i - n1] = value[k];
+        }
+    // a batch of K12 columns per sweep over the factor
+    const IntType batchSize = 16;
+    for (IntType first = 0; first < m; first += batchSize) {
+        const IntType batch = std::min(batchSize, m - first);
+        interiorRhs.assign((size_t)n1 * batch, T(0));
+        for (IntType i = 0; i < n1; i++)
+            for (IntType k = couplingRowIndex[i]; k < couplingRowIndex[i + 1]; k++)
+                if (couplingColumn[k] >= first && couplingColumn[k] < first + batch)
+                    interiorRhs[(size_t)(couplingColumn[k] - first) * n1 + i] = value[couplingSlots[k]];
+        interiorSolve(batch);
+        for (IntType c = 0; c < batch; c++) {
+            const T* const z = interiorX.data() + (size_t)c * n1;
+            for (IntType i = 0; i < n1; i++)
+                for (IntType k = couplingRowIndex[i]; k < couplingRowIndex[i + 1]; k++)
+                    schur[(size_t)couplingColumn[k] * m + first + c] -= value[couplingSlots[k]] * z[i];
+        }
+    }
+}
+
+template<class T, class IntType>
+void PardisoWrapper<T, IntType>::interiorSolve(const IntType _nrhs) {
+    // interiorX = K11^{-1} interiorRhs for _nrhs columns of length n - m; interiorRhs is used as scratch
+    interiorX.resize(interiorRhs.size());
+    if (!sparseSolver->forwardSubstitution(interiorRhs.data(), interiorX.data(), _nrhs)
+        || !sparseSolver->diagSolve(interiorX.data(), interiorRhs.data(), _nrhs)
+        || !sparseSolver->backwardSubstitution(interiorRhs.data(), interiorX.data(), _nrhs))
+        throw std::logic_error(std::string("ERROR during interior solve with ") + sparseSPDBackendName(backend));
+}
+
  template struct PardisoWrapper<double, int>;
 template struct PardisoWrapper<float, int>;
 
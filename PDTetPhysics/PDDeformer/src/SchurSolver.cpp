@@ -1,5 +1,12 @@
 #include "SchurSolver.h"
 
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace PhysBAM {
     template<class Discretization, class IntType>
     inline void SchurSolver<Discretization, IntType>::initialize(const NodeArrayType& nodeType) {
@@ -33,8 +40,8 @@ namespace PhysBAM {
                 iterator.value(m_numbering) = numOfActiveNodes - schurSize + collisionIdx++;
             else
                 iterator.value(m_numbering) = -1;
+        m_tensorRows = numOfActiveNodes;
         m_tensor.clear();
-        m_tensor.resize(numOfActiveNodes);
 
         if (!schurSize) {
 #if 0
@@ -49,54 +56,87 @@ namespace PhysBAM {
             m_pardiso.schur = m_schur;
         }
 
-        m_rhs = new T[numOfActiveNodes];
-        m_x = new T[numOfActiveNodes]();
+        // room for one right hand side per coordinate, see solve(nrhs)
+        m_rhs = new T[numOfActiveNodes * d];
+        m_x = new T[numOfActiveNodes * d]();
     }
 
     template<class Discretization, class IntType>
-    template<int elementNodesN>
+    template<int elementNodesN, class MatrixType>
     inline void SchurSolver<Discretization, IntType>::
-        accumToTensor(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex) {
+        accumToTensor(const MatrixType& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex, std::vector<TensorEntry>& bucket) const {
         using IteratorType = Iterator<NodeArrayType>;
         for (int i = 0; i < elementNodesN; i++) {
-            int row = IteratorType::at(m_numbering, elementIndex[i]);
+            const IntType row = IteratorType::at(m_numbering, elementIndex[i]);
             if (row >= 0) {
                 for (int j = 0; j < elementNodesN; j++) {
-                    int col = IteratorType::at(m_numbering, elementIndex[j]);
-                    if (col >= row) {
-                        if (m_tensor[row].find(col) == m_tensor[row].end())
-                            m_tensor[row].insert(std::pair<int, T>(col, stiffnessMatrix(i + 1, j + 1)));
-                        else
-                            m_tensor[row][col] += stiffnessMatrix(i + 1, j + 1);
-                    }
+                    const IntType col = IteratorType::at(m_numbering, elementIndex[j]);
+                    if (col >= row)
+                        bucket.push_back({ row, col, stiffnessMatrix(i + 1, j + 1) });
                 }
             }
         }
     }
 
+    template<class Discretization, class IntType>
+    template<class ElementConstant>
+    void SchurSolver<Discretization, IntType>::accumElementTensors(const std::vector<ElementType>& elements,
+        const std::vector<GradientMatrixType>& gradients,
+        const ElementConstant& constant)
+    {
+        // Chunks of consecutive elements, so every row receives its entries in element order whatever the
+        // thread count and the summed matrix comes out bitwise the same.
+#ifdef USE_OPENMP
+        const int threads = omp_get_max_threads();
+#else
+        const int threads = 1;
+#endif
+        const int chunks = std::max(1, std::min(threads, int(elements.size() / 4096)));
+        const size_t first = m_tensor.size();
+        m_tensor.resize(first + chunks);
 
-    template<class Discretization, class IntType>  // COURT added this debug subroutine to isolate Release only crash of physics thread
-    template<int elementNodesN>
-    inline void SchurSolver<Discretization, IntType>::
-        accumToTensor_debug(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex) {
-        using IteratorType = Iterator<NodeArrayType>;
-        for (int i = 0; i < elementNodesN; i++) {
-            int row = IteratorType::at(m_numbering, elementIndex[i]);
-            if (row >= 0) {
-                for (int j = 0; j < elementNodesN; j++) {
-                    int col = IteratorType::at(m_numbering, elementIndex[j]);
-                    if (col >= row) {
-                        if (m_tensor[row].find(col) == m_tensor[row].end())
-//                            ;
-                            m_tensor[row].insert(std::pair<int, T>(col, stiffnessMatrix(i + 1, j + 1)));
-                        else
-                            m_tensor[row][col] += stiffnessMatrix(i + 1, j + 1);
-                    }
-                }
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+        for (int c = 0; c < chunks; c++) {
+            const size_t begin = elements.size() * c / chunks;
+            const size_t end = elements.size() * (c + 1) / chunks;
+            auto& bucket = m_tensor[first + c];
+            bucket.reserve((end - begin) * elementNodes * (elementNodes + 1) / 2);
+            typename DiscretizationType::ElementMatrixType stiffnessMatrix;
+            for (size_t e = begin; e < end; e++) {
+                DiscretizationType::computeElementTensor(stiffnessMatrix, gradients[e], constant(e));
+                accumToTensor<elementNodes>(stiffnessMatrix, DiscretizationType::getElementIndex(elements[e]), bucket);
             }
         }
     }
 
+    template<class Discretization, class IntType>
+    void SchurSolver<Discretization, IntType>::accumConstraintTensors(const std::vector<Suture>& sutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        // only the sparsity matters here, the stiffness goes in with the constraint values in factPardiso
+        m_tensor.emplace_back();
+        auto& bucket = m_tensor.back();
+
+        for (int c = 0; c < sutures.size(); c++) {
+            MATRIX_MXN<T> stiffnessMatrix;
+            std::array<IndexType, elementNodes * 2> elementIndex;
+            Suture tmp = sutures[c];
+            tmp.m_stiffness = 0;
+            DiscretizationType::computeSutureTensor(stiffnessMatrix, elementIndex, tmp);
+            accumToTensor<elementNodes * 2>(stiffnessMatrix, elementIndex, bucket);
+        }
+
+        for (const auto& c : microNodes) {
+            MATRIX_MXN<T> stiffnessMatrix;
+            std::array<IndexType, d + 1> elementIndex;
+            auto tmp = c;
+            tmp.m_stiffness = 0;
+            DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, tmp);
+            accumToTensor<d + 1>(stiffnessMatrix, elementIndex, bucket);
+        }
+    }
+
 
 
  template<class Discretization, class IntType>
@@ -138,64 +178,61 @@ namespace PhysBAM {
                     if (col < row)
                         continue;
 
-                    int index = -1;
-                    for (int k = m_pardiso.rowIndex[row]; k < m_pardiso.rowIndex[row + 1]; k++) {
-                        if (m_pardiso.column[k] == col) {
-                            index = k;
-                            break;
-                        }
-                    }
-
-                    if (index == -1) {
-                        std::cerr << "cannot find the entry" << std::endl;
-                        exit(1);
-                    }
-                    else
-                        // stiffnessMatrix is negative definite
-                        m_pardiso.value[index] -= stiffnessMatrix(i + 1, j + 1);
+                    // stiffnessMatrix is negative definite
+                    m_pardiso.value[findSlot(row, col)] -= stiffnessMatrix(i + 1, j + 1);
                 }
             }
         }
     }
 
+    template<class Discretization, class IntType>
+    IntType SchurSolver<Discretization, IntType>::findSlot(const IntType row, const IntType col) const
+    {
+        // initializePardiso sorts each row's entries by column and merges duplicates, so the columns of a row are strictly increasing
+        const IntType* begin = m_pardiso.column + m_pardiso.rowIndex[row];
+        const IntType* end = m_pardiso.column + m_pardiso.rowIndex[row + 1];
+        const IntType* it = std::lower_bound(begin, end, col);
+        if (it == end || *it != col)
+            throw std::logic_error("entry (" + std::to_string(row) + " , " + std::to_string(col) + ") not found");
+        return (IntType)(it - m_pardiso.column);
+    }
+
     template<class Discretization, class IntType>
     template<int elementNodesN>
-    void SchurSolver<Discretization, IntType>::accumToPardiso(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const std::array<IndexType, elementNodesN>& elementIndex)
+    const typename SchurSolver<Discretization, IntType>::template ScatterSlots<elementNodesN>& SchurSolver<Discretization, IntType>::
+        scatterSlots(std::vector<ScatterSlots<elementNodesN>>& cache, const size_t c, const std::array<IndexType, elementNodesN>& elementIndex) const
     {
-        // need to check if repeated entry matters or not
         using IteratorType = Iterator<NodeArrayType>;
+        if (cache.size() <= c) {
+            ScatterSlots<elementNodesN> empty;
+            empty.m_elementIndex.fill(IndexType(-1));
+            cache.resize(c + 1, empty);
+        }
+        ScatterSlots<elementNodesN>& slots = cache[c];
+        if (slots.m_elementIndex == elementIndex)
+            return slots;
+
+        slots.m_elementIndex = elementIndex;
         for (int i = 0; i < elementNodesN; i++) {
-            int row = IteratorType::at(m_numbering, elementIndex[i]);
-            if (row >= 0) {
-                //IntType idx = m_pardiso.rowIndex[row];
-                for (int j = 0; j < elementNodesN; j++) {
-                    int col = IteratorType::at(m_numbering, elementIndex[j]);
-                    if (col >= row) {
-                        bool found = false; // for debugging purposes
-                        // maybe binary search here?
-                        for (IntType jj = m_pardiso.rowIndex[row]; jj < m_pardiso.rowIndex[row + 1]; jj++)
-                            if (col == m_pardiso.column[jj]) {
-                                found = true;
-                                m_pardiso.value[jj] -= stiffnessMatrix(i + 1, j + 1);
-                            }
-                        if (!found) {
-                            std::cout << stiffnessMatrix << std::endl;
-                            std::cout << "index = [ ";
-                            for (int ii = 0; ii < elementNodesN; ii++)
-                                std::cout << elementIndex[ii] << " ";
-                            std::cout << "]" << std::endl;
-                            std::cout << "row = " << row << " col = " << col << std::endl;
-                            throw std::logic_error("entry (" + std::to_string(row) + " , " + std::to_string(col) + ") not found");
-                        }
-                        // if (m_tensor[row].find(col) == m_tensor[row].end())
-                        //     m_tensor[row].insert(std::pair<int, T>(col, stiffnessMatrix(i + 1, j + 1)));
-                        // else
-                        //     m_tensor[row][col] += stiffnessMatrix(i + 1, j + 1);
-                    }
-                }
+            const int row = IteratorType::at(m_numbering, elementIndex[i]);
+            for (int j = 0; j < elementNodesN; j++) {
+                const int col = IteratorType::at(m_numbering, elementIndex[j]);
+                slots.m_slot[i * elementNodesN + j] = (row >= 0 && col >= row) ? findSlot(row, col) : IntType(-1);
             }
         }
+        return slots;
+    }
 
+    template<class Discretization, class IntType>
+    template<int elementNodesN>
+    void SchurSolver<Discretization, IntType>::scatterToPardiso(const PhysBAM::MATRIX_MXN<T>& stiffnessMatrix, const ScatterSlots<elementNodesN>& slots)
+    {
+        for (int i = 0; i < elementNodesN; i++)
+            for (int j = 0; j < elementNodesN; j++) {
+                const IntType slot = slots.m_slot[i * elementNodesN + j];
+                if (slot >= 0)
+                    m_pardiso.value[slot] -= stiffnessMatrix(i + 1, j + 1);
+            }
     }
 
 #if 1
@@ -255,71 +292,13 @@ namespace PhysBAM {
         ) {
 #if TIMING
         auto startStamp = std::chrono::steady_clock::now();
-        auto endStamp = std::chrono::steady_clock::now();
-        std::chrono::duration<double> elapsed_second;
-        double computeElTensorTime = 0;
-        double accumElTensorTime = 0;
 #endif
-
-        for (int e = 0; e < elements.size(); e++) {
-            MATRIX_MXN<T> stiffnessMatrix;
-#if TIMING
-            startStamp = std::chrono::steady_clock::now();
-#endif
-            DiscretizationType::computeElementTensor(stiffnessMatrix, gradients[e], -2 * mu * restVol[e]);
-#if TIMING
-            endStamp = std::chrono::steady_clock::now();
-            elapsed_second = endStamp - startStamp;
-            computeElTensorTime += elapsed_second.count();
-
-            startStamp = std::chrono::steady_clock::now();
-#endif
-            accumToTensor<elementNodes>(stiffnessMatrix, DiscretizationType::getElementIndex(elements[e]));
-#if TIMING
-            endStamp = std::chrono::steady_clock::now();
-            elapsed_second = endStamp - startStamp;
-            accumElTensorTime += elapsed_second.count();
-#endif
-        }
+        accumElementTensors(elements, gradients, [&](const size_t e) { return -2 * mu * restVol[e]; });
 #if TIMING
-        LOG::cout << "        computeElTensor     Time : " << computeElTensorTime << std::endl;
-        LOG::cout << "        accumElTensor       Time : " << accumElTensorTime << std::endl;
+        std::chrono::duration<double> elapsed_second = std::chrono::steady_clock::now() - startStamp;
+        LOG::cout << "        accumElTensor       Time : " << elapsed_second.count() << std::endl;
 #endif
-#if 0
-
-        for (int c = 0; c < constraints.size(); c++) {
-            MATRIX_MXN<T> stiffnessMatrix;
-            DiscretizationType::computeConstraintTensor(stiffnessMatrix, constraints[c]);
-
-            accumToTensor<elementNodes>(stiffnessMatrix,
-                constraints[c].m_elementIndex);
-        }
-#endif
-
-        for (int c = 0; c < sutures.size(); c++) {
-            MATRIX_MXN<T> stiffnessMatrix;
-            std::array<IndexType, elementNodes * 2> elementIndex;
-            Suture tmp = sutures[c];
-            tmp.m_stiffness = 0;
-            DiscretizationType::computeSutureTensor(stiffnessMatrix, elementIndex, tmp);
-            accumToTensor<elementNodes * 2>(stiffnessMatrix,
-                elementIndex);
-        }
-
-        std::cout << "About to add microNode constraints in computeTensor()\n";  // COURT debug
-
-        for (const auto& c : microNodes) {
-            MATRIX_MXN<T> stiffnessMatrix;
-            std::array<IndexType, d + 1> elementIndex;
-            auto tmp = c;
-            tmp.m_stiffness = 0;
-            DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, tmp);
-            accumToTensor_debug<d + 1>(stiffnessMatrix,
-                elementIndex);  // COURT created this routine to isolate Release only exception in accumToTensor()
-        }
-
-        std::cout << "Accumulated microNode constraints in computeTensor()\n";  // COURT debug
-
+        accumConstraintTensors(sutures, microNodes);
     }
 
     template<class Discretization, class IntType>
@@ -332,64 +311,15 @@ namespace PhysBAM {
         const std::vector<InternodeConstraint>& microNodes)
     {
         // only include things that will change the sparsity of stiffness matrix
-
 #if TIMING
         auto startStamp = std::chrono::steady_clock::now();
-        auto endStamp = std::chrono::steady_clock::now();
-        std::chrono::duration<double> elapsed_second;
-        double computeElTensorTime = 0;
-        double accumElTensorTime = 0;
 #endif
-
-        for (int e = 0; e < elements.size(); e++) {
-            MATRIX_MXN<T> stiffnessMatrix;
-
+        accumElementTensors(elements, gradients, [&](const size_t e) { return -2 * (muLow[e] + muHigh[e]) * restVol[e]; });
 #if TIMING
-            startStamp = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed_second = std::chrono::steady_clock::now() - startStamp;
+        LOG::cout << "        accumElTensor       Time : " << elapsed_second.count() << std::endl;
 #endif
-            DiscretizationType::computeElementTensor(stiffnessMatrix, gradients[e], -2 * (muLow[e] + muHigh[e]) * restVol[e]); // computeElementTensor
-#if TIMING
-            endStamp = std::chrono::steady_clock::now();
-            elapsed_second = endStamp - startStamp;
-            computeElTensorTime += elapsed_second.count();
-
-            startStamp = std::chrono::steady_clock::now();
-#endif
-            accumToTensor<elementNodes>(stiffnessMatrix, DiscretizationType::getElementIndex(elements[e])); // accumToTensor
-
-#if TIMING
-            endStamp = std::chrono::steady_clock::now();
-            elapsed_second = endStamp - startStamp;
-            accumElTensorTime += elapsed_second.count();
-#endif
-        }
-
-#if TIMING
-        LOG::cout << "        computeElTensor     Time : " << computeElTensorTime << std::endl;
-        LOG::cout << "        accumElTensor       Time : " << accumElTensorTime << std::endl;
-#endif
-
-        // It seems that I don't actually need to compute the matrix here, just need the sparsity
-        for (int c = 0; c < sutures.size(); c++) {
-            MATRIX_MXN<T> stiffnessMatrix;
-            std::array<IndexType, elementNodes * 2> elementIndex;
-            Suture tmp = sutures[c];
-            tmp.m_stiffness = 0;
-            DiscretizationType::computeSutureTensor(stiffnessMatrix, elementIndex, tmp);
-            accumToTensor<elementNodes * 2>(stiffnessMatrix,
-                elementIndex);
-        }
-
-        for (const auto& c:microNodes) {
-            MATRIX_MXN<T> stiffnessMatrix;
-            std::array<IndexType, d+1> elementIndex;
-            auto tmp = c;
-            tmp.m_stiffness = 0;
-            DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, tmp);
-            accumToTensor_debug<d+1>(stiffnessMatrix,
-                elementIndex);
-        }
-
+        accumConstraintTensors(sutures, microNodes);
     }
 
 
@@ -401,26 +331,91 @@ namespace PhysBAM {
         const std::vector<InternodeConstraint>& microNodes
     ) {
 
-        IntType nnz = 0;
-        for (int i = 0; i < m_tensor.size(); i++)
-            nnz += (IntType)m_tensor[i].size();
+        // Counting sort of the tensor entries by row, then per row an insertion sort by column (stable, so
+        // duplicates are summed in element order) and the merge. Buckets are independent once their offsets
+        // within each row are known, and so are rows, so every pass but the prefix sums runs in parallel.
+        const IntType n = m_tensorRows;
+        const int buckets = (int)m_tensor.size();
+        std::vector<IntType> bucketOffset((size_t)buckets * n, 0);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (int b = 0; b < buckets; b++)
+            for (const auto& entry : m_tensor[b])
+                bucketOffset[(size_t)b * n + entry.m_row]++;
 
-        LOG::cout << "nnz = " << nnz << std::endl;
-        m_pardiso.initialize((IntType)m_tensor.size(), nnz, schurSize);
+        std::vector<IntType> rowStart(n + 1, 0);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (IntType row = 0; row < n; row++) {
+            IntType count = 0;
+            for (int b = 0; b < buckets; b++) {
+                const IntType bucketCount = bucketOffset[(size_t)b * n + row];
+                bucketOffset[(size_t)b * n + row] = count;
+                count += bucketCount;
+            }
+            rowStart[row + 1] = count;
+        }
+        for (IntType row = 0; row < n; row++)
+            rowStart[row + 1] += rowStart[row];
 
-        m_pardiso.rowIndex[0] = 0;
-        for (int i = 0; i < m_pardiso.n; i++)
-            m_pardiso.rowIndex[i + 1] = m_pardiso.rowIndex[i] + (IntType)m_tensor[i].size();
+        std::vector<std::pair<IntType, T>> entries(rowStart[n]);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (int b = 0; b < buckets; b++)
+            for (const auto& entry : m_tensor[b])
+                entries[rowStart[entry.m_row] + bucketOffset[(size_t)b * n + entry.m_row]++] = { entry.m_col, entry.m_value };
+        std::vector<std::vector<TensorEntry>>().swap(m_tensor);
+        std::vector<IntType>().swap(bucketOffset);
+
+        std::vector<IntType> rowNnz(n + 1, 0);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (IntType row = 0; row < n; row++) {
+            const IntType begin = rowStart[row], end = rowStart[row + 1];
+            for (IntType k = begin + 1; k < end; k++) {
+                const auto entry = entries[k];
+                IntType l = k;
+                for (; l > begin && entries[l - 1].first > entry.first; l--)
+                    entries[l] = entries[l - 1];
+                entries[l] = entry;
+            }
+            IntType last = begin;
+            for (IntType k = begin + 1; k < end; k++)
+                if (entries[k].first == entries[last].first)
+                    entries[last].second += entries[k].second;
+                else
+                    entries[++last] = entries[k];
+            rowNnz[row + 1] = end > begin ? last - begin + 1 : 0;
+        }
+        for (IntType row = 0; row < n; row++)
+            rowNnz[row + 1] += rowNnz[row];
+        const IntType nnz = rowNnz[n];
 
-        // const IntType& n = m_pardiso.n;
+        LOG::cout << "nnz = " << nnz << std::endl;
+        m_pardiso.initialize(n, nnz, schurSize);
+        m_baseValue.resize(nnz);
 
-        size_t idx = 0;
-        for (const auto& r : m_tensor)
-            for (const auto& e : r) {
-                m_pardiso.column[idx] = e.first;
-                //m_pardiso.value[idx] = -e.second;
-                idx++;
+        m_pardiso.rowIndex[n] = nnz;
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (IntType row = 0; row < n; row++) {
+            m_pardiso.rowIndex[row] = rowNnz[row];
+            for (IntType k = rowNnz[row]; k < rowNnz[row + 1]; k++) {
+                const auto& entry = entries[rowStart[row] + k - rowNnz[row]];
+                m_pardiso.column[k] = entry.first;
+                m_baseValue[k] = -entry.second;
             }
+        }
+        // the pattern now lives in the CSR arrays; constraint edits only touch values from here on
+        m_constraintSlots.clear();
+        m_fakeSutureSlots.clear();
+        m_sutureSlots.clear();
+        m_microNodeSlots.clear();
 
         if (schurSize)
             m_pardiso.schur = m_schur;
@@ -440,28 +435,23 @@ namespace PhysBAM {
     template<class Discretization, class IntType>
     void SchurSolver<Discretization, IntType>::factPardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
     {
-        size_t idx = 0;
-        for (const auto& r : m_tensor)
-            for (const auto& e : r) {
-                m_pardiso.value[idx] = -e.second;
-                idx++;
-            }
+        std::copy(m_baseValue.begin(), m_baseValue.end(), m_pardiso.value);
         // dumper::writeCSRbyte(m_pardiso.n, m_pardiso.rowIndex, m_pardiso.column, m_pardiso.value, m_pardiso.n, "orig_i.txt", "orig_a.txt");
 
         for (int c = 0; c < constraints.size(); c++)
             if (constraints[c].m_stiffness != 0) {
                 MATRIX_MXN<T> stiffnessMatrix;
                 DiscretizationType::computeConstraintTensor(stiffnessMatrix, constraints[c]);
-                accumToPardiso<elementNodes>(stiffnessMatrix,
-                    constraints[c].m_elementIndex);
+                scatterToPardiso<elementNodes>(stiffnessMatrix,
+                    scatterSlots<elementNodes>(m_constraintSlots, c, constraints[c].m_elementIndex));
             }
 
         for (int c = 0; c < fakeSutures.size(); c++)
             if (fakeSutures[c].m_stiffness != 0) {
                 MATRIX_MXN<T> stiffnessMatrix;
                 DiscretizationType::computeConstraintTensor(stiffnessMatrix, fakeSutures[c]);
-                accumToPardiso<elementNodes>(stiffnessMatrix,
-                    fakeSutures[c].m_elementIndex);
+                scatterToPardiso<elementNodes>(stiffnessMatrix,
+                    scatterSlots<elementNodes>(m_fakeSutureSlots, c, fakeSutures[c].m_elementIndex));
             }
 
         for (int c = 0; c < sutures.size(); c++)
@@ -469,22 +459,28 @@ namespace PhysBAM {
                 MATRIX_MXN<T> stiffnessMatrix;
                 std::array<IndexType, elementNodes * 2> elementIndex;
                 DiscretizationType::computeSutureTensor(stiffnessMatrix, elementIndex, sutures[c]);
-                accumToPardiso<elementNodes * 2>(stiffnessMatrix,
-                    elementIndex);
+                scatterToPardiso<elementNodes * 2>(stiffnessMatrix,
+                    scatterSlots<elementNodes * 2>(m_sutureSlots, c, elementIndex));
             }
 #if 1
-        for (const auto& c:microNodes)
-            if (c.m_stiffness != 0) {
+        for (int c = 0; c < microNodes.size(); c++)
+            if (microNodes[c].m_stiffness != 0) {
                 MATRIX_MXN<T> stiffnessMatrix;
                 std::array<IndexType, d+1> elementIndex;
-                DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, c);
-                accumToPardiso<d+1>(stiffnessMatrix,
-                    elementIndex);
+                DiscretizationType::computeMicroNodeTensor(stiffnessMatrix, elementIndex, microNodes[c]);
+                scatterToPardiso<d+1>(stiffnessMatrix,
+                    scatterSlots<d+1>(m_microNodeSlots, c, elementIndex));
             }
 #endif
         // dumper::writeCSRbyte(m_pardiso.n, m_pardiso.rowIndex, m_pardiso.column, m_pardiso.value, m_pardiso.n, "new_i.txt", "new_a.txt");
 
         m_pardiso.numericFact();
+
+        m_factoredConstraints = constraints;
+        m_factoredFakeSutures = fakeSutures;
+        m_factoredSutures = sutures;
+        m_factoredMicroNodes = microNodes;
+        m_lowRankTerms.clear();
         /*
         if (schurSize) {
             for (IntType i = 0; i < schurSize * schurSize; i++)
@@ -493,6 +489,123 @@ namespace PhysBAM {
         */
     }
 
+
+    template<class Discretization, class IntType>
+    void SchurSolver<Discretization, IntType>::reInitializePardiso(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        if (updateLowRank(constraints, sutures, fakeSutures, microNodes))
+            return;
+
+        factPardiso(constraints, sutures, fakeSutures, microNodes);
+        if (schurSize) {
+            for (IntType i = 0; i < schurSize * schurSize; i++)
+                m_originalValue[i] = m_pardiso.schur[i];
+            m_pardiso.factSchur();
+        }
+    }
+
+    template<class Discretization, class IntType>
+    bool SchurSolver<Discretization, IntType>::updateLowRank(const std::vector<Constraint>& constraints, const std::vector<Suture>& sutures, const std::vector<Constraint>& fakeSutures, const std::vector<InternodeConstraint>& microNodes)
+    {
+        // Every hook, suture and micro-node tensor is k * w * w^T, so the difference to what is factored
+        // is one rank-1 term per constraint removed and one per constraint added (see tensorVector()).
+        using IteratorType = Iterator<NodeArrayType>;
+        if (schurSize || m_lowRankBudget <= 0)
+            return false;
+
+        std::vector<LowRankTerm> terms;
+        bool overBudget = false;
+        auto addTerm = [&](const IndexType* nodes, const T* weights, const int count, const T coefficient) {
+            if (coefficient == 0 || overBudget)
+                return;
+            if ((int)terms.size() == m_lowRankBudget) {
+                overBudget = true;
+                return;
+            }
+            LowRankTerm term;
+            term.m_coefficient = coefficient;
+            for (int i = 0; i < count; i++) {
+                const int row = IteratorType::at(m_numbering, nodes[i]);
+                if (row >= 0) {
+                    term.m_rows.push_back(row);
+                    term.m_u.push_back(weights[i]);
+                }
+            }
+            terms.push_back(std::move(term));
+        };
+        auto addConstraintTerm = [&](const auto& c, const int sign) {
+            std::array<IndexType, elementNodes * 2> nodes;
+            std::array<T, elementNodes * 2> weights;
+            const int count = tensorVector(c, nodes.data(), weights.data());
+            addTerm(nodes.data(), weights.data(), count, sign * c.m_stiffness);
+        };
+        diffConstraintTensors(constraints, m_factoredConstraints, addConstraintTerm);
+        diffConstraintTensors(fakeSutures, m_factoredFakeSutures, addConstraintTerm);
+        diffConstraintTensors(sutures, m_factoredSutures, addConstraintTerm);
+        diffConstraintTensors(microNodes, m_factoredMicroNodes, addConstraintTerm);
+        if (overBudget)
+            return false;
+
+        // keep A^{-1} u of terms that are still pending, solve with the existing factor for new ones
+        const IntType n = m_pardiso.n;
+        std::vector<T> rhs, tmp;
+        for (auto& term : terms) {
+            for (auto& previous : m_lowRankTerms)
+                if (previous.m_z.size() && previous.m_coefficient == term.m_coefficient && previous.m_rows == term.m_rows && previous.m_u == term.m_u) {
+                    term.m_z.swap(previous.m_z);
+                    break;
+                }
+            if (term.m_z.size())
+                continue;
+            rhs.assign(n, T(0));
+            tmp.resize(n);
+            for (size_t k = 0; k < term.m_rows.size(); k++)
+                rhs[term.m_rows[k]] += term.m_u[k];
+            m_pardiso.forwardSubstitution(rhs.data(), tmp.data());
+            m_pardiso.diagSolve(tmp.data(), rhs.data());
+            m_pardiso.backwardSubstitution(rhs.data(), tmp.data());
+            term.m_z.swap(tmp);
+        }
+
+        const int r = (int)terms.size();
+        if (r) {
+            MATRIX_MXN<double> capacitance(r, r);
+            for (int i = 0; i < r; i++)
+                for (int j = 0; j < r; j++) {
+                    double uz = 0;
+                    for (size_t k = 0; k < terms[i].m_rows.size(); k++)
+                        uz += (double)terms[i].m_u[k] * terms[j].m_z[terms[i].m_rows[k]];
+                    capacitance(i + 1, j + 1) = uz + (i == j ? 1. / terms[i].m_coefficient : 0.);
+                }
+            capacitance.In_Place_PLU_Factorization(m_capacitanceL, m_capacitancePermutation);
+            for (int i = 1; i <= r; i++)
+                if (!std::isfinite(capacitance(i, i)) || std::abs(capacitance(i, i)) < 1e-12)
+                    return false; // the update is (numerically) singular; let the full factorization deal with it
+            m_capacitanceU = capacitance;
+        }
+        m_lowRankTerms.swap(terms);
+        return true;
+    }
+
+    template<class Discretization, class IntType>
+    void SchurSolver<Discretization, IntType>::applyLowRankCorrection(T* const x) const
+    {
+        // x = A^{-1} b - Z (C^{-1} + U^T Z)^{-1} U^T A^{-1} b, with x coming in as A^{-1} b
+        const int r = (int)m_lowRankTerms.size();
+        VECTOR_ND<double> y(r);
+        for (int j = 0; j < r; j++) {
+            const LowRankTerm& term = m_lowRankTerms[j];
+            for (size_t k = 0; k < term.m_rows.size(); k++)
+                y(j + 1) += (double)term.m_u[k] * x[term.m_rows[k]];
+        }
+        const VECTOR_ND<double> t = m_capacitanceU.Upper_Triangular_Solve(m_capacitanceL.Lower_Triangular_Solve(y.Permute(m_capacitancePermutation)));
+        for (int j = 0; j < r; j++) {
+            const T coefficient = (T)t(j + 1);
+            const T* const z = m_lowRankTerms[j].m_z.data();
+            for (IntType i = 0; i < m_pardiso.n; i++)
+                x[i] -= coefficient * z[i];
+        }
+    }
 }
 
 namespace PhysBAM {
@@ -0,0 +1,344 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+
+#include "SparseSPDSolver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#ifdef USE_CHOLMOD
+#include <cholmod.h>
+#endif
+#ifdef USE_EIGEN_SPARSE
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#endif
+
+#ifdef USE_CHOLMOD
+// Integer width selects between the cholmod_ and cholmod_l_ entry points.
+template <class IntType> struct CholmodOps;
+
+template <> struct CholmodOps<int> {
+    static constexpr int itype = CHOLMOD_INT;
+    static int start(cholmod_common* common) { return cholmod_start(common); }
+    static int finish(cholmod_common* common) { return cholmod_finish(common); }
+    static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* common) { return cholmod_analyze(A, common); }
+    static cholmod_factor* analyze_p(cholmod_sparse* A, int* order, cholmod_common* common) { return cholmod_analyze_p(A, order, nullptr, 0, common); }
+    static int factorize(cholmod_sparse* A, cholmod_factor* L, cholmod_common* common) { return cholmod_factorize(A, L, common); }
+    static int solve(const int sys, cholmod_factor* L, cholmod_dense* B, cholmod_dense** X, cholmod_dense** Y, cholmod_dense** E, cholmod_common* common) {
+        return cholmod_solve2(sys, L, B, nullptr, X, nullptr, Y, E, common);
+    }
+    static int free_factor(cholmod_factor** L, cholmod_common* common) { return cholmod_free_factor(L, common); }
+    static int free_dense(cholmod_dense** X, cholmod_common* common) { return cholmod_free_dense(X, common); }
+};
+
+template <> struct CholmodOps<long long int> {
+    static constexpr int itype = CHOLMOD_LONG;
+    static int start(cholmod_common* common) { return cholmod_l_start(common); }
+    static int finish(cholmod_common* common) { return cholmod_l_finish(common); }
+    static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* common) { return cholmod_l_analyze(A, common); }
+    static cholmod_factor* analyze_p(cholmod_sparse* A, long long int* order, cholmod_common* common) {
+        return cholmod_l_analyze_p(A, reinterpret_cast<SuiteSparse_long*>(order), nullptr, 0, common);
+    }
+    static int factorize(cholmod_sparse* A, cholmod_factor* L, cholmod_common* common) { return cholmod_l_factorize(A, L, common); }
+    static int solve(const int sys, cholmod_factor* L, cholmod_dense* B, cholmod_dense** X, cholmod_dense** Y, cholmod_dense** E, cholmod_common* common) {
+        return cholmod_l_solve2(sys, L, B, nullptr, X, nullptr, Y, E, common);
+    }
+    static int free_factor(cholmod_factor** L, cholmod_common* common) { return cholmod_l_free_factor(L, common); }
+    static int free_dense(cholmod_dense** X, cholmod_common* common) { return cholmod_l_free_dense(X, common); }
+};
+
+// Supernodal LL^T, so D = I and diagSolve() is a copy. The CSR arrays are wrapped, not copied; the factor
+// is kept in double, and for float only the values and right hand sides go through buffers that live as
+// long as the solver. Permutation is applied here rather than through CHOLMOD_P/CHOLMOD_Pt so that each
+// substitution is one cholmod_solve2() call, which reuses its outputs instead of allocating.
+template <class T, class IntType> struct CholmodSolver : SparseSPDSolver<T, IntType> {
+    using Ops = CholmodOps<IntType>;
+
+    cholmod_common m_common;
+    cholmod_sparse m_matrix{};
+    cholmod_factor* m_factor = nullptr;
+    cholmod_dense* m_X = nullptr;
+    cholmod_dense* m_Y = nullptr;
+    cholmod_dense* m_E = nullptr;
+    std::vector<double> m_value; // float only
+    std::vector<double> m_buffer;
+    IntType m_n = 0;
+
+    CholmodSolver() {
+        Ops::start(&m_common);
+        m_common.supernodal = CHOLMOD_SUPERNODAL;
+        m_common.print = 0;
+    }
+
+    ~CholmodSolver() override {
+        Ops::free_dense(&m_X, &m_common);
+        Ops::free_dense(&m_Y, &m_common);
+        Ops::free_dense(&m_E, &m_common);
+        Ops::free_factor(&m_factor, &m_common);
+        Ops::finish(&m_common);
+    }
+
+    bool analyze(const IntType n, const IntType* rowIndex, const IntType* column, const IntType* order) override {
+        m_n = n;
+        m_matrix.nrow = m_matrix.ncol = (size_t)n;
+        m_matrix.nzmax = (size_t)rowIndex[n];
+        m_matrix.p = const_cast<IntType*>(rowIndex);
+        m_matrix.i = const_cast<IntType*>(column);
+        m_matrix.nz = nullptr;
+        m_matrix.x = m_matrix.z = nullptr;
+        m_matrix.stype = -1;
+        m_matrix.itype = Ops::itype;
+        m_matrix.xtype = CHOLMOD_PATTERN;
+        m_matrix.dtype = CHOLMOD_DOUBLE;
+        m_matrix.sorted = 1;
+        m_matrix.packed = 1;
+
+        Ops::free_factor(&m_factor, &m_common);
+        if (order) {
+            // only the given ordering; by default CHOLMOD would also try AMD and keep the better one
+            const int nmethods = m_common.nmethods, method = m_common.method[0].ordering;
+            m_common.nmethods = 1;
+            m_common.method[0].ordering = CHOLMOD_GIVEN;
+            m_factor = Ops::analyze_p(&m_matrix, const_cast<IntType*>(order), &m_common);
+            m_common.nmethods = nmethods;
+            m_common.method[0].ordering = method;
+        }
+        else
+            m_factor = Ops::analyze(&m_matrix, &m_common);
+        if (!std::is_same<T, double>::value)
+            m_value.resize(m_matrix.nzmax);
+        return m_factor != nullptr && m_common.status == CHOLMOD_OK;
+    }
+
+    void ordering(IntType* order) const override {
+        const IntType* perm = static_cast<const IntType*>(m_factor->Perm);
+        std::copy(perm, perm + m_n, order);
+    }
+
+    bool factorize(const T* value) override {
+        if (!m_factor)
+            return false;
+        if (std::is_same<T, double>::value)
+            m_matrix.x = const_cast<T*>(value);
+        else {
+            std::copy(value, value + m_matrix.nzmax, m_value.begin());
+            m_matrix.x = m_value.data();
+        }
+        m_matrix.xtype = CHOLMOD_REAL;
+        Ops::factorize(&m_matrix, m_factor, &m_common);
+        return m_common.status == CHOLMOD_OK;
+    }
+
+    // runs sys on the columns in m_buffer, leaving the result in m_X
+    bool substitute(const int sys, const IntType nrhs) {
+        cholmod_dense B{};
+        B.nrow = (size_t)m_n;
+        B.ncol = (size_t)nrhs;
+        B.nzmax = (size_t)m_n * (size_t)nrhs;
+        B.d = (size_t)m_n;
+        B.x = m_buffer.data();
+        B.xtype = CHOLMOD_REAL;
+        B.dtype = CHOLMOD_DOUBLE;
+        return Ops::solve(sys, m_factor, &B, &m_X, &m_Y, &m_E, &m_common) && m_common.status == CHOLMOD_OK;
+    }
+
+    bool forwardSubstitution(const T* rhs, T* x, const IntType nrhs) override {
+        const IntType* perm = static_cast<const IntType*>(m_factor->Perm);
+        m_buffer.resize((size_t)m_n * nrhs);
+        for (IntType c = 0; c < nrhs; c++)
+            for (IntType k = 0; k < m_n; k++)
+                m_buffer[c * m_n + k] = rhs[c * m_n + perm[k]];
+        if (!substitute(CHOLMOD_L, nrhs))
+            return false;
+        const double* y = static_cast<const double*>(m_X->x);
+        std::copy(y, y + (size_t)m_n * nrhs, x);
+        return true;
+    }
+
+    bool diagSolve(const T* rhs, T* x, const IntType nrhs) override {
+        std::copy(rhs, rhs + (size_t)m_n * nrhs, x);
+        return true;
+    }
+
+    bool backwardSubstitution(const T* rhs, T* x, const IntType nrhs) override {
+        const IntType* perm = static_cast<const IntType*>(m_factor->Perm);
+        m_buffer.assign(rhs, rhs + (size_t)m_n * nrhs);
+        if (!substitute(CHOLMOD_Lt, nrhs))
+            return false;
+        const double* y = static_cast<const double*>(m_X->x);
+        for (IntType c = 0; c < nrhs; c++)
+            for (IntType k = 0; k < m_n; k++)
+                x[c * m_n + perm[k]] = (T)y[c * m_n + k];
+        return true;
+    }
+};
+#endif // USE_CHOLMOD
+
+#ifdef USE_EIGEN_SPARSE
+// SimplicialLDLT that can also be handed its ordering. Eigen constructs the ordering functor itself, so
+// this goes around it the way SimplicialCholeskyBase::ordering() does after running AMD.
+template <class MatrixType> struct GivenOrderingLDLT : Eigen::SimplicialLDLT<MatrixType, Eigen::Lower, Eigen::AMDOrdering<typename MatrixType::StorageIndex>> {
+    using Base = Eigen::SimplicialLDLT<MatrixType, Eigen::Lower, Eigen::AMDOrdering<typename MatrixType::StorageIndex>>;
+
+    void analyzePattern(const MatrixType& a, const typename MatrixType::StorageIndex* order) {
+        const Eigen::Index size = a.rows();
+        this->m_Pinv.resize(size);
+        std::copy(order, order + size, this->m_Pinv.indices().data());
+        this->m_P = this->m_Pinv.inverse();
+        typename Base::CholMatrixType ap(size, size);
+        ap.template selfadjointView<Eigen::Upper>() = a.template selfadjointView<Eigen::Lower>().twistedBy(this->m_P);
+        this->analyzePattern_preordered(ap, true);
+    }
+    using Base::analyzePattern;
+};
+
+// SimplicialLDLT in the precision of T. m_matrix keeps the pattern from analyze() and only has its
+// values overwritten by factorize(), so the ordering and elimination tree are computed once.
+template <class T, class IntType> struct EigenLDLTSolver : SparseSPDSolver<T, IntType> {
+    using MatrixType = Eigen::SparseMatrix<T, Eigen::ColMajor, IntType>;
+    using BlockType = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    MatrixType m_matrix;
+    GivenOrderingLDLT<MatrixType> m_ldlt;
+    bool m_analyzed = false;
+
+    bool analyze(const IntType n, const IntType* rowIndex, const IntType* column, const IntType* order) override {
+        const IntType nnz = rowIndex[n];
+        m_matrix.resize(n, n);
+        m_matrix.resizeNonZeros(nnz);
+        std::copy(rowIndex, rowIndex + n + 1, m_matrix.outerIndexPtr());
+        std::copy(column, column + nnz, m_matrix.innerIndexPtr());
+        std::fill(m_matrix.valuePtr(), m_matrix.valuePtr() + nnz, T(0));
+        if (order)
+            m_ldlt.analyzePattern(m_matrix, order);
+        else
+            m_ldlt.analyzePattern(m_matrix);
+        m_analyzed = m_ldlt.info() == Eigen::Success;
+        return m_analyzed;
+    }
+
+    void ordering(IntType* order) const override {
+        const auto& indices = m_ldlt.permutationPinv().indices();
+        std::copy(indices.data(), indices.data() + indices.size(), order);
+    }
+
+    bool factorize(const T* value) override {
+        if (!m_analyzed)
+            return false;
+        std::copy(value, value + m_matrix.nonZeros(), m_matrix.valuePtr());
+        m_ldlt.factorize(m_matrix);
+        return m_ldlt.info() == Eigen::Success;
+    }
+
+    bool forwardSubstitution(const T* rhs, T* x, const IntType nrhs) override {
+        const IntType n = (IntType)m_matrix.rows();
+        Eigen::Map<BlockType> X(x, n, nrhs);
+        X = m_ldlt.permutationP() * Eigen::Map<const BlockType>(rhs, n, nrhs);
+        m_ldlt.matrixL().solveInPlace(X);
+        return true;
+    }
+
+    bool diagSolve(const T* rhs, T* x, const IntType nrhs) override {
+        const IntType n = (IntType)m_matrix.rows();
+        Eigen::Map<BlockType>(x, n, nrhs) = m_ldlt.vectorD().asDiagonal().inverse() * Eigen::Map<const BlockType>(rhs, n, nrhs);
+        return true;
+    }
+
+    bool backwardSubstitution(const T* rhs, T* x, const IntType nrhs) override {
+        const IntType n = (IntType)m_matrix.rows();
+        Eigen::Map<BlockType> X(x, n, nrhs);
+        X = Eigen::Map<const BlockType>(rhs, n, nrhs);
+        m_ldlt.matrixU().solveInPlace(X);
+        X = m_ldlt.permutationPinv() * X;
+        return true;
+    }
+};
+#endif // USE_EIGEN_SPARSE
+
+const char* sparseSPDBackendName(const SparseSPDBackend backend) {
+    switch (backend) {
+    case SparseSPDBackend::Pardiso: return "Pardiso";
+    case SparseSPDBackend::Cholmod: return "CHOLMOD";
+    case SparseSPDBackend::EigenLDLT: return "Eigen SimplicialLDLT";
+    }
+    return "unknown";
+}
+
+bool sparseSPDBackendAvailable(const SparseSPDBackend backend) {
+    switch (backend) {
+    case SparseSPDBackend::Pardiso:
+#ifdef __APPLE__
+        return false;
+#else
+        return true;
+#endif
+    case SparseSPDBackend::Cholmod:
+#ifdef USE_CHOLMOD
+        return true;
+#else
+        return false;
+#endif
+    case SparseSPDBackend::EigenLDLT:
+#ifdef USE_EIGEN_SPARSE
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+static SparseSPDBackend initialSparseSPDBackend() {
+    if (const char* name = std::getenv("PDTET_SPARSE_SOLVER")) {
+        const struct { const char* name; SparseSPDBackend backend; } names[] = {
+            { "pardiso", SparseSPDBackend::Pardiso }, { "cholmod", SparseSPDBackend::Cholmod }, { "eigen", SparseSPDBackend::EigenLDLT }
+        };
+        for (const auto& entry : names)
+            if (!std::strcmp(name, entry.name) && sparseSPDBackendAvailable(entry.backend))
+                return entry.backend;
+    }
+    for (const SparseSPDBackend backend : { SparseSPDBackend::Pardiso, SparseSPDBackend::Cholmod, SparseSPDBackend::EigenLDLT })
+        if (sparseSPDBackendAvailable(backend))
+            return backend;
+    return SparseSPDBackend::Pardiso;
+}
+
+static std::atomic<int>& sparseSPDBackendSetting() {
+    static std::atomic<int> backend{ int(initialSparseSPDBackend()) };
+    return backend;
+}
+
+SparseSPDBackend defaultSparseSPDBackend() {
+    return SparseSPDBackend(sparseSPDBackendSetting().load(std::memory_order_relaxed));
+}
+
+bool setDefaultSparseSPDBackend(const SparseSPDBackend backend) {
+    if (!sparseSPDBackendAvailable(backend))
+        return false;
+    sparseSPDBackendSetting().store(int(backend), std::memory_order_relaxed);
+    return true;
+}
+
+template <class T, class IntType> SparseSPDSolver<T, IntType>* createSparseSPDSolver(const SparseSPDBackend backend) {
+    switch (backend) {
+#ifdef USE_CHOLMOD
+    case SparseSPDBackend::Cholmod: return new CholmodSolver<T, IntType>();
+#endif
+#ifdef USE_EIGEN_SPARSE
+    case SparseSPDBackend::EigenLDLT: return new EigenLDLTSolver<T, IntType>();
+#endif
+    default: return nullptr;
+    }
+}
+
+template SparseSPDSolver<double, int>* createSparseSPDSolver<double, int>(const SparseSPDBackend);
+template SparseSPDSolver<float, int>* createSparseSPDSolver<float, int>(const SparseSPDBackend);
+template SparseSPDSolver<double, long long int>* createSparseSPDSolver<double, long long int>(const SparseSPDBackend);
+template SparseSPDSolver<float, long long int>* createSparseSPDSolver<float, long long int>(const SparseSPDBackend);
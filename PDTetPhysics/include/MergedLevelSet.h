@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 
 #include "PhysBAM_Tools/Vectors/VECTOR.h"
 
@@ -17,19 +18,52 @@ namespace PhysBAM {
 		static constexpr int d = VectorType::m;
 		std::vector<PhysBAM::LEVELSET_IMPLICIT_OBJECT<VectorType>*>m_levelSet;
 		T gridDX = T(1);
+
+		// Flat copy of a level set's grid and phi array, so batched queries interpolate without PhysBAM's per point virtual calls.
+		struct QueryGrid {
+			T minCorner[d], maxCorner[d], dX[d], oneOverDX[d];
+			int minIndex[d], maxIndex[d];  // phi domain indices, inclusive
+			int stride[d];
+			const T* phi;
+		};
+		std::vector<QueryGrid> m_queryGrids;  // parallel to m_levelSet
+
 	public:
+		static constexpr int queryBlockWidth = 16;  // points interpolated together by the batched queries
+
 		T Extended_Phi(const VectorType& pos) const;
 		VectorType Extended_Normal(const VectorType& pos) const;
 
+		// Batched Extended_Phi of n points given as structure of arrays, x[v][i] being coordinate v of point i. Where
+		// phi[i] < normalThreshold, normal[v][i] is set to Extended_Normal of the point as well. Points are processed in
+		// blocks of queryBlockWidth, and a level set is skipped for a block when its grid box is farther from every point
+		// than the closest level set found so far, so results are the same as the per point calls.
+		void Extended_Phi_And_Normal(const int n, const T* const x[d], T* phi, T* const normal[d], const T normalThreshold) const;
+
 		void initializeLevelSet(std::vector<std::string>& paths, const T dx = .025) {
 			gridDX = dx;
 			for (const auto& s : paths) addLevelSet(s);
 		}
 
+		// Computes the level set of an OBJ collision proxy and writes its .sdf cache without loading it.
+		// For precomputing caches offline; false if the cache couldn't be written.
+		static bool precomputeLevelSet(const std::string& collisionObjPath, const T dx);
+
 		~MergedLevelSet();
 
 	private:
 		void addLevelSet(const std::string& collisionObjPath);
+		void addQueryGrid(const LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet);
+		void queryBlock(const QueryGrid& grid, const T (&x)[d][queryBlockWidth], T (&phi)[queryBlockWidth]) const;
+
+		// The signed distance grid of each proxy is cached in a binary file next to its OBJ with the extension
+		// replaced by .sdf. The cache is keyed on a hash of the OBJ file and dx, and is recomputed and
+		// rewritten whenever either differs.
+		static std::string cachePath(const std::string& collisionObjPath);
+		static uint64_t meshHash(const std::string& collisionObjPath);
+		static bool readCache(const std::string& path, const uint64_t hash, const T dx, LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet);
+		static bool writeCache(const std::string& path, const uint64_t hash, const T dx, const LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet);
+		static void computeLevelSet(const std::string& collisionObjPath, const T dx, LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet);
 	};
 }
 
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
 #include "GridDeformerTet.h"
 #ifdef USE_CUDA
 #include "CudaSolver.h"
+#else
+#include "CollisionSchurSolver.h"
 #endif
 #include "SchurSolver.h"
+#include "IterationPolicy.h"
 #include "MergedLevelSet.h"
 
 namespace PhysBAM {
@@ -36,11 +40,12 @@ private:
 #ifdef USE_CUDA
 	PhysBAM::CudaSolver<DiscretizationType, IntType> m_solver_c; // use this when there are collision nodes
 #else
-	PhysBAM::SchurSolver<DiscretizationType, IntType> m_solver_c;
+	PhysBAM::CollisionSchurSolver<DiscretizationType, IntType> m_solver_c;
 #endif
 	// PhysBAM::LEVELSET_IMPLICIT_OBJECT<VectorType>* m_softLevelSet;
 	PhysBAM::MergedLevelSet<VectorType>* m_levelSet;
 	std::vector<std::string> m_levelSetPaths;
+	std::vector<T> m_collisionQuery; // scratch for the batched level set query in updateCollisionConstraints()
 
 	bool hasCollision = false;
 
@@ -48,6 +53,14 @@ private:
 	std::vector<std::vector<int>> invalidEmbedding;
 	std::vector<std::vector<float>> invalidWeights;
 
+	PhysBAM::TelemetryRing<PhysBAM::SolveStats<T>, 256> m_telemetry; // one record per solve() at telemetry level Stats
+	PhysBAM::FactorizationStats m_factorStats; // accumulated at telemetry level Stats
+	std::uint64_t m_solveCount = 0;
+
+	PhysBAM::IterationPolicy<T, d> m_iterationPolicy;
+
+	int clampInvalidPositions(const char* when);
+
 public:
 
 	inline T* getPositionPtr() {
@@ -103,32 +116,38 @@ public:
 	int addConstraint(const int (&index)[d+1], const T(&barycentricWeight)[d], const T(&hookPosition)[d], const T stiffness, const T limit = std::numeric_limits<T>::max());  // returns constraint index
 
 	inline void moveConstraint(const int hookHandle, const T(&newPosition)[d]) {
+		auto* constraint = m_gridDeformer.constraint(hookHandle);
+		if (!constraint)  // already deleted
+			return;
 		for (int v = 0; v < d; v++)
-			m_gridDeformer.m_constraints[hookHandle].m_xT(v + 1) = newPosition[v];
+			constraint->m_xT(v + 1) = newPosition[v];
+		m_iterationPolicy.restart();
 	}
 
 	inline void deleteConstraint(const int hookHandle) {
-		m_gridDeformer.m_constraints[hookHandle].m_stiffness = 0;
+		if (m_gridDeformer.deleteConstraint(hookHandle))
+			m_iterationPolicy.restart();
 	}
 
 	int addSuture(const int (&tets)[2], const T (&barycentricWeights)[2][d], const T stiffness);  // returns constraint index
 
 	void deleteSuture(const int sutureHandle) {
-		if (sutureHandle < m_gridDeformer.m_sutures.size())
-		{
-			m_gridDeformer.m_sutures[sutureHandle].m_stiffness = 0;
-		}
-		else {
-			const size_t fakeSutureHandle = sutureHandle - m_gridDeformer.m_sutures.size();
-			m_gridDeformer.m_fakeSutures[fakeSutureHandle * 2].m_stiffness = 0;
-			m_gridDeformer.m_fakeSutures[fakeSutureHandle * 2 + 1].m_stiffness = 0;
-		}
+		if (m_gridDeformer.deleteSuture(sutureHandle))
+			m_iterationPolicy.restart();
 	}
 
 	void initializeSolver();  // After constraints have changed computes ATA and does its LDLT()
 
 	void reInitializeSolver();  
 
+	// Hook/suture edits up to this many rank-1 terms are applied on top of the existing factor; 0 always refactorizes.
+	inline void setLowRankBudget(const int rank) {
+		m_solver_d.setLowRankBudget(rank);
+#ifndef USE_CUDA
+		m_solver_c.setLowRankBudget(rank);
+#endif
+	}
+
 	void addCollisionProxies(const int *tets, const T (*weights)[d], size_t length);
 	void addSelfCollisionElements(const int* tets, size_t length);
 
@@ -137,7 +156,14 @@ public:
 	inline void initializeLevelSet(const T dx) { m_levelSet->initializeLevelSet(m_levelSetPaths, dx); }
 	// void initializeLevelSet(const int(*triangles)[d], const T(*vertices)[d], const size_t nTris, const size_t nVerts);
 
-	void solve();  // do least squares solve and process collisions
+	bool solve();  // do least squares solve and process collisions; true once the iteration has converged
+
+	// Acceleration, step limits, convergence tolerance and iterations per solve() call.
+	inline PhysBAM::IterationPolicy<T, d>& iterationPolicy() { return m_iterationPolicy; }
+
+	// Oldest unread solve() record, if any; only filled while PhysBAM::Telemetry::setLevel() is at least Stats.
+	inline bool popSolveStats(PhysBAM::SolveStats<T>& stats) { return m_telemetry.pop(stats); }
+	inline const PhysBAM::FactorizationStats& factorizationStats() const { return m_factorStats; }
 
 	PDTetSolver() : m_nInner(1), m_rangeMin(1), m_rangeMax(1), m_weightProportion(0), m_collisionStiffness(0), m_selfCollisionStiffness(0) { m_levelSet = new PhysBAM::MergedLevelSet<VectorType>; }
 	~PDTetSolver();
@@ -145,7 +171,9 @@ public:
 	void premoteSutures();
 
 	inline const std::array<int, 4>& getTetIndices(int tet) { return m_gridDeformer.m_elements[tet]; }  // COURT added
-	inline int numberOfTetConstraints() { return m_gridDeformer.m_constraints.size(); }
+	inline int numberOfTetConstraints() {  // live hooks and fixed vertices, deleted ones not counted
+		return (int)std::count_if(m_gridDeformer.m_constraintHandles.begin(), m_gridDeformer.m_constraintHandles.end(), [](const int handle) { return handle > -1; });
+	}
 
 private:
 	void updateCollisionConstraints();
@@ -84,6 +84,9 @@ public:
 
 	inline bool solverInitialized() { return m_solverInited; }
 
+	// Number of rank-1 hook/suture changes reInitializePhysics() may layer on the current factorization before doing a full one.
+	inline void setLowRankUpdateBudget(const int rank) { m_solver.setLowRankBudget(rank); }
+
 	inline std::array<float, 3>* createBccTetStructure(const std::vector< std::array<int, 4> > &tetIndices, float tetScale) {
 		m_solver.initializeDeformer(reinterpret_cast<const int(*)[4]>(&tetIndices[0][0]), tetIndices.size(), tetScale * 2);
 		m_deformerInited = true;
@@ -131,16 +134,16 @@ public:
 			throw std::logic_error("need to init tet topology before setFixedNodes");
 		const T weight[d] = { 0,0,0 };
 
-		// QISI - I see your m_grid_deformer handles tet constraints for hooks and fixed vertices.  Will hooks always be the last?  This is somewhat ugly.  Please advise.
-		if (m_solver.numberOfTetConstraints() >= fixedTetConstraints.size()) {
-			for (auto& tc : fixedTetConstraints)
-				m_solver.deleteConstraint(tc);
-		}
+		// Handles stay valid across compaction and fixedTetConstraints is cleared whenever the deformer is initialized,
+		// so every handle here belongs to the current deformer.  Deleting an already deleted handle does nothing.
+		for (auto& tc : fixedTetConstraints)
+			m_solver.deleteConstraint(tc);
 		fixedTetConstraints.clear();
 
 		assert(fixedTets.size() == fixedWeights.size() && fixedWeights.size() == fixedPositions.size());
 		assert(peripheralTets.size() == peripheralWeights.size() && peripheralWeights.size() == peripheralPositions.size());
-		std::cout << "DEBUG: Setting " << fixedTets.size() << " fixed vertices and " << peripheralTets.size() << " peripheral vertices" << std::endl;
+		if (PDTET_TELEMETRY_ON(Verbose))
+			std::cout << "Setting " << fixedTets.size() << " fixed vertices and " << peripheralTets.size() << " peripheral vertices" << std::endl;
 		fixedTetConstraints.reserve(fixedTets.size() + peripheralTets.size());
 		int fts = fixedTets.size();
 		for (int i = 0; i < fts; i++) {
@@ -162,9 +165,10 @@ public:
 			number = m_solver.addConstraint(tet, reinterpret_cast<const T(&)[d]>(barycentricWeight), reinterpret_cast<const T(&)[d]>(hookPosition), m_hookWeight*200.0f, m_stressLimit*2000.0f);
 		else
 			number = m_solver.addConstraint(tet, reinterpret_cast<const T(&)[d]>(barycentricWeight), reinterpret_cast<const T(&)[d]>(hookPosition), m_hookWeight, m_stressLimit);
-		std::cout << "DEBUG: Added hook constraint #" << number << " to tet " << tet 
-		          << " at position (" << hookPosition[0] << ", " << hookPosition[1] << ", " << hookPosition[2] << ")"
-		          << " with weight " << (strong ? m_hookWeight*200.0f : m_hookWeight) << std::endl;
+		if (PDTET_TELEMETRY_ON(Verbose))
+			std::cout << "Added hook constraint #" << number << " to tet " << tet
+			          << " at position (" << hookPosition[0] << ", " << hookPosition[1] << ", " << hookPosition[2] << ")"
+			          << " with weight " << (strong ? m_hookWeight*200.0f : m_hookWeight) << std::endl;
 //		initializePhysics();  // don't do this here.  Do in calling routine due to group initilization.
 		return number;
 	}
@@ -218,10 +222,7 @@ public:
 			// guard against init with no tet properties
 			if (!m_tetPropsSet)
 				throw std::logic_error("need to set tetProperties before initializePhysics");
-			// TEMPORARY: Skip collision object initialization on macOS to avoid Pardiso dependency
-			#ifndef __APPLE__
 			initializeCollisionObject(0.03f);
-			#endif
 			promoteAllSutures();
 			m_solver.initializeSolver();
 			m_solverInited = true;
@@ -243,13 +244,18 @@ public:
 		m_solver.addCollisionProxies(&tets[0], reinterpret_cast<const T(*)[d]>(&weights[0]), tets.size());
 	}
 
-	// do least squares solve and process collisions
-	inline void solve() {
+	// do least squares solve and process collisions; true once the iteration has converged
+	inline bool solve() {
 		if (!m_solverInited)
 			throw std::logic_error("need to init solver before solve");
-		m_solver.solve();
+		return m_solver.solve();
 	}
 
+	inline PhysBAM::IterationPolicy<T, d>& iterationPolicy() { return m_solver.iterationPolicy(); }
+
+	inline bool popSolveStats(PhysBAM::SolveStats<T>& stats) { return m_solver.popSolveStats(stats); }
+	inline const PhysBAM::FactorizationStats& factorizationStats() const { return m_solver.factorizationStats(); }
+
 	pdTetPhysics() : m_tetPropsSet(false), m_solverInited(false), m_deformerInited(false), m_levelsetInited(false) {}
 
 	~pdTetPhysics() {
@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include "Utilities.h"
 #include "MergedLevelSet.h"
 
@@ -49,6 +54,160 @@ VectorType PhysBAM::MergedLevelSet<VectorType>::Extended_Normal(const VectorType
 	return normal;
 }
 
+template<class VectorType>
+void MergedLevelSet<VectorType>::queryBlock(const QueryGrid& grid, const T (&x)[d][queryBlockWidth], T (&phi)[queryBlockWidth]) const
+{	// LEVELSET_UNIFORM::Extended_Phi with linear interpolation, one point per lane and the same arithmetic as the scalar path
+	static_assert(d == 3, "trilinear interpolation only");
+	const int sx = grid.stride[0], sy = grid.stride[1];
+	T magnitudeSquared[queryBlockWidth] = {}, w[d][queryBlockWidth];
+	int offset[queryBlockWidth] = {};
+	for (int v = 0; v < d; v++) {
+#pragma omp simd
+		for (int l = 0; l < queryBlockWidth; l++) {
+			const T c = std::min(std::max(x[v][l], grid.minCorner[v]), grid.maxCorner[v]);
+			magnitudeSquared[l] += (c - x[v][l]) * (c - x[v][l]);
+			const int i = std::min(grid.maxIndex[v] - 1, grid.minIndex[v] + std::max(0, int((c - grid.minCorner[v]) * grid.oneOverDX[v] - grid.minIndex[v] + 1)));
+			w[v][l] = (c - (grid.minCorner[v] + (T(i) - 1) * grid.dX[v])) * grid.oneOverDX[v];
+			offset[l] += (i - grid.minIndex[v]) * grid.stride[v];
+		}
+	}
+#pragma omp simd
+	for (int l = 0; l < queryBlockWidth; l++) {
+		const T* p = grid.phi + offset[l];
+		T bottom = p[0] + w[0][l] * (p[sx] - p[0]), top = p[sy] + w[0][l] * (p[sx + sy] - p[sy]);
+		const T front = bottom + w[1][l] * (top - bottom);
+		bottom = p[1] + w[0][l] * (p[sx + 1] - p[1]);
+		top = p[sy + 1] + w[0][l] * (p[sx + sy + 1] - p[sy + 1]);
+		const T back = bottom + w[1][l] * (top - bottom);
+		T value = front + w[2][l] * (back - front);
+		if (magnitudeSquared[l]) {
+			const T positive = std::max(T(0), value);
+			value = std::sqrt(magnitudeSquared[l] + positive * positive);
+		}
+		phi[l] = value;
+	}
+}
+
+template<class VectorType>
+void MergedLevelSet<VectorType>::Extended_Phi_And_Normal(const int n, const T* const x[d], T* phi, T* const normal[d], const T normalThreshold) const
+{
+	const int nLevelSets = (int)m_queryGrids.size();
+	std::vector<int> winners(n);
+	const int nBlocks = (n + queryBlockWidth - 1) / queryBlockWidth;
+#pragma omp parallel for
+	for (int b = 0; b < nBlocks; b++) {
+		const int first = b * queryBlockWidth, width = std::min(queryBlockWidth, n - first);
+		T xb[d][queryBlockWidth], best[queryBlockWidth], levelSetPhi[queryBlockWidth];
+		int winner[queryBlockWidth];
+		for (int v = 0; v < d; v++)
+			for (int l = 0; l < queryBlockWidth; l++)
+				xb[v][l] = x[v][first + std::min(l, width - 1)];  // tail lanes repeat the last point
+		for (int l = 0; l < queryBlockWidth; l++) {
+			best[l] = FLT_MAX;
+			winner[l] = -1;
+		}
+		for (int s = 0; s < nLevelSets; s++) {
+			const QueryGrid& grid = m_queryGrids[s];
+			// Outside its grid box a level set's Extended_Phi is at least the distance to the box, so it can only win
+			// where the point is inside the box or closer to it than the best phi so far.
+			T boxDistanceSquared[queryBlockWidth] = {};
+			for (int v = 0; v < d; v++) {
+				for (int l = 0; l < queryBlockWidth; l++) {
+					const T c = std::min(std::max(xb[v][l], grid.minCorner[v]), grid.maxCorner[v]);
+					boxDistanceSquared[l] += (c - xb[v][l]) * (c - xb[v][l]);
+				}
+			}
+			bool any = false;
+			for (int l = 0; l < queryBlockWidth; l++)
+				any |= !boxDistanceSquared[l] || std::sqrt(boxDistanceSquared[l]) < best[l];
+			if (!any)
+				continue;
+			queryBlock(grid, xb, levelSetPhi);
+			for (int l = 0; l < queryBlockWidth; l++) {
+				if (levelSetPhi[l] < best[l]) {
+					best[l] = levelSetPhi[l];
+					winner[l] = s;
+				}
+			}
+		}
+		for (int l = 0; l < width; l++) {
+			phi[first + l] = best[l];
+			winners[first + l] = best[l] < normalThreshold ? winner[l] : -2;
+		}
+	}
+
+	// Normals are only wanted for the few points below normalThreshold, so those are packed into blocks per winning level set.
+	std::vector<int> points, blockStarts, blockWidths, blockLevelSets;
+	for (int s = -1; s < nLevelSets; s++) {
+		const int begin = (int)points.size();
+		for (int i = 0; i < n; i++)
+			if (winners[i] == s)
+				points.push_back(i);
+		for (int j = begin; j < (int)points.size(); j += queryBlockWidth) {
+			blockStarts.push_back(j);
+			blockWidths.push_back(std::min(queryBlockWidth, (int)points.size() - j));
+			blockLevelSets.push_back(s);
+		}
+	}
+#pragma omp parallel for
+	for (int b = 0; b < (int)blockStarts.size(); b++) {
+		const int s = blockLevelSets[b], first = blockStarts[b], width = blockWidths[b];
+		if (s < 0) {  // no level sets, Extended_Normal returns the position
+			for (int l = 0; l < width; l++)
+				for (int v = 0; v < d; v++)
+					normal[v][points[first + l]] = x[v][points[first + l]];
+			continue;
+		}
+		// central differences of the winning level set, as LEVELSET_3D::Extended_Normal does without precomputed normals
+		const QueryGrid& grid = m_queryGrids[s];
+		T xb[d][queryBlockWidth], plus[queryBlockWidth], minus[queryBlockWidth], gradient[d][queryBlockWidth];
+		for (int v = 0; v < d; v++)
+			for (int l = 0; l < queryBlockWidth; l++)
+				xb[v][l] = x[v][points[first + std::min(l, width - 1)]];
+		for (int v = 0; v < d; v++) {
+			T center[queryBlockWidth];
+			std::memcpy(center, xb[v], sizeof(center));
+			for (int l = 0; l < queryBlockWidth; l++)
+				xb[v][l] = center[l] + grid.dX[v];
+			queryBlock(grid, xb, plus);
+			for (int l = 0; l < queryBlockWidth; l++)
+				xb[v][l] = center[l] - grid.dX[v];
+			queryBlock(grid, xb, minus);
+			for (int l = 0; l < queryBlockWidth; l++) {
+				gradient[v][l] = (plus[l] - minus[l]) / (2 * grid.dX[v]);
+				xb[v][l] = center[l];
+			}
+		}
+		for (int l = 0; l < width; l++) {
+			const T magnitude = std::sqrt(gradient[0][l] * gradient[0][l] + gradient[1][l] * gradient[1][l] + gradient[2][l] * gradient[2][l]);
+			for (int v = 0; v < d; v++)
+				normal[v][points[first + l]] = magnitude ? gradient[v][l] * (1 / magnitude) : T(v == 0);
+		}
+	}
+}
+
+template<class VectorType>
+void MergedLevelSet<VectorType>::addQueryGrid(const LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet)
+{
+	const GRID<VectorType>& grid = levelSet.levelset.grid;
+	const ARRAY<T, VECTOR<int, d>>& phi = levelSet.levelset.phi;
+	const RANGE<VECTOR<int, d>> domain = phi.Domain_Indices();
+	QueryGrid q;
+	for (int v = 0; v < d; v++) {
+		q.minCorner[v] = grid.domain.min_corner(v + 1);
+		q.maxCorner[v] = grid.domain.max_corner(v + 1);
+		q.dX[v] = grid.dX(v + 1);
+		q.oneOverDX[v] = grid.one_over_dX(v + 1);
+		q.minIndex[v] = domain.min_corner(v + 1);
+		q.maxIndex[v] = domain.max_corner(v + 1);
+	}
+	q.stride[d - 1] = 1;  // the last index varies fastest
+	for (int v = d - 2; v >= 0; v--)
+		q.stride[v] = q.stride[v + 1] * (q.maxIndex[v + 1] - q.minIndex[v + 1] + 1);
+	q.phi = phi.array.Get_Array_Pointer();
+	m_queryGrids.push_back(q);
+}
+
 template<class VectorType>
 PhysBAM::MergedLevelSet<VectorType>::~MergedLevelSet()
 {
@@ -56,10 +215,100 @@ PhysBAM::MergedLevelSet<VectorType>::~MergedLevelSet()
 		if (m_levelSet[i]) delete m_levelSet[i];
 }
 
+namespace {
+	struct LevelSetCacheHeader {
+		char magic[8];
+		uint64_t meshHash;
+		double dx;
+		int32_t scalarSize;
+		int32_t counts[3];
+		double minCorner[3];
+		double maxCorner[3];
+	};
+	const char levelSetCacheMagic[8] = { 'P', 'D', 'T', 'S', 'D', 'F', '0', '2' };
+}
+
 template<class VectorType>
-void MergedLevelSet<VectorType>::addLevelSet(const std::string& collisionObjPath)
+std::string MergedLevelSet<VectorType>::cachePath(const std::string& collisionObjPath)
+{
+	size_t dot = collisionObjPath.find_last_of('.');
+	size_t slash = collisionObjPath.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return collisionObjPath + ".sdf";
+	return collisionObjPath.substr(0, dot) + ".sdf";
+}
+
+template<class VectorType>
+uint64_t MergedLevelSet<VectorType>::meshHash(const std::string& collisionObjPath)
+{  // FNV-1a over the OBJ file, 0 if it can't be read
+	std::ifstream in(collisionObjPath, std::ios::binary);
+	if (!in)
+		return 0;
+	uint64_t hash = 14695981039346656037ull;
+	char buffer[65536];
+	while (in) {
+		in.read(buffer, sizeof(buffer));
+		for (std::streamsize n = in.gcount(), i = 0; i < n; i++) {
+			hash ^= (unsigned char)buffer[i];
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+template<class VectorType>
+bool MergedLevelSet<VectorType>::readCache(const std::string& path, const uint64_t hash, const T dx, LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet)
+{
+	using IndexType = VECTOR<int, d>;
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		return false;
+	LevelSetCacheHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	if (std::memcmp(header.magic, levelSetCacheMagic, sizeof(header.magic)) || header.meshHash != hash || header.dx != double(dx) || header.scalarSize != int32_t(sizeof(T)))
+		return false;
+	IndexType gridSize;
+	VectorType minCorner, maxCorner;
+	for (int v = 0; v < d; v++) {
+		gridSize(v + 1) = header.counts[v];
+		minCorner(v + 1) = T(header.minCorner[v]);
+		maxCorner(v + 1) = T(header.maxCorner[v]);
+	}
+	levelSet.levelset.grid.Initialize(gridSize, RANGE<VectorType>(minCorner, maxCorner));
+	levelSet.Update_Box();
+	levelSet.Update_Minimum_Cell_Size();
+	ARRAY<T, IndexType>& phi = levelSet.levelset.phi;
+	phi.Resize(levelSet.levelset.grid.Domain_Indices(), false);
+	return bool(in.read(reinterpret_cast<char*>(phi.array.Get_Array_Pointer()), std::streamsize(sizeof(T)) * phi.array.Size()));
+}
+
+template<class VectorType>
+bool MergedLevelSet<VectorType>::writeCache(const std::string& path, const uint64_t hash, const T dx, const LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet)
+{
+	const GRID<VectorType>& grid = levelSet.levelset.grid;
+	LevelSetCacheHeader header;
+	std::memcpy(header.magic, levelSetCacheMagic, sizeof(header.magic));
+	header.meshHash = hash;
+	header.dx = double(dx);
+	header.scalarSize = int32_t(sizeof(T));
+	for (int v = 0; v < d; v++) {
+		header.counts[v] = grid.counts(v + 1);
+		header.minCorner[v] = double(grid.domain.min_corner(v + 1));
+		header.maxCorner[v] = double(grid.domain.max_corner(v + 1));
+	}
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+	const ARRAY<T, VECTOR<int, d>>& phi = levelSet.levelset.phi;
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(phi.array.Get_Array_Pointer()), std::streamsize(sizeof(T)) * phi.array.Size());
+	return bool(out);
+}
+
+template<class VectorType>
+void MergedLevelSet<VectorType>::computeLevelSet(const std::string& collisionObjPath, const T dx, LEVELSET_IMPLICIT_OBJECT<VectorType>& levelSet)
 {
-	std::cout << collisionObjPath << std::endl;
 	using IndexType = VECTOR<int, d>;
 
 	std::vector<std::array<int, 3>> triangles;
@@ -105,28 +354,54 @@ void MergedLevelSet<VectorType>::addLevelSet(const std::string& collisionObjPath
 	LOG::cout << "minCorner: " << minCorner << std::endl;
 
 	VectorType gridOrigin = minCorner;
-	IndexType gridSize = IndexType(int((maxCorner(1) - minCorner(1)) / gridDX) + 1, int((maxCorner(2) - minCorner(2)) / gridDX) + 1, int((maxCorner(3) - minCorner(3)) / gridDX) + 1);
+	IndexType gridSize = IndexType(int((maxCorner(1) - minCorner(1)) / dx) + 1, int((maxCorner(2) - minCorner(2)) / dx) + 1, int((maxCorner(3) - minCorner(3)) / dx) + 1);
 
 	LOG::cout << "gridSize: " << gridSize << std::endl;
 	// Compute level set
 
-	size_t idx = m_levelSet.size();
-	m_levelSet.push_back(nullptr);
-	m_levelSet[idx] = LEVELSET_IMPLICIT_OBJECT<VectorType>::Create();
-	
-	m_levelSet[idx]->levelset.grid.Initialize(gridSize, RANGE<VectorType>(minCorner, maxCorner));
-	m_levelSet[idx]->Update_Box();
-	m_levelSet[idx]->Update_Minimum_Cell_Size();
-	//GRID<VectorType>& levelSetGrid = *new GRID<VectorType>(gridSize, RANGE<VectorType>(minCorner, maxCorner));
-	//ARRAY<T, IndexType>& phi = *new ARRAY<T, IndexType>;
+	levelSet.levelset.grid.Initialize(gridSize, RANGE<VectorType>(minCorner, maxCorner));
+	levelSet.Update_Box();
+	levelSet.Update_Minimum_Cell_Size();
 	LEVELSET_MAKER_UNIFORM<T> maker;
+	maker.Use_Exact_Narrow_Band();  // collisions only look at phi < 0, which stays exact everywhere
 	std::cout << "before maker" << std::endl;
-	maker.Compute_Level_Set(*levelset_surface, m_levelSet[idx]->levelset.grid, m_levelSet[idx]->levelset.phi);
+	maker.Compute_Level_Set(*levelset_surface, levelSet.levelset.grid, levelSet.levelset.phi);
 	std::cout << "after maker" << std::endl;
 	
 	delete levelset_surface;
 }
 
+template<class VectorType>
+void MergedLevelSet<VectorType>::addLevelSet(const std::string& collisionObjPath)
+{
+	std::cout << collisionObjPath << std::endl;
+	LEVELSET_IMPLICIT_OBJECT<VectorType>* levelSet = LEVELSET_IMPLICIT_OBJECT<VectorType>::Create();
+	m_levelSet.push_back(levelSet);
+	const std::string path = cachePath(collisionObjPath);
+	const uint64_t hash = meshHash(collisionObjPath);
+	if (hash && readCache(path, hash, gridDX, *levelSet))
+		std::cout << "level set read from " << path << std::endl;
+	else {
+		computeLevelSet(collisionObjPath, gridDX, *levelSet);
+		if (hash && !writeCache(path, hash, gridDX, *levelSet))
+			std::cout << "unable to write level set cache " << path << std::endl;
+	}
+	addQueryGrid(*levelSet);
+}
+
+template<class VectorType>
+bool MergedLevelSet<VectorType>::precomputeLevelSet(const std::string& collisionObjPath, const T dx)
+{
+	const uint64_t hash = meshHash(collisionObjPath);
+	if (!hash)
+		return false;
+	LEVELSET_IMPLICIT_OBJECT<VectorType>* levelSet = LEVELSET_IMPLICIT_OBJECT<VectorType>::Create();
+	computeLevelSet(collisionObjPath, dx, *levelSet);
+	bool written = writeCache(cachePath(collisionObjPath), hash, dx, *levelSet);
+	delete levelSet;
+	return written;
+}
+
 namespace PhysBAM {
 template
 class MergedLevelSet<VECTOR<float, 3>>;
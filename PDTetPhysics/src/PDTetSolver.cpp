@@ -2,6 +2,7 @@
 #include "Algebra.h"
 
 #include "MergedLevelSet.h"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <set>
@@ -56,9 +57,7 @@ int PDTetSolver<T, d>::addSuture(const int(&tets)[2], const T(&barycentricWeight
 	}
 	c1.m_stiffness = 2 * stiffness;
 	c2.m_stiffness = 2 * stiffness;
-	m_gridDeformer.m_fakeSutures.push_back(c1);
-	m_gridDeformer.m_fakeSutures.push_back(c2);
-	return (int) (m_gridDeformer.m_sutures.size() - 1 + m_gridDeformer.m_fakeSutures.size()/2);
+	return m_gridDeformer.addFakeSuture(c1, c2);
 
 }
 
@@ -66,14 +65,19 @@ template<class T, int d>
 void PDTetSolver<T, d>::initializeSolver()
 {
 	using IteratorType = typename DeformerType::IteratorType;
+	const bool collectStats = PDTET_TELEMETRY_ON(Stats);
+	std::chrono::steady_clock::time_point startStamp;
+	if (collectStats)
+		startStamp = std::chrono::steady_clock::now();
+	m_iterationPolicy.restart();
+	m_gridDeformer.compactConstraints();  // everything gets refactored here anyway
 	m_gridDeformer.deallocateAuxiliaryStructures();
 	m_gridDeformer.initializeElementFlags();
 	m_gridDeformer.initializeAuxiliaryStructures();
 	
-	// Debug output to understand why collision solver is being used
-	std::cout << "DEBUG: m_collisionConstraints.size() = " << m_gridDeformer.m_collisionConstraints.size() << std::endl;
-	std::cout << "DEBUG: m_collisionSutures.size() = " << m_gridDeformer.m_collisionSutures.size() << std::endl;
-	
+	if (PDTET_TELEMETRY_ON(Verbose))
+		std::cout << "collision constraints: " << m_gridDeformer.m_collisionConstraints.size() << ", collision sutures: " << m_gridDeformer.m_collisionSutures.size() << std::endl;
+
 	if (m_gridDeformer.m_collisionConstraints.size()||m_gridDeformer.m_collisionSutures.size()) {
 		hasCollision = true;
 #ifdef USE_CUDA
@@ -86,13 +90,16 @@ void PDTetSolver<T, d>::initializeSolver()
 		m_solver_c.computeTensor(m_gridDeformer.m_elements, m_gridDeformer.m_gradientMatrix, m_gridDeformer.m_elementRestVolume, m_gridDeformer.m_muLow, m_gridDeformer.m_muHigh, m_gridDeformer.m_sutures, m_gridDeformer.m_InternodeConstraints); // computeTensor
 #ifdef USE_CUDA
 		m_solver_c.computeE2Tensor(m_gridDeformer.m_elements, m_gridDeformer.m_elementFlags, m_gridDeformer.m_gradientMatrix, m_gridDeformer.m_elementRestVolume, m_gridDeformer.m_muHigh[0] * (1 + m_weightProportion * m_weightProportion)); // computeE2Tensor
+#else
+		m_solver_c.computeE2Tensor(m_gridDeformer.m_elements, m_gridDeformer.m_elementFlags, m_gridDeformer.m_gradientMatrix, m_gridDeformer.m_elementRestVolume, m_gridDeformer.m_muLow, m_gridDeformer.m_muHigh); // computeE2Tensor
 #endif
 		m_solver_c.initializePardiso(m_gridDeformer.m_constraints, m_gridDeformer.m_sutures, m_gridDeformer.m_fakeSutures, m_gridDeformer.m_InternodeConstraints); // init pardiso
 #ifdef USE_CUDA
 		m_solver_c.initializeCuda(m_gridDeformer.m_collisionConstraints, m_gridDeformer.m_collisionSutures); // init Cuda
 		std::cout << "using CudaSolver with nInner = " << m_nInner << std::endl;
 #else
-		std::cout << "using MKLSolver"<< std::endl;
+		m_solver_c.initializeCollision(m_gridDeformer.m_collisionConstraints, m_gridDeformer.m_collisionSutures);
+		std::cout << "using CollisionSchurSolver with nInner = " << m_nInner << std::endl;
 #endif
 	}
 	else {
@@ -105,20 +112,39 @@ void PDTetSolver<T, d>::initializeSolver()
 		m_solver_d.initializePardiso(m_gridDeformer.m_constraints, m_gridDeformer.m_sutures, m_gridDeformer.m_fakeSutures, m_gridDeformer.m_InternodeConstraints);
 		std::cout << "using DirectSolver" << std::endl;
 	}
+	if (collectStats) {
+		++m_factorStats.m_factorizations;
+		m_factorStats.m_factorSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startStamp).count();
+	}
 }
 
 template<class T, int d>
 void PDTetSolver<T, d>::reInitializeSolver()
 {
+	const bool collectStats = PDTET_TELEMETRY_ON(Stats);
+	std::chrono::steady_clock::time_point startStamp;
+	if (collectStats)
+		startStamp = std::chrono::steady_clock::now();
+	m_iterationPolicy.restart();
+	// Compacting forces a full refactorization instead of a low rank update, so wait until dead entries dominate.
+	if (m_gridDeformer.compactionDue())
+		m_gridDeformer.compactConstraints();
 	if (hasCollision) {
 		m_solver_c.reInitializePardiso(m_gridDeformer.m_constraints, m_gridDeformer.m_sutures, m_gridDeformer.m_fakeSutures, m_gridDeformer.m_InternodeConstraints);
 #ifdef USE_CUDA
 		m_solver_c.reInitializeCuda(m_gridDeformer.m_collisionConstraints, m_gridDeformer.m_collisionSutures);
+#else
+		// a low rank Sigma1 correction reaches the collision block factor as an update, not a refactor
+		m_solver_c.updateCollision(m_gridDeformer.m_collisionConstraints, m_gridDeformer.m_collisionSutures);
 #endif
 	}
 	else {
 		m_solver_d.reInitializePardiso(m_gridDeformer.m_constraints, m_gridDeformer.m_sutures, m_gridDeformer.m_fakeSutures, m_gridDeformer.m_InternodeConstraints);
 	}
+	if (collectStats) {
+		++m_factorStats.m_reFactorizations;
+		m_factorStats.m_reFactorSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startStamp).count();
+	}
 }
 
 template<class T, int d>
@@ -171,175 +197,137 @@ void PDTetSolver<T, d>::addSelfCollisionElements(const int* tets, size_t length)
 }
 
 template<class T, int d>
-void PDTetSolver<T, d>::solve()
+int PDTetSolver<T, d>::clampInvalidPositions(const char* when)
 {
-	std::cout << "DEBUG: PDTetSolver::solve() called" << std::endl;
-	
-	// MACOS PORT: Validate positions before solve
+	// MACOS PORT: reset NaN/Inf coordinates and pull runaway ones back into range
 	const T MAX_COORD = 1000.0;
-	bool hasInvalidPositions = false;
+	int clamped = 0;
 	for (int i = 0; i < m_gridDeformer.m_X.size(); i++) {
 		for (int j = 1; j <= d; j++) {
-			if (std::isnan(m_gridDeformer.m_X[i](j)) || std::isinf(m_gridDeformer.m_X[i](j)) || 
-			    std::abs(m_gridDeformer.m_X[i](j)) > MAX_COORD) {
-				std::cout << "ERROR: Invalid position detected before solve - vertex " << i 
-				          << " has coordinate " << m_gridDeformer.m_X[i](j) 
-				          << " in dimension " << j << std::endl;
-				hasInvalidPositions = true;
-				// Clamp the position
-				if (std::isnan(m_gridDeformer.m_X[i](j)) || std::isinf(m_gridDeformer.m_X[i](j))) {
-					m_gridDeformer.m_X[i](j) = 0;
-				} else {
-					m_gridDeformer.m_X[i](j) = std::max(-MAX_COORD, std::min(MAX_COORD, m_gridDeformer.m_X[i](j)));
-				}
+			T& x = m_gridDeformer.m_X[i](j);
+			if (std::isnan(x) || std::isinf(x) || std::abs(x) > MAX_COORD) {
+				std::cout << "ERROR: Invalid position detected " << when << " solve - vertex " << i
+				          << " has coordinate " << x << " in dimension " << j << std::endl;
+				x = (std::isnan(x) || std::isinf(x)) ? T(0) : std::max(-MAX_COORD, std::min(MAX_COORD, x));
+				clamped++;
 			}
 		}
 	}
-	
-	if (hasInvalidPositions) {
-		std::cout << "WARNING: Invalid positions detected and clamped before solve!" << std::endl;
-	}
-	
+	return clamped;
+}
+
+template<class T, int d>
+bool PDTetSolver<T, d>::solve()
+{
+	const bool collectStats = PDTET_TELEMETRY_ON(Stats);
+	const bool guardPositions = m_iterationPolicy.m_guardPositions || collectStats;
+	PhysBAM::SolveStats<T> stats;
+	std::chrono::steady_clock::time_point startStamp;
+	if (collectStats)
+		startStamp = std::chrono::steady_clock::now();
+
 	using StateVariableType = typename DiscretizationType::StateVariableType;
 	using IteratorType = typename DeformerType::IteratorType;
 	using AlgebraType = PhysBAM::Algebra<StateVariableType>;
 
 	StateVariableType delta_X{};
 	StateVariableType f{};
+	StateVariableType X0{};
 	
 	IteratorType iterator(m_gridDeformer.m_X);
 	iterator.resize(delta_X);
 	iterator.resize(f);
-	
-	std::cout << "DEBUG: PDTetSolver - starting physics iteration" << std::endl;
-
-	m_gridDeformer.updatePositionBasedState(ElementFlag::unCollisionEl/*, m_rangeMin, m_rangeMax*/ ); // updateR1
-	m_gridDeformer.addElasticForce(f, ElementFlag::unCollisionEl /*, m_rangeMin, m_rangeMax, m_weightProportion */); //addR1Force
-	m_gridDeformer.addConstraintForce(f); //addConstraintForec
-
-	// Debug: Check if forces are non-zero
-	T totalForceMagnitude = 0;
-	for (int i = 0; i < f.size(); ++i) {
-		T mag = 0;
-		for (int dim = 1; dim <= 3; ++dim) {
-			mag += f[i](dim) * f[i](dim);
-		}
-		totalForceMagnitude += std::sqrt(mag);
-	}
-	std::cout << "DEBUG: Total force magnitude = " << totalForceMagnitude << std::endl;
 
-	if (!hasCollision) {
-		updateCollisionConstraints();
-		
-		for (int v = 0; v < d; v++) {
-			m_solver_d.copyIn(f, v);
-			m_solver_d.solve();
-			m_solver_d.copyOut(delta_X, v);
-		}
-		
-		// Debug: Check if delta_X is non-zero
-		T totalDeltaMagnitude = 0;
-		for (int i = 0; i < delta_X.size(); ++i) {
-			T mag = 0;
-			for (int dim = 1; dim <= 3; ++dim) {
-				mag += delta_X[i](dim) * delta_X[i](dim);
-			}
-			totalDeltaMagnitude += std::sqrt(mag);
+	bool converged = false;
+	for (int step = 0; step < std::max(1, m_iterationPolicy.m_maxIterations) && !converged; step++) {
+		if (guardPositions)
+			stats.m_clampedPositions += clampInvalidPositions("before");
+
+		AlgebraType::clear(f);
+		m_gridDeformer.updatePositionBasedState(ElementFlag::unCollisionEl/*, m_rangeMin, m_rangeMax*/ ); // updateR1
+		m_gridDeformer.addElasticForce(f, ElementFlag::unCollisionEl /*, m_rangeMin, m_rangeMax, m_weightProportion */); //addR1Force
+		m_gridDeformer.addConstraintForce(f, collectStats ? &stats : nullptr); //addConstraintForec
+
+		if (collectStats)
+			stats.m_forceNorm = std::sqrt(AlgebraType::innerProduct(f, f));
+
+		if (!hasCollision) {
+			updateCollisionConstraints();
+
+			// x, y and z share the factor; solve them in one sweep
+			m_solver_d.copyIn(f);
+			m_solver_d.solve(d);
+			m_solver_d.copyOut(delta_X);
 		}
-		std::cout << "DEBUG: Total delta_X magnitude = " << totalDeltaMagnitude << std::endl;
-		
-		// MACOS PORT: Limit displacement per iteration and apply damping
-		const T MAX_DISPLACEMENT_PER_ITER = 5.0;  // Increased from 0.5 to 2.0 for faster hook pulling
-		T maxDisp = 0;
-		for (int i = 0; i < delta_X.size(); i++) {
-			T disp = 0;
-			for (int dim = 1; dim <= 3; ++dim) {
-				disp += delta_X[i](dim) * delta_X[i](dim);
-			}
-			disp = std::sqrt(disp);
-			if (disp > maxDisp) maxDisp = disp;
-			if (disp > MAX_DISPLACEMENT_PER_ITER) {
-				for (int dim = 1; dim <= 3; ++dim) {
-					delta_X[i](dim) *= MAX_DISPLACEMENT_PER_ITER / disp;
+		else {
+#ifdef USE_CUDA
+			throw std::logic_error("CudaSolver is not wired into PDTetSolver::solve()");
+#else
+			// condense the R1 and constraint forces onto the collision nodes once, then iterate on the
+			// collision block with the R2 elastic and collision forces re-projected at each inner step.
+			// The inner steps move m_X; the policy gets the combined update from where they started.
+			X0 = m_gridDeformer.m_X;
+			m_solver_c.eliminateInterior(f);
+
+			for (int i = 0; i < m_nInner; i++) {
+				m_gridDeformer.updatePositionBasedState(ElementFlag::CollisionEl); // updateR2
+				updateCollisionConstraints();
+				if (!m_solver_c.updateCollision(m_gridDeformer.m_collisionConstraints, m_gridDeformer.m_collisionSutures)) {
+					// no usable collision block factor; keep what the inner steps so far did and recover the interior from that
+					stats.m_collisionStepsSkipped += m_nInner - i;
+					break;
 				}
+
+				AlgebraType::clear(f);
+				m_gridDeformer.addElasticForce(f, ElementFlag::CollisionEl); // addR2Force
+				m_gridDeformer.addCollisionForce(f);
+
+				AlgebraType::clear(delta_X);
+				m_solver_c.solveCollision(f, delta_X);
+				AlgebraType::addTo(m_gridDeformer.m_X, delta_X);
 			}
+
+			AlgebraType::clear(delta_X);
+			m_solver_c.recoverInterior(delta_X);
+			AlgebraType::addTo(delta_X, m_gridDeformer.m_X);
+			AlgebraType::subtractFrom(delta_X, X0);
+			// copy back rather than swap; the host holds a pointer into m_X, see getPositionPtr()
+			m_gridDeformer.m_X = X0;
+#endif
 		}
-		
-		if (maxDisp > MAX_DISPLACEMENT_PER_ITER) {
-			std::cout << "WARNING: Limited maximum displacement from " << maxDisp 
-			          << " to " << MAX_DISPLACEMENT_PER_ITER << std::endl;
-		}
-		
-		// Apply damping to reduce oscillations
-		// MACOS PORT: Use adaptive damping based on oscillation detection
-		static T previousTotalDisplacement = 0;
-		
-		// Calculate current total displacement magnitude
-		T currentTotalDisplacement = 0;
-		for (int i = 0; i < delta_X.size(); i++) {
-			currentTotalDisplacement += delta_X[i].Magnitude_Squared();
-		}
-		
-		// Detect oscillations by checking if displacement direction reverses
-		bool oscillationDetected = (previousTotalDisplacement > 0 && 
-		                           currentTotalDisplacement > previousTotalDisplacement * 0.8);
-		
-		// Base damping - LOWER values mean MORE damping
-		T dampingFactor = 0.1;  // Reduced from 0.7 to 0.5 for even more damping
-		
-		if (oscillationDetected) {
-			dampingFactor = 0.1;  // Very strong damping during oscillations (was 0.2)
-			std::cout << "DEBUG: Oscillation detected, using stronger damping = " << dampingFactor << std::endl;
-		}
-		
-		previousTotalDisplacement = currentTotalDisplacement;
-		
-		for (int i = 0; i < delta_X.size(); i++) {
-			delta_X[i] *= dampingFactor;
-		}
-		
-		AlgebraType::addTo(m_gridDeformer.m_X, delta_X);
-		
-		// MACOS PORT: Validate positions after solve
-		hasInvalidPositions = false;
-		for (int i = 0; i < m_gridDeformer.m_X.size(); i++) {
-			for (int j = 1; j <= d; j++) {
-				if (std::isnan(m_gridDeformer.m_X[i](j)) || std::isinf(m_gridDeformer.m_X[i](j)) || 
-				    std::abs(m_gridDeformer.m_X[i](j)) > MAX_COORD) {
-					std::cout << "ERROR: Invalid position detected after solve - vertex " << i 
-					          << " has coordinate " << m_gridDeformer.m_X[i](j) 
-					          << " in dimension " << j << std::endl;
-					hasInvalidPositions = true;
-					// Clamp the position
-					if (std::isnan(m_gridDeformer.m_X[i](j)) || std::isinf(m_gridDeformer.m_X[i](j))) {
-						m_gridDeformer.m_X[i](j) = 0;
-					} else {
-						m_gridDeformer.m_X[i](j) = std::max(-MAX_COORD, std::min(MAX_COORD, m_gridDeformer.m_X[i](j)));
-					}
-				}
+
+		for (IteratorType i(delta_X); !i.isEnd(); i.next())
+			if (i.value(m_gridDeformer.m_nodeType) == NodeType::Inactive)
+				i.value(delta_X) = VectorType();
+		converged = m_iterationPolicy.step(getPositionPtr(), &delta_X[0](1), delta_X.size());
+		stats.m_steps++;
+
+		if (guardPositions)
+			stats.m_clampedPositions += clampInvalidPositions("after");
+
+		// update invalid nodes
+		for (int i = 0; i < invalidNodes.size(); ++i) {
+			m_gridDeformer.m_X[invalidNodes[i]] = VectorType();
+			for (int j = 0; j < invalidEmbedding[i].size(); ++j) {
+				m_gridDeformer.m_X[invalidNodes[i]] += invalidWeights[i][j] * m_gridDeformer.m_X[invalidEmbedding[i][j]];
 			}
 		}
-		
-		if (hasInvalidPositions) {
-			std::cout << "WARNING: Invalid positions detected and clamped after solve!" << std::endl;
-		}
-	}
-	else {
-		// Collision solver case - not implemented for macOS yet
-		throw std::logic_error("Collision solver not yet implemented for macOS");
 	}
 
-	for (IteratorType i(delta_X); !i.isEnd(); i.next())
-	 	if (i.value(m_gridDeformer.m_nodeType) == NodeType::Inactive)
-	 		i.value(delta_X) = VectorType();
-	
-	// update invalid nodes
-	for (int i = 0; i < invalidNodes.size(); ++i) {
-		m_gridDeformer.m_X[invalidNodes[i]] = VectorType();
-		for (int j = 0; j < invalidEmbedding[i].size(); ++j) {
-			m_gridDeformer.m_X[invalidNodes[i]] += invalidWeights[i][j] * m_gridDeformer.m_X[invalidEmbedding[i][j]];
-		}
+	if (collectStats) {
+		stats.m_iteration = m_solveCount;
+		stats.m_converged = converged;
+		stats.m_deltaNorm = std::sqrt(AlgebraType::innerProduct(delta_X, delta_X));
+		stats.m_maxDelta = AlgebraType::infinityNorm(delta_X);
+		stats.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startStamp).count();
+		m_telemetry.push(stats);
+		if (PDTET_TELEMETRY_ON(Verbose))
+			std::cout << "solve " << stats.m_iteration << ": " << stats.m_steps << (converged ? " steps, converged" : " steps")
+			          << ", |f| = " << stats.m_forceNorm << ", |dx| = " << stats.m_deltaNorm
+			          << ", max |dx| = " << stats.m_maxDelta << ", " << stats.m_seconds << " s" << std::endl;
 	}
+	m_solveCount++;
+	return converged;
 }
 
 template<class T, int d>
@@ -352,18 +340,7 @@ PDTetSolver<T, d>::~PDTetSolver()
 template<class T, int d>
 void PDTetSolver<T, d>::premoteSutures()
 {
-	for (int i = 0; i < m_gridDeformer.m_fakeSutures.size(); i += 2) {
-		typename DeformerType::Suture suture{};
-		const typename DeformerType::Constraint& c1 = m_gridDeformer.m_fakeSutures[i];
-		const typename DeformerType::Constraint& c2 = m_gridDeformer.m_fakeSutures[i+1];
-		suture.m_elementIndex1 = c1.m_elementIndex;
-		suture.m_elementIndex2 = c2.m_elementIndex;
-		suture.m_weights1 = c1.m_weights;
-		suture.m_weights2 = c2.m_weights;
-		suture.m_stiffness = c1.m_stiffness / 2;
-		m_gridDeformer.m_sutures.push_back(suture);
-	}
-	m_gridDeformer.m_fakeSutures.clear();
+	m_gridDeformer.promoteFakeSutures();
 #if 0
 	dumper::writeElements(m_gridDeformer.m_elements);
 	dumper::writePositions(m_gridDeformer.m_X);
@@ -395,13 +372,30 @@ void PDTetSolver<T, d>::updateCollisionConstraints()
 {
 	if (m_levelSet) {
 		T threshold = (T)1e-5;
-		for (int c = 0; c < m_gridDeformer.m_collisionConstraints.size(); c++) {
-			auto &constraint = m_gridDeformer.m_collisionConstraints[c];
-			VectorType pos = DiscretizationType::template interpolateX<DeformerType::elementNodes>(constraint.m_elementIndex, constraint.m_weights, m_gridDeformer.m_X);
-			T phi = m_levelSet->Extended_Phi(pos);
-			if (phi < -threshold) {
-				// std::cout << "phi " << phi << std::endl;
-				constraint.m_xT = pos - m_levelSet->Extended_Normal(pos)*phi;
+		auto& constraints = m_gridDeformer.m_collisionConstraints;
+		const int n = (int)constraints.size();
+		// positions, normals and phi of all constraints as structure of arrays for the batched level set query
+		m_collisionQuery.resize(size_t(2 * d + 1) * n);
+		T* x[d], * normal[d], * phi = m_collisionQuery.data() + size_t(2 * d) * n;
+		for (int v = 0; v < d; v++) {
+			x[v] = m_collisionQuery.data() + size_t(v) * n;
+			normal[v] = m_collisionQuery.data() + size_t(d + v) * n;
+		}
+		for (int c = 0; c < n; c++) {
+			VectorType pos = DiscretizationType::template interpolateX<DeformerType::elementNodes>(constraints[c].m_elementIndex, constraints[c].m_weights, m_gridDeformer.m_X);
+			for (int v = 0; v < d; v++)
+				x[v][c] = pos(v + 1);
+		}
+		m_levelSet->Extended_Phi_And_Normal(n, x, phi, normal, -threshold);
+		for (int c = 0; c < n; c++) {
+			auto &constraint = constraints[c];
+			VectorType pos, N;
+			for (int v = 0; v < d; v++)
+				pos(v + 1) = x[v][c];
+			if (phi[c] < -threshold) {
+				for (int v = 0; v < d; v++)
+					N(v + 1) = normal[v][c];
+				constraint.m_xT = pos - N * phi[c];
 				constraint.m_stiffness = m_collisionStiffness;
 			}
 			else {
@@ -478,9 +472,8 @@ inline void PDTetSolver<T, d>::initializeDeformer(const int(*elements)[d + 1], c
 	using namespace PhysBAM;
 	m_gridDeformer.deallocateAuxiliaryStructures();
 
-	m_gridDeformer.m_constraints.clear();
+	m_gridDeformer.clearConstraints();
 	m_gridDeformer.m_collisionConstraints.clear();
-	m_gridDeformer.m_sutures.clear();
 	m_gridDeformer.m_collisionSutures.clear();
 	m_gridDeformer.m_InternodeConstraints.clear();
 	invalidNodes.clear();
@@ -522,10 +515,8 @@ void PDTetSolver<T, d>::initializeDeformer(const int(*elements)[d + 1], const si
 	static_assert(d == 3, "this operation only support 3 dimension");
 	using namespace PhysBAM;
 	// m_gridDeformer.deallocate();
-	m_gridDeformer.m_constraints.clear();
+	m_gridDeformer.clearConstraints();
 	m_gridDeformer.m_collisionConstraints.clear();
-	m_gridDeformer.m_sutures.clear();
-	m_gridDeformer.m_fakeSutures.clear();
 	m_gridDeformer.m_collisionSutures.clear();
 	m_gridDeformer.m_InternodeConstraints.clear();
 
@@ -573,7 +564,7 @@ void PDTetSolver<T, d>::initializeDeformer(const int(*elements)[d + 1], const si
 			m_gridDeformer.m_elementRestVolume[i] = T(::vol) * gridSize * gridSize * gridSize;
 		}
 	}
-
+	m_iterationPolicy.m_lengthScale = gridSize;
 }
 
 template<class T, int d>
@@ -582,10 +573,8 @@ void PDTetSolver<T, d>::initializeDeformer_multires(const int(*elements)[d + 1],
 	static_assert(d == 3, "this operation only support 3 dimension");
 	using namespace PhysBAM;
 	// m_gridDeformer.deallocate();
-	m_gridDeformer.m_constraints.clear();
+	m_gridDeformer.clearConstraints();
 	m_gridDeformer.m_collisionConstraints.clear();
-	m_gridDeformer.m_sutures.clear();
-	m_gridDeformer.m_fakeSutures.clear();
 	m_gridDeformer.m_collisionSutures.clear();
 	m_gridDeformer.m_InternodeConstraints.clear();
 
@@ -634,6 +623,7 @@ void PDTetSolver<T, d>::initializeDeformer_multires(const int(*elements)[d + 1],
 			m_gridDeformer.m_elementRestVolume[i] = T(::vol) * gridSize * gridSize * gridSize *sizeMult* sizeMult* sizeMult;
 		}
 	}
+	m_iterationPolicy.m_lengthScale = gridSize;
 }
 
 template<class T, int d>
@@ -674,10 +664,8 @@ void PDTetSolver<T, d>::initializeDeformer_multires(const int(*elements)[d + 1],
 	static_assert(d == 3, "this operation only support 3 dimension");
 	using namespace PhysBAM;
 	// m_gridDeformer.deallocate();
-	m_gridDeformer.m_constraints.clear();
+	m_gridDeformer.clearConstraints();
 	m_gridDeformer.m_collisionConstraints.clear();
-	m_gridDeformer.m_sutures.clear();
-	m_gridDeformer.m_fakeSutures.clear();
 	m_gridDeformer.m_collisionSutures.clear();
 
 
@@ -765,17 +753,16 @@ int PDTetSolver<T, d>::addConstraint(const int(&index)[d + 1], const T(&barycent
 	constraint.m_stiffness = stiffness;
 	constraint.m_stressLimit = limit;
 	
-	std::cout << "DEBUG: Adding constraint with stiffness=" << stiffness << ", stress limit=" << limit << std::endl;
-	
+	if (PDTET_TELEMETRY_ON(Verbose))
+		std::cout << "Adding constraint with stiffness=" << stiffness << ", stress limit=" << limit << std::endl;
+
 	for (int v = 0; v < d; v++)
 		constraint.m_xT(v + 1) = hookPosition[v];
 
-	m_gridDeformer.m_constraints.push_back(constraint);
-
 	if (index[0] > m_gridDeformer.m_X.size() || index[0] < 0)
 		throw std::logic_error("index out of range");
 
-	return (int)m_gridDeformer.m_constraints.size() - 1;
+	return m_gridDeformer.addConstraint(constraint);
 }
 
 // template instantiation
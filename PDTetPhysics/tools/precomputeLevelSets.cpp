@@ -0,0 +1,32 @@
+//#####################################################################
+// Copyright (c) 2019, Eftychios Sifakis, Yutian Tao, Qisi Wang
+// Distributed under the FreeBSD license (see license.txt)
+//#####################################################################
+// Writes the .sdf level set caches MergedLevelSet would otherwise compute on first load.
+// usage: precomputeLevelSets [-dx spacing] proxy.obj ...
+// The spacing must match the one the application loads with (pdTetPhysics uses 0.03).
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "MergedLevelSet.h"
+
+int main(int argc, char** argv)
+{
+	float dx = 0.03f;
+	int failures = 0, files = 0;
+	for (int i = 1; i < argc; i++) {
+		if (!std::strcmp(argv[i], "-dx") && i + 1 < argc) {
+			dx = float(std::atof(argv[++i]));
+			continue;
+		}
+		files++;
+		if (!PhysBAM::MergedLevelSet<PhysBAM::VECTOR<float, 3>>::precomputeLevelSet(argv[i], dx)) {
+			std::cerr << "unable to precompute level set of " << argv[i] << std::endl;
+			failures++;
+		}
+	}
+	if (!files)
+		std::cerr << "usage: " << argv[0] << " [-dx spacing] proxy.obj ..." << std::endl;
+	return failures || !files ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -17,6 +17,7 @@
 #include <PhysBAM_Geometry/Grids_Uniform_Level_Sets/LEVELSET_3D.h>
 #include <PhysBAM_Geometry/Spatial_Acceleration/TRIANGLE_HIERARCHY.h>
 #include <PhysBAM_Geometry/Topology_Based_Geometry/TRIANGULATED_SURFACE.h>
+#include <algorithm>
 using namespace PhysBAM;
 //#####################################################################
 // Function Process_Segment
@@ -35,6 +36,156 @@ static void Process_Segment(const int m,const ARRAY<bool,VECTOR<int,3> >& edge_i
             for(t[axis]=segment_start;t[axis]<=segment_end;t[axis]++) vote(t)+=vote_increment;}}
 }
 //#####################################################################
+// Narrow band tiles
+//#####################################################################
+// Grid nodes are grouped into cubic tiles and every triangle is binned to the tiles its rasterization index box overlaps, so
+// distance queries only look at the triangles in the rings of tiles around the query node.
+namespace{
+const int narrow_band_tile_size=8;
+template<class T> struct NARROW_BAND_TILES
+{
+    typedef VECTOR<int,3> TV_INT;typedef VECTOR<T,3> TV;
+    const TRIANGULATED_SURFACE<T>& surface;
+    const GRID<TV>& grid;
+    TV_INT counts;
+    ARRAY<int> offsets,triangles; // triangles binned to tile t are triangles(offsets(t+1)+1..offsets(t+2)), in ascending order
+    ARRAY<RANGE<TV_INT> > index_boxes; // rasterization index box of each triangle, empty if it misses the grid
+
+    NARROW_BAND_TILES(const TRIANGULATED_SURFACE<T>& surface_input,const GRID<TV>& grid_input,const T surface_padding_for_flood_fill,const T surface_thickness_over_two)
+        :surface(surface_input),grid(grid_input),counts((grid.counts+narrow_band_tile_size-1)/narrow_band_tile_size)
+    {
+        const ARRAY<TRIANGLE_3D<T> >& triangle_list=*surface.triangle_list;
+        index_boxes.Resize(triangle_list.m);offsets.Resize(counts.Product()+2);
+        for(int t=1;t<=triangle_list.m;t++){
+            TRIANGLE_3D<T> enlarged_triangle=triangle_list(t);if(surface_padding_for_flood_fill) enlarged_triangle.Change_Size(surface_padding_for_flood_fill);
+            RANGE<TV> triangle_bounding_box=enlarged_triangle.Bounding_Box();
+            triangle_bounding_box.Change_Size(surface_thickness_over_two);
+            if(!grid.domain.Lazy_Intersection(triangle_bounding_box)){index_boxes(t)=RANGE<TV_INT>(TV_INT(1,1,1),TV_INT());continue;}
+            index_boxes(t)=RANGE<TV_INT>(grid.Clamped_Index(triangle_bounding_box.Minimum_Corner()),grid.Clamped_Index_End_Minus_One(triangle_bounding_box.Maximum_Corner())+TV_INT(1,1,1));
+            RANGE<TV_INT> tile_box=Tiles(index_boxes(t));
+            for(int i=tile_box.min_corner.x;i<=tile_box.max_corner.x;i++) for(int j=tile_box.min_corner.y;j<=tile_box.max_corner.y;j++) for(int k=tile_box.min_corner.z;k<=tile_box.max_corner.z;k++)
+                offsets(Id(TV_INT(i,j,k))+2)++;}
+        for(int t=3;t<=offsets.m;t++) offsets(t)+=offsets(t-1);
+        triangles.Resize(offsets(offsets.m));
+        ARRAY<int> fill(offsets);
+        for(int t=1;t<=triangle_list.m;t++){
+            if(index_boxes(t).Empty()) continue;
+            RANGE<TV_INT> tile_box=Tiles(index_boxes(t));
+            for(int i=tile_box.min_corner.x;i<=tile_box.max_corner.x;i++) for(int j=tile_box.min_corner.y;j<=tile_box.max_corner.y;j++) for(int k=tile_box.min_corner.z;k<=tile_box.max_corner.z;k++)
+                triangles(++fill(Id(TV_INT(i,j,k))+1))=t;}
+    }
+
+    int Id(const TV_INT& tile) const // tiles are 0-based
+    {return tile.x+counts.x*(tile.y+counts.y*tile.z);}
+
+    RANGE<TV_INT> Tiles(const RANGE<TV_INT>& nodes) const
+    {return RANGE<TV_INT>((nodes.min_corner-1)/narrow_band_tile_size,(nodes.max_corner-1)/narrow_band_tile_size);}
+
+    RANGE<TV_INT> Nodes(const TV_INT& tile) const
+    {return RANGE<TV_INT>(tile*narrow_band_tile_size+1,TV_INT::Componentwise_Min((tile+1)*narrow_band_tile_size,grid.counts));}
+
+    bool Empty(const TV_INT& tile) const
+    {int id=Id(tile);return offsets(id+2)==offsets(id+1);}
+
+    // Appends the triangles binned to the tiles exactly ring tiles away from tile, sorted and without duplicates.
+    void Ring_Triangles(const TV_INT& tile,const int ring,ARRAY<int>& ring_triangles) const
+    {
+        ring_triangles.Remove_All();
+        RANGE<TV_INT> ring_box(TV_INT::Componentwise_Max(tile-ring,TV_INT()),TV_INT::Componentwise_Min(tile+ring,counts-1));
+        for(int i=ring_box.min_corner.x;i<=ring_box.max_corner.x;i++) for(int j=ring_box.min_corner.y;j<=ring_box.max_corner.y;j++) for(int k=ring_box.min_corner.z;k<=ring_box.max_corner.z;k++){
+            TV_INT offset=TV_INT(i,j,k)-tile;
+            if(offset.Max_Abs()!=ring) continue;
+            int id=Id(TV_INT(i,j,k));
+            for(int t=offsets(id+1)+1;t<=offsets(id+2);t++) ring_triangles.Append(triangles(t));}
+        if(!ring_triangles.m) return;
+        std::sort(&ring_triangles(1),&ring_triangles(1)+ring_triangles.m);
+        int unique=1;
+        for(int t=2;t<=ring_triangles.m;t++) if(ring_triangles(t)!=ring_triangles(unique)) ring_triangles(++unique)=ring_triangles(t);
+        ring_triangles.Resize(unique);
+    }
+
+    // Exact distance from the nodes of tile whose phi equals unset to the closest triangle, found ring by ring. A node is settled once no
+    // triangle beyond the rings searched can be closer; nodes still open after max_ring are left unset unless every ring has been searched.
+    // Ties go to the lowest triangle index, so the result doesn't depend on the order tiles are processed in.
+    void Distances(const TV_INT& tile,const int max_ring,const T unset,ARRAY<T,TV_INT>& phi,ARRAY<int,TV_INT>* closest_triangle_index) const
+    {
+        const ARRAY<TRIANGLE_3D<T> >& triangle_list=*surface.triangle_list;
+        ARRAY<TV_INT> open;ARRAY<T> distance_squared;ARRAY<int> closest;ARRAY<int> ring_triangles;ARRAY<RANGE<TV> > boxes;
+        RANGE<TV_INT> nodes=Nodes(tile);
+        for(int i=nodes.min_corner.x;i<=nodes.max_corner.x;i++) for(int j=nodes.min_corner.y;j<=nodes.max_corner.y;j++) for(int k=nodes.min_corner.z;k<=nodes.max_corner.z;k++)
+            if(phi(i,j,k)==unset) open.Append(TV_INT(i,j,k));
+        distance_squared.Resize(open.m,false);ARRAYS_COMPUTATIONS::Fill(distance_squared,(T)FLT_MAX);closest.Resize(open.m);
+        const T sign=unset>0?(T)1:(T)-1;
+        bool exhaustive=max_ring>=counts.Max();
+        for(int ring=0;ring<=max_ring && open.m;ring++){
+            Ring_Triangles(tile,ring,ring_triangles);
+            boxes.Resize(ring_triangles.m,false,false);
+            for(int t=1;t<=ring_triangles.m;t++) boxes(t)=triangle_list(ring_triangles(t)).Bounding_Box();
+            T settled=sqr(ring*narrow_band_tile_size*grid.min_dX);
+            bool last=ring==max_ring && exhaustive;
+            for(int n=open.m;n>=1;n--){
+                TV X=grid.X(open(n)),weights;
+                for(int t=1;t<=ring_triangles.m;t++){
+                    if((X-boxes(t).Clamp(X)).Magnitude_Squared()>distance_squared(n)) continue;
+                    T d2=(X-triangle_list(ring_triangles(t)).Closest_Point(X,weights)).Magnitude_Squared();
+                    if(d2<distance_squared(n) || (d2==distance_squared(n) && ring_triangles(t)<closest(n))){distance_squared(n)=d2;closest(n)=ring_triangles(t);}}
+                if(distance_squared(n)<=settled || last){
+                    if(closest(n)){phi(open(n))=sign*sqrt(distance_squared(n));if(closest_triangle_index) (*closest_triangle_index)(open(n))=closest(n);}
+                    open.Remove_Index_Lazy(n);distance_squared.Remove_Index_Lazy(n);closest.Remove_Index_Lazy(n);}}}
+    }
+
+    // Exact distances of the nodes within band_width cells of the surface, and the edges it blocks for the flood fill.
+    void Rasterize(const int band_width,ARRAY<T,TV_INT>& phi,ARRAY<int,TV_INT>* closest_triangle_index,const bool block_edges,ARRAY<bool,TV_INT>& edge_is_blocked_x,
+        ARRAY<bool,TV_INT>& edge_is_blocked_y,ARRAY<bool,TV_INT>& edge_is_blocked_z,const T surface_padding_for_flood_fill,const T surface_thickness_over_two) const
+    {
+        int band_rings=(band_width+narrow_band_tile_size-1)/narrow_band_tile_size;
+        ARRAY<bool,TV_INT> in_band(RANGE<TV_INT>(TV_INT(),counts-1));ARRAY<TV_INT> band_tiles;
+        for(int i=0;i<counts.x;i++) for(int j=0;j<counts.y;j++) for(int k=0;k<counts.z;k++) if(!Empty(TV_INT(i,j,k))){
+            RANGE<TV_INT> ring_box(TV_INT::Componentwise_Max(TV_INT(i,j,k)-band_rings,TV_INT()),TV_INT::Componentwise_Min(TV_INT(i,j,k)+band_rings,counts-1));
+            for(int ii=ring_box.min_corner.x;ii<=ring_box.max_corner.x;ii++) for(int jj=ring_box.min_corner.y;jj<=ring_box.max_corner.y;jj++) for(int kk=ring_box.min_corner.z;kk<=ring_box.max_corner.z;kk++)
+                if(!in_band(ii,jj,kk)){in_band(ii,jj,kk)=true;band_tiles.Append(TV_INT(ii,jj,kk));}}
+#pragma omp parallel for schedule(dynamic)
+        for(int b=1;b<=band_tiles.m;b++){
+            Distances(band_tiles(b),band_rings,(T)FLT_MAX,phi,closest_triangle_index);
+            if(block_edges) Block_Edges(band_tiles(b),surface_padding_for_flood_fill,surface_thickness_over_two,edge_is_blocked_x,edge_is_blocked_y,edge_is_blocked_z);}
+    }
+
+    // After the sign is known: exact distances of the inside nodes beyond the band, and the outside ones clamped to it.
+    void Finish_Band(const int band_width,ARRAY<T,TV_INT>& phi,ARRAY<int,TV_INT>* closest_triangle_index) const
+    {
+        ARRAY<TV_INT> deep_tiles;
+        for(int i=0;i<counts.x;i++) for(int j=0;j<counts.y;j++) for(int k=0;k<counts.z;k++){
+            RANGE<TV_INT> nodes=Nodes(TV_INT(i,j,k));bool deep=false;
+            for(int ii=nodes.min_corner.x;ii<=nodes.max_corner.x && !deep;ii++) for(int jj=nodes.min_corner.y;jj<=nodes.max_corner.y && !deep;jj++) for(int kk=nodes.min_corner.z;kk<=nodes.max_corner.z && !deep;kk++)
+                deep=phi(ii,jj,kk)==-FLT_MAX;
+            if(deep) deep_tiles.Append(TV_INT(i,j,k));}
+#pragma omp parallel for schedule(dynamic)
+        for(int b=1;b<=deep_tiles.m;b++) Distances(deep_tiles(b),counts.Max(),-(T)FLT_MAX,phi,closest_triangle_index);
+        T band=(band_width+narrow_band_tile_size-1)/narrow_band_tile_size*narrow_band_tile_size*grid.min_dX;
+        for(int i=1;i<=grid.counts.x;i++) for(int j=1;j<=grid.counts.y;j++) for(int k=1;k<=grid.counts.z;k++) phi(i,j,k)=min(phi(i,j,k),band);
+    }
+
+    // Blocks the grid edges owned by tile, those whose higher node is in it, that are crossed by a triangle binned to it.
+    void Block_Edges(const TV_INT& tile,const T surface_padding_for_flood_fill,const T surface_thickness_over_two,ARRAY<bool,TV_INT>& edge_is_blocked_x,ARRAY<bool,TV_INT>& edge_is_blocked_y,
+        ARRAY<bool,TV_INT>& edge_is_blocked_z) const
+    {
+        const ARRAY<TRIANGLE_3D<T> >& triangle_list=*surface.triangle_list;
+        RANGE<TV_INT> nodes=Nodes(tile);
+        int id=Id(tile);
+        for(int b=offsets(id+1)+1;b<=offsets(id+2);b++){
+            int t=triangles(b);
+            TRIANGLE_3D<T> enlarged_triangle=triangle_list(t);if(surface_padding_for_flood_fill) enlarged_triangle.Change_Size(surface_padding_for_flood_fill);
+            TV_INT min_index=TV_INT::Componentwise_Max(index_boxes(t).min_corner,nodes.min_corner),max_index=TV_INT::Componentwise_Min(index_boxes(t).max_corner,nodes.max_corner);
+            for(int i=max(min_index.x,index_boxes(t).min_corner.x+1);i<=max_index.x;i++) for(int j=min_index.y;j<=max_index.y;j++) for(int k=min_index.z;k<=max_index.z;k++)
+                if(!edge_is_blocked_x(i,j,k)) edge_is_blocked_x(i,j,k)=INTERSECTION::Intersects(SEGMENT_3D<T>(grid.X(i,j,k),grid.X(i-1,j,k)),enlarged_triangle,surface_thickness_over_two);
+            for(int i=min_index.x;i<=max_index.x;i++) for(int j=max(min_index.y,index_boxes(t).min_corner.y+1);j<=max_index.y;j++) for(int k=min_index.z;k<=max_index.z;k++)
+                if(!edge_is_blocked_y(i,j,k)) edge_is_blocked_y(i,j,k)=INTERSECTION::Intersects(SEGMENT_3D<T>(grid.X(i,j,k),grid.X(i,j-1,k)),enlarged_triangle,surface_thickness_over_two);
+            for(int i=min_index.x;i<=max_index.x;i++) for(int j=min_index.y;j<=max_index.y;j++) for(int k=max(min_index.z,index_boxes(t).min_corner.z+1);k<=max_index.z;k++)
+                if(!edge_is_blocked_z(i,j,k)) edge_is_blocked_z(i,j,k)=INTERSECTION::Intersects(SEGMENT_3D<T>(grid.X(i,j,k),grid.X(i,j,k-1)),enlarged_triangle,surface_thickness_over_two);}
+    }
+};
+}
+//#####################################################################
 // Function Compute_Level_Set
 //#####################################################################
 // Assumes triangulated surface is closed
@@ -76,14 +227,17 @@ Compute_Level_Set(TRIANGULATED_SURFACE<T>& triangulated_surface,GRID<TV>& grid,A
     ARRAY<int,TV_INT> closest_triangle_index;
     if(store_closest_triangle_index) closest_triangle_index.Resize(grid.Domain_Indices());
 
-    bool store_initialized_indices=use_fmm;
+    bool exact_narrow_band=exact_band_width>0 && compute_signed_distance_function && !compute_velocity && !use_orthogonal_vote && !phi_offset;
+    bool store_initialized_indices=use_fmm && !exact_narrow_band;
     if(store_initialized_indices){initialized_indices.Exact_Resize(0);initialized_indices.Preallocate(20);}
 
     const T surface_thickness_over_two=Surface_Thickness_Over_Two(grid),surface_padding_for_flood_fill=Surface_Padding_For_Flood_Fill(grid);
 
     const BOX<TV>& grid_domain=grid.domain;
-    if(verbose) LOG::Time("Rasterizing Triangles");
-    for(int t=1;t<=triangulated_surface.mesh.elements.m;t++){
+    if(verbose) LOG::Time(exact_narrow_band?"Rasterizing Narrow Band":"Rasterizing Triangles");
+    if(exact_narrow_band) NARROW_BAND_TILES<T>(triangulated_surface,grid,surface_padding_for_flood_fill,surface_thickness_over_two).Rasterize(exact_band_width,phi,
+        store_closest_triangle_index?&closest_triangle_index:0,need_flood_fill,edge_is_blocked_x,edge_is_blocked_y,edge_is_blocked_z,surface_padding_for_flood_fill,surface_thickness_over_two);
+    else for(int t=1;t<=triangulated_surface.mesh.elements.m;t++){
         const TRIANGLE_3D<T>& triangle=(*triangulated_surface.triangle_list)(t);
         TRIANGLE_3D<T> enlarged_triangle=triangle;if(surface_padding_for_flood_fill) enlarged_triangle.Change_Size(surface_padding_for_flood_fill);
         RANGE<TV> triangle_bounding_box=enlarged_triangle.Bounding_Box();
@@ -108,7 +262,8 @@ Compute_Level_Set(TRIANGULATED_SURFACE<T>& triangulated_surface,GRID<TV>& grid,A
             for(int i=min_index.x;i<=max_index.x;i++) for(int j=min_index.y;j<=max_index.y;j++) for(int k=min_index.z+1;k<=max_index.z;k++)
                 if(!edge_is_blocked_z(i,j,k)) edge_is_blocked_z(i,j,k)=INTERSECTION::Intersects(SEGMENT_3D<T>(grid.X(i,j,k),grid.X(i,j,k-1)),enlarged_triangle,surface_thickness_over_two);}}
 
-    if((compute_signed_distance_function || compute_unsigned_distance_function) && use_fmm && fmm_stopping_distance)
+    if(exact_narrow_band);
+    else if((compute_signed_distance_function || compute_unsigned_distance_function) && use_fmm && fmm_stopping_distance)
         for(int i=1;i<=grid.counts.x;i++) for(int j=1;j<=grid.counts.y;j++) for(int k=1;k<=grid.counts.z;k++) phi(i,j,k)=min(phi(i,j,k),fmm_stopping_distance);
     else if(compute_heaviside_function) phi.Fill(grid.dX.Max());
 
@@ -209,6 +364,10 @@ Compute_Level_Set(TRIANGULATED_SURFACE<T>& triangulated_surface,GRID<TV>& grid,A
                 for(int i=1;i<=number_of_colors;i++) color_is_inside(i)=!color_is_inside(i);}}
         for(int i=1;i<=grid.counts.x;i++) for(int j=1;j<=grid.counts.y;j++) for(int k=1;k<=grid.counts.z;k++) if(color_is_inside(colors(i,j,k))) phi(i,j,k)*=-1;}
 
+    if(exact_narrow_band){
+        if(verbose) LOG::Time("Distances Of Deep Inside Nodes");
+        NARROW_BAND_TILES<T>(triangulated_surface,grid,surface_padding_for_flood_fill,surface_thickness_over_two).Finish_Band(exact_band_width,phi,store_closest_triangle_index?&closest_triangle_index:0);}
+
     if(positive_boundary_band){
         RANGE<TV> clip(grid.X_plus_half(TV_INT()+positive_boundary_band),grid.X_plus_half(grid.counts-positive_boundary_band));
         for(int j=1;j<=grid.counts.y;j++) for(int k=1;k<=grid.counts.z;k++){
@@ -223,7 +382,7 @@ Compute_Level_Set(TRIANGULATED_SURFACE<T>& triangulated_surface,GRID<TV>& grid,A
             for(int k=1;k<=positive_boundary_band+1;k++) phi(i,j,k)=max(phi(i,j,k),clip.min_corner.z-grid.Axis_X(k,3));
             for(int k=grid.counts.z-positive_boundary_band;k<=grid.counts.z;k++) phi(i,j,k)=max(phi(i,j,k),grid.Axis_X(k,3)-clip.max_corner.z);}}
 
-    if(use_fmm && (compute_unsigned_distance_function || compute_signed_distance_function)){
+    if(use_fmm && !exact_narrow_band && (compute_unsigned_distance_function || compute_signed_distance_function)){
         for(int i=1;i<=grid.counts.x;i++) for(int j=1;j<=grid.counts.y;j++) for(int k=1;k<=grid.counts.z;k++) 
             phi(i,j,k)=clamp(phi(i,j,k),-10*grid.min_dX,10*grid.min_dX); // clamp away from FLT_MAX to avoid floating point exceptions
         if(verbose) LOG::Time(STRING_UTILITIES::string_sprintf("Fast Marching (one sided band width=%f)",fmm_one_sided_band_width));
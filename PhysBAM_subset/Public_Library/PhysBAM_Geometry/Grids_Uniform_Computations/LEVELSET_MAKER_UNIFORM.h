@@ -20,7 +20,7 @@ class LEVELSET_MAKER_UNIFORM:public LEVELSET_MAKER<T>
     typedef VECTOR<int,3> TV_INT;typedef VECTOR<T,3> TV;
 
     using BASE::verbose;using BASE::compute_signed_distance_function;using BASE::compute_unsigned_distance_function;using BASE::compute_heaviside_function;
-    using BASE::use_fmm;using BASE::fmm_one_sided_band_width;using BASE::extrapolate_velocity;using BASE::velocity_extrapolation_one_sided_band_width;
+    using BASE::use_fmm;using BASE::fmm_one_sided_band_width;using BASE::exact_band_width;using BASE::extrapolate_velocity;using BASE::velocity_extrapolation_one_sided_band_width;
     using BASE::only_boundary_region_is_outside;using BASE::keep_only_largest_inside_region;using BASE::flip_sign_if_corners_are_inside;
     using BASE::surface_thickness_or_zero;using BASE::surface_padding_for_flood_fill_or_negative;using BASE::initialized_indices;
     using BASE::initialized_indices_octree;using BASE::write_debug_data;using BASE::write_debug_path;using BASE::path_start_node;using BASE::path_end_node;
@@ -23,6 +23,7 @@ public:
     bool compute_signed_distance_function,compute_unsigned_distance_function,compute_heaviside_function;
     bool use_fmm;
     T fmm_one_sided_band_width; // in number of cells (if zero then compute phi everywhere)
+    int exact_band_width; // in number of cells (if zero then use fast marching)
     bool extrapolate_velocity;
     T velocity_extrapolation_one_sided_band_width; // in number of cells
     bool only_boundary_region_is_outside;
@@ -47,6 +48,7 @@ public:
         Write_Debug_Path(false);
         Compute_Signed_Distance_Function();
         Use_Fast_Marching_Method();
+        Use_Exact_Narrow_Band(0);
         Extrapolate_Velocity(false);
         Only_Boundary_Region_Is_Outside(false);
         Keep_Only_Largest_Inside_Region(false);
@@ -81,6 +83,11 @@ public:
     void Use_Fast_Marching_Method(const bool use_fmm_input=true,const T fmm_one_sided_band_width_input=0)
     {use_fmm=use_fmm_input;if(use_fmm)fmm_one_sided_band_width=fmm_one_sided_band_width_input;}
 
+    // Signed distance only: exact distances within band_width cells of the surface and at every inside node, computed in parallel
+    // without fast marching. Outside nodes beyond the band are clamped to the band width. Ignored with velocity, orthogonal vote or phi offset.
+    void Use_Exact_Narrow_Band(const int exact_band_width_input=8)
+    {exact_band_width=exact_band_width_input;}
+
     void Extrapolate_Velocity(const bool extrapolate_velocity_input=true,const T velocity_extrapolation_one_sided_band_width_input=3)
     {extrapolate_velocity=extrapolate_velocity_input;if(extrapolate_velocity)velocity_extrapolation_one_sided_band_width=velocity_extrapolation_one_sided_band_width_input;}
 
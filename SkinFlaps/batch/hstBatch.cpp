@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////
+// File: hstBatch.cpp
+// Date: 10/16/2026
+// Purpose: Replays a surgical history (.hst) without user interaction, running a fixed number of physics solves after every action,
+//     and writes a JSON timing report.  This is the regression benchmark over the shipped histories.
+//     Graphics run in gl3wGraphics null mode, so no window, display or GL context is needed.
+//     The report includes a hash of the final lattice (_tetNodes and _nodeGridLoci).  With deterministic tet numbering, the default,
+//     two replays of the same history report the same hash.  Pass 0 for deterministic to time the thread order numbering instead.
+//  usage: SkinFlapsBatch modelDirectory historyFile.hst [solvesPerAction] [report.json] [deterministic]
+////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <functional>
+#include "surgicalActions.h"
+#include <gl3wGraphics.h>
+#include "FacialFlapsGui.h"
+#include "json.h"
+#include "prettyPrintJSON.h"
+
+FacialFlapsGui ffg;
+
+namespace {
+
+	typedef std::chrono::steady_clock benchClock;
+
+	inline double secondsSince(const benchClock::time_point& start) {
+		return std::chrono::duration<double>(benchClock::now() - start).count();
+	}
+
+	struct phaseTime {
+		int count = 0;
+		double seconds = 0.0;
+	};
+
+	template <class T>
+	void hashBytes(const std::vector<T>& v, unsigned long long& hash) {  // FNV-1a
+		const unsigned char* c = reinterpret_cast<const unsigned char*>(v.data());
+		for (size_t n = v.size() * sizeof(T), i = 0; i < n; ++i) {
+			hash ^= c[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	std::string actionCategory(const std::string& action) {
+		if (action == "makeIncision" || action == "makeDeepCut")
+			return "incision";
+		if (action == "undermine" || action == "periostealUndermine")
+			return "undermine";
+		if (action == "addHook" || action == "moveHook" || action == "deleteHook")
+			return "hook";
+		if (action == "addSuture" || action == "deleteSuture" || action == "promoteSutureApproximations")
+			return "suture";
+		if (action == "loadSceneFile")
+			return "loadScene";
+		return action;  // excise, pausePhysics
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		puts("usage: SkinFlapsBatch modelDirectory historyFile.hst [solvesPerAction] [report.json] [deterministic]\n");
+		return 1;
+	}
+	std::string modelDirectory(argv[1]), historyPath(argv[2]), reportPath;
+	if (modelDirectory.back() != '/' && modelDirectory.back() != '\\')
+		modelDirectory.push_back('/');
+	size_t slash = historyPath.find_last_of("/\\");
+	std::string historyDirectory = slash == std::string::npos ? std::string("./") : historyPath.substr(0, slash + 1);
+	std::string historyFile = slash == std::string::npos ? historyPath : historyPath.substr(slash + 1);
+	int solvesPerAction = argc > 3 ? atoi(argv[3]) : 10;
+	if (argc > 4)
+		reportPath = argv[4];
+	bool deterministic = argc > 5 ? atoi(argv[5]) != 0 : true;
+
+	PhysBAM::Telemetry::setLevel(PhysBAM::Telemetry::Level::Stats);  // solve iterations and factorization times
+	if (!ffg.initCleftSim(true)) {
+		puts("Failed to initialize cleft simulator.\n");
+		return 1;
+	}
+	surgicalActions* sa = ffg.getSurgicalActions();
+	bccTetScene* bts = sa->getBccTetScene();
+	bts->setDeterministicTetNumbering(deterministic);  // identical lattices run to run
+	bts->setExternalStepping(true);  // only the solves below, not whatever the simulation thread fits in between
+	sa->setShowHistorySteps(false);
+	sa->setModelDirectory(modelDirectory.c_str());
+
+	std::map<std::string, phaseTime> actions;
+	phaseTime solves, surfaceDraws;
+	long long solveIterations = 0;
+	int actionsRun = 0;
+	std::string error;
+	auto failed = [&]() ->bool {
+		if (!error.empty())
+			return true;
+		if (sa->taskThreadError)
+			error = sa->taskThreadErrorStr;
+		else if (FacialFlapsGui::user_message_flag)
+			error = FacialFlapsGui::userMessage();
+		return !error.empty();
+	};
+	// same main thread updates the interactive loop makes once the simulation thread has no command queued
+	auto updateGraphics = [&]() {
+		if (sa->newTopology) {
+			sa->getSurgGraphics()->setNewTopology();
+			sa->getSurgGraphics()->updatePositionsNormalsTangents();
+			sa->newTopology = false;
+		}
+		if (bts->forcesApplied()) {
+			auto start = benchClock::now();
+			sa->getSutures()->updateSutureGraphics();
+			bts->updateSurfaceDraw();
+			surfaceDraws.seconds += secondsSince(start);
+			++surfaceDraws.count;
+		}
+	};
+	auto runAction = [&](const std::string& name, std::function<void()> action) {
+		auto start = benchClock::now();
+		try {
+			action();
+			bts->waitForPhysics();  // topology changes finish on the simulation thread
+		}
+		catch (const std::exception& e) {
+			error = e.what();
+		}
+		phaseTime& pt = actions[actionCategory(name)];
+		pt.seconds += secondsSince(start);
+		++pt.count;
+		++actionsRun;
+		if (!failed())
+			updateGraphics();
+	};
+	auto runPhysics = [&]() {
+		if (!bts->forcesApplied() || bts->isPhysicsPaused() || !bts->getPdTetPhysics_2()->solverInitialized())
+			return;
+		PhysBAM::SolveStats<float> stats;
+		for (int i = 0; i < solvesPerAction && error.empty(); ++i) {
+			auto start = benchClock::now();
+			try {
+				bts->updatePhysics();
+				bts->publishNodePositions();
+			}
+			catch (const std::exception& e) {
+				error = e.what();
+			}
+			solves.seconds += secondsSince(start);
+			++solves.count;
+			while (bts->getPdTetPhysics_2()->popSolveStats(stats))
+				solveIterations += stats.m_steps;
+			updateGraphics();  // collision detection uses the embedded surface
+		}
+	};
+
+	auto totalStart = benchClock::now();
+	runAction("loadSceneFile", [&]() {
+		if (!sa->loadHistory(historyDirectory.c_str(), historyFile.c_str()))
+			error = "Couldn't load history file " + historyPath;
+	});
+	while (!failed() && !sa->historyFinished()) {
+		runAction(sa->nextHistoryActionName(), [&]() { sa->nextHistoryAction(); });
+		if (!failed())
+			runPhysics();
+	}
+	double totalSeconds = secondsSince(totalStart);
+
+	json::Object report, actionObj, physicsObj, factorObj;
+	report["history"] = historyFile;
+	report["solvesPerAction"] = solvesPerAction;
+	report["completed"] = error.empty();
+	if (!error.empty())
+		report["error"] = error;
+	report["actionsRun"] = actionsRun;
+	report["totalSeconds"] = totalSeconds;
+	for (auto& a : actions) {
+		json::Object pt;
+		pt["count"] = a.second.count;
+		pt["seconds"] = a.second.seconds;
+		actionObj[a.first] = pt;
+	}
+	report["actions"] = actionObj;
+	report["cutterSeconds"] = bts->cutterSeconds();
+	report["deterministicTetNumbering"] = deterministic;
+	vnBccTetrahedra* vbt = bts->getVirtualNodedBccTetrahedra();
+	std::vector<std::array<short, 3> > nodeLoci;
+	nodeLoci.reserve(vbt->nodeNumber());
+	for (int n = vbt->nodeNumber(), i = 0; i < n; ++i)
+		nodeLoci.push_back(vbt->nodeGridLocation(i));
+	unsigned long long latticeHash = 1469598103934665603ULL;
+	hashBytes(vbt->getTetNodeArray(), latticeHash);
+	hashBytes(nodeLoci, latticeHash);
+	char hashStr[20];
+	snprintf(hashStr, sizeof(hashStr), "%016llx", latticeHash);
+	report["tets"] = (int)vbt->getTetNodeArray().size();
+	report["nodes"] = vbt->nodeNumber();
+	report["latticeHash"] = std::string(hashStr);
+	const PhysBAM::FactorizationStats& fs = bts->getPdTetPhysics_2()->factorizationStats();
+	factorObj["count"] = fs.m_factorizations;
+	factorObj["seconds"] = fs.m_factorSeconds;
+	factorObj["updates"] = fs.m_reFactorizations;
+	factorObj["updateSeconds"] = fs.m_reFactorSeconds;
+	report["factorization"] = factorObj;
+	physicsObj["solves"] = solves.count;
+	physicsObj["seconds"] = solves.seconds;
+	physicsObj["iterations"] = (double)solveIterations;
+	physicsObj["solvesPerSecond"] = solves.seconds > 0.0 ? solves.count / solves.seconds : 0.0;
+	physicsObj["iterationsPerSecond"] = solves.seconds > 0.0 ? solveIterations / solves.seconds : 0.0;
+	report["physics"] = physicsObj;
+	report["surfaceDrawSeconds"] = surfaceDraws.seconds;
+
+	std::string ppStr;
+	prettyPrintJSON pp;
+	pp.convert(json::Serialize(report).c_str(), ppStr);
+	if (reportPath.empty())
+		std::cout << ppStr << std::endl;
+	else {
+		std::ofstream outf(reportPath.c_str());
+		if (!outf.is_open()) {
+			std::cerr << "Can't write report to " << reportPath << std::endl;
+			error = "report";
+		}
+		else
+			outf << ppStr;
+	}
+	bts->setPhysicsPause(true);
+	bts->getSimulationThread()->stop();
+	return error.empty() ? 0 : 2;
+}
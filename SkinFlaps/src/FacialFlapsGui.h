@@ -312,10 +312,15 @@ public:
 		glfwTerminate();
 	}
 
-	static bool initCleftSim() {
+	static bool initCleftSim(const bool nullGraphics = false) {  // null graphics needs no window or GL context, for batch runs
 		csgToolstate = 0;
+		gl3wGraphics::setNullGraphics(nullGraphics);
 		igGl3w.initializeGraphics();
 		igSurgAct.setGl3wGraphics(&igGl3w);
+		if (nullGraphics) {
+			igGl3w.setViewport(0, 0, 1280, 720);
+			return true;
+		}
 		glfwSetMouseButtonCallback(FFwindow, &mouse_button_callback);
 		glfwSetCursorPosCallback(FFwindow, &cursor_position_callback);
 		glfwSetScrollCallback(FFwindow, mouse_wheel_callback);
@@ -337,11 +342,13 @@ public:
 		return true;
 	}
 
-	static bool initImguiGlfw() {
+	static bool initImguiGlfw(const bool hiddenWindow = false) {  // hidden only provides the GL context for batch runs
 		// Setup window
 		glfwSetErrorCallback(&glfw_error_callback);
 		if (!glfwInit())
 			return false;
+		if (hiddenWindow)
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 		// Decide GL+GLSL versions
 #ifdef __APPLE__
@@ -356,7 +363,7 @@ public:
 		const char* glsl_version = "#version 130";
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-		glfwWindowHint(GLFW_MAXIMIZED, GLFW_TRUE);
+		glfwWindowHint(GLFW_MAXIMIZED, hiddenWindow ? GLFW_FALSE : GLFW_TRUE);
 		//glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
 		//glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // 3.0+ only
 #endif
@@ -366,7 +373,7 @@ public:
 		if (FFwindow == NULL)
 			return false;
 		glfwMakeContextCurrent(FFwindow);
-		glfwSwapInterval(1); // Enable vsync
+		glfwSwapInterval(hiddenWindow ? 0 : 1); // Enable vsync
 
 		// Initialize OpenGL loader
 #if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
@@ -471,6 +478,8 @@ public:
 		user_message_flag = true;
 	}
 
+	static const std::string& userMessage() { return user_message; }
+
 	static void handleThrow(const char* message) {
 		user_message = message;
 		std::string errHist = historyDirectory + "ERROR.hst";
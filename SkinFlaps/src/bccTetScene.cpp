@@ -24,7 +24,9 @@
 #include "json.h"
 #include "closestPointOnTriangle.h"
 #include "remapTetPhysics.h"
+#include "tbb/tbb.h"
 #include <iostream>
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <ctime>
@@ -33,6 +35,7 @@
 bool bccTetScene::loadScene(const char *dataDirectory, const char *sceneFileName)
 {
 	_physicsPaused = true;
+	_sim.waitIdle();
 	std::string path(dataDirectory);
 	path.append(sceneFileName);
 	std::ifstream istr(path.c_str());
@@ -276,7 +279,9 @@ bool bccTetScene::loadScene(const char *dataDirectory, const char *sceneFileName
 void bccTetScene::updateOldPhysicsLattice()
 {
 		_rtp.getOldPhysicsData(&_vnTets);  // must be done before any new incisions.  Worst case example < 0.02 seconds - not worth multithreading.
+		auto cutStart = std::chrono::steady_clock::now();
 		_tc.addNewMultiresIncision();
+		_cutterSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - cutStart).count();
 
 #ifdef NO_PHYSICS
 	_firstSpatialCoords.assign(_vnTets.nodeNumber(), Vec3f());
@@ -298,7 +303,7 @@ void bccTetScene::updateOldPhysicsLattice()
 		std::array<float, 3>* nodeSpatialCoords = _ptp.createBccTetStructure_multires(_vnTets.getTetNodeArray(), tetSizeMult, (float)_vnTets.getTetUnitSize());
 		_vnTets.setNodeSpatialCoordinatePointer(nodeSpatialCoords);  // vector created in _ptp
 #endif
-		_rtp.remapNewPhysicsNodePositions(&_vnTets);  // requires node spatial coordinate array pointer. Worst case example < 0.02 seconds - not worth multithreading.
+		_rtp.remapNewPhysicsNodePositions(&_vnTets);  // requires node spatial coordinate array pointer. Multithreaded.
 		std::vector<int> subNodes;
 		std::vector<std::vector<int> > macroNodes;
 		std::vector<std::vector<float> > macroBarys;
@@ -310,6 +315,7 @@ void bccTetScene::updateOldPhysicsLattice()
 		initPdPhysics();
 		_tetsModified = true;
 	}
+	publishNodePositions();
 	_physicsPaused = false;
 }
 
@@ -318,7 +324,9 @@ void bccTetScene::createNewPhysicsLattice(int maxDimMegatetSubdivs, int nTetSize
 	try {
 		_tetsModified = false;
 		_tc.setRemapTetPhysics(&_rtp);
+		auto cutStart = std::chrono::steady_clock::now();
 		_tc.createFirstMacroTets(_mt, &_vnTets, nTetSizeLevels, maxDimMegatetSubdivs);
+		_cutterSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - cutStart).count();
 		_surgAct->getDeepCutPtr()->setVnBccTetrahedra(&_vnTets);
 		_surgAct->getDeepCutPtr()->setMaterialTriangles(_mt);
 
@@ -354,6 +362,7 @@ void bccTetScene::createNewPhysicsLattice(int maxDimMegatetSubdivs, int nTetSize
 		std::vector<std::vector<float> > macroBarys;
 		_vnTets.getTJunctionConstraints(subNodes, macroNodes, macroBarys);
 		_ptp.addInterNodeConstraints(subNodes, macroNodes, macroBarys);
+		publishNodePositions();
 
 		_tetsModified = false;
 		_physicsPaused = false;
@@ -384,32 +393,20 @@ void bccTetScene::initPdPhysics()
 #endif
 }
 
-void bccTetScene::updatePhysics()
+bool bccTetScene::updatePhysics()
 {
-	std::cout << "DEBUG: bccTetScene::updatePhysics() called" << std::endl;
-	
 	if (_vnTets.empty())
-		return;
+		return false;
+	bool moreWork = false;
 
 #ifndef NO_PHYSICS
 	if (_tetsModified || _forcesApplied) {
-		std::cout << "DEBUG: Running physics solve - tetsModified=" << _tetsModified << ", forcesApplied=" << _forcesApplied << std::endl;
-		
-		// MACOS PORT: Limit maximum force magnitude to prevent numerical instability
-		const float MAX_FORCE_MAGNITUDE = 100.0f;  // Reasonable limit based on observed stable forces
-		
-		// Check and report hook count (we can't directly limit forces in hooks)
-		auto hooks = _surgAct->getHooks();
-		if (hooks) {
-			int numHooks = hooks->getNumberOfHooks();
-			if (numHooks > 0) {
-				std::cout << "INFO: " << numHooks << " hooks active with spring constant " 
-				         << hooks->getSpringConstant() << std::endl;
-			}
+		{
+			std::lock_guard<std::mutex> lock(_surfaceMutex);
+			_tetCol.findSoftCollisionPairs();
 		}
-		
-		_tetCol.findSoftCollisionPairs();
-		_ptp.solve();
+		moreWork = !_ptp.solve();
+		_vnTets.spatialCoordinatesMoved();
 	}
 #endif
 
@@ -417,8 +414,42 @@ void bccTetScene::updatePhysics()
 	RenderHelper<float>::writeMesh(*_mt);
 	RenderHelper<float>::frame++;
 #endif
+	return moreWork;
 }
  
+bool bccTetScene::physicsStep()
+{  // Runs on the simulation thread whenever it has no command to do.  Once the solver converges the thread sleeps until a command,
+	// setForcesAppliedFlag() or setPhysicsPause(false) wakes it.
+	if (_physicsPaused || _externalStepping || !_forcesApplied || _vnTets.empty() || !_ptp.solverInitialized())
+		return false;
+	bool moreWork;
+	try {
+		moreWork = updatePhysics();
+		publishNodePositions();
+	}
+	catch (...) {
+		_physicsPaused = true;
+		_surgAct->taskThreadErrorStr = "Couldn't update physics after last action.";
+		_surgAct->taskThreadError = true;
+		return false;
+	}
+	return moreWork;
+}
+
+void bccTetScene::publishNodePositions()
+{
+	if (!_vnTets.empty())
+		_sim.publishPositions(_vnTets.getNodeSpatialCoordPointer(), _vnTets.nodeNumber());
+}
+
+const Vec3f* bccTetScene::renderNodePositions()
+{
+	const std::vector<Vec3f>& nodes = _sim.acquirePositions();
+	if ((int)nodes.size() == _vnTets.nodeNumber())
+		return nodes.data();
+	return _vnTets.getNodeSpatialCoordPointer();  // lattice replaced without publishing, so physics can't be running on it
+}
+
 bool bccTetScene::areVerticesConnectedWithoutCrossingIncisions(int v1, int v2)
 {
 	// MACOS PORT: Check if two vertices are connected through triangles without crossing material 3 (incision) boundaries
@@ -496,14 +527,33 @@ void bccTetScene::updateSurfaceDraw()
 	Vec3f valid_min = centerVec - extents * 10.0f;
 	Vec3f valid_max = centerVec + extents * 10.0f;
 
-	int nv;
+	const Vec3f* nodes = renderNodePositions();
+	std::lock_guard<std::mutex> lock(_surfaceMutex);
 	auto pArr = _mt->getPositionArrayPtr();
-	nv = pArr->size();
-	for (int i = 0; i < nv; ++i) {
-		if (_vnTets.getVertexTetrahedron(i) > -1) { // an excision may have occurred leaving an empty vertex
-			Vec3f& pos = pArr->at(i);
-			_vnTets.getBarycentricTetPosition(_vnTets.getVertexTetrahedron(i), *(_vnTets.getVertexWeight(i)), pos);
-
+	int nv = (int)pArr->size();
+	Vec3f* positions = pArr->data();
+	// Embedding is independent per vertex.  Bad positions are only flagged here and reported and clamped serially below,
+	// which should essentially never happen.
+	std::atomic<bool> invalid(false);
+	tbb::parallel_for(tbb::blocked_range<int>(0, nv), [&](const tbb::blocked_range<int>& r) {
+		bool bad = false;
+		for (int i = r.begin(); i != r.end(); ++i) {
+			int tet = _vnTets.getVertexTetrahedron(i);
+			if (tet < 0)  // an excision may have occurred leaving an empty vertex
+				continue;
+			Vec3f& pos = positions[i];
+			_vnTets.getBarycentricTetPosition(nodes, tet, *(_vnTets.getVertexWeight(i)), pos);
+			// also false for NaNs
+			bad |= !(pos.X >= valid_min.X && pos.X <= valid_max.X && pos.Y >= valid_min.Y && pos.Y <= valid_max.Y && pos.Z >= valid_min.Z && pos.Z <= valid_max.Z);
+		}
+		if (bad)
+			invalid.store(true, std::memory_order_relaxed);
+	});
+	if (invalid.load()) {
+		for (int i = 0; i < nv; ++i) {
+			if (_vnTets.getVertexTetrahedron(i) < 0)
+				continue;
+			Vec3f& pos = positions[i];
 			if (!std::isfinite(pos.X) || !std::isfinite(pos.Y) || !std::isfinite(pos.Z)) {
 				std::cerr << "ERROR: Vertex " << i << " position is NAN. Clamping." << std::endl;
 				pos = centerVec;
@@ -650,9 +700,10 @@ void bccTetScene::createTetLatticeDrawing()
 		return;
 	_nodeGraphicsPositions.clear();
 	_nodeGraphicsPositions.assign(_vnTets.nodeNumber() << 2, 1.0f);
+	const Vec3f* nodes = renderNodePositions();
 	GLfloat *ngp = &_nodeGraphicsPositions[0];
 	for (int n = _vnTets.nodeNumber(), i = 0; i < n; ++i){
-		const float *fp = _vnTets.nodeSpatialCoordinatePtr(i);
+		const float *fp = nodes[i].xyz;
 		*(ngp++) = fp[0];
 		*(ngp++) = fp[1];
 		*(ngp++) = fp[2];
@@ -703,9 +754,10 @@ void bccTetScene::drawTetLattice()
 	Vec3f valid_min = centerVec - extents * 10.0f;
 	Vec3f valid_max = centerVec + extents * 10.0f;
 
+	const Vec3f* nodes = renderNodePositions();
 	GLfloat *ngp = &_nodeGraphicsPositions[0];
 	for (int n = _vnTets.nodeNumber(), i = 0; i < n; ++i){
-		const float *fp = _vnTets.nodeSpatialCoordinatePtr(i);
+		const float *fp = nodes[i].xyz;
 		Vec3f pos(fp[0], fp[1], fp[2]);
 
 		if (!std::isfinite(pos.X) || !std::isfinite(pos.Y) || !std::isfinite(pos.Z)) {
@@ -731,12 +783,14 @@ void bccTetScene::drawTetLattice()
 	_gl3w->getLines()->updatePoints(_nodeGraphicsPositions);
 }
 
-bccTetScene::bccTetScene() : _physicsPaused(false), _forcesApplied(false), _tetsModified(false)
+bccTetScene::bccTetScene() : _physicsPaused(false), _forcesApplied(false), _externalStepping(false), _tetsModified(false), _cutterSeconds(0.0)
 {
+	_sim.start([this]() { return physicsStep(); });
 	_tetCol.setPdTetPhysics(&_ptp); // Qisi:set ptp for tetCol so things of ptp are accessible inside of tetCol
 }
 
 
 bccTetScene::~bccTetScene()
 {
+	_sim.stop();  // join before anything its step uses is destroyed
 }
@@ -20,7 +20,9 @@
 #include "tetSubset.h"
 #include "remapTetPhysics.h"
 #include "pdTetPhysics.h"
+#include "simulationThread.h"
 #include <unordered_set>
+#include <mutex>
 
 // forward declarations
 class gl3wGraphics;
@@ -35,11 +37,11 @@ public:
 	void updateOldPhysicsLattice();
 	inline void nonTetPhysicsUpdate() {_ptp.initializePhysics();}
 	void initPdPhysics();
-	void updatePhysics();
+	bool updatePhysics();  // one solve; true while the solver has not converged
 	void fixPeriostealPeriferalVertices();
 	void updateSurfaceDraw();
 	pdTetPhysics* getPdTetPhysics_2(){ return &_ptp; }
-	inline void setForcesAppliedFlag(){ _forcesApplied = true; }
+	inline void setForcesAppliedFlag(){ _forcesApplied = true; _sim.wake(); }
 	inline void promoteSutures() { _ptp.promoteAllSutures(); _ptp.initializePhysics(); }
 	vnBccTetrahedra* getVirtualNodedBccTetrahedra() { return &_vnTets; }
 	void setVisability(char surface, char physics);	// 0=off, 1=on, 2=don't change
@@ -48,9 +50,18 @@ public:
 	void drawTetLattice();
 	void eraseTetLattice();
 	void setSurgicalActions(surgicalActions *sa) { _surgAct = sa; }
-	void setPhysicsPause(bool pause) { _physicsPaused = pause; }
+	void setPhysicsPause(bool pause) { _physicsPaused = pause; if (!pause) _sim.wake(); }
 	inline bool isPhysicsPaused(){ return  _physicsPaused; }
 	inline bool forcesApplied() { return  _forcesApplied; }
+	// The solver iterates on its own thread while forces are applied and physics isn't paused.  Topology changes go through its command queue.
+	simulationThread* getSimulationThread() { return &_sim; }
+	inline void waitForPhysics() { _sim.waitIdle(); }  // pause first
+	inline bool physicsIdle() { return _sim.idle(); }
+	void publishNodePositions();  // hand the current node spatial coordinates to the renderer
+	// Batch runs stop the simulation thread from iterating on its own and call updatePhysics() themselves for a fixed count.
+	inline void setExternalStepping(const bool external) { _externalStepping = external; if (!external) _sim.wake(); }
+	inline double cutterSeconds() { return _cutterSeconds; }  // cumulative time in the tet cutter, for benchmarking
+	inline void setDeterministicTetNumbering(const bool deterministic) { _tc.setDeterministicNumbering(deterministic); }  // for reproducible history replay
 	
 	// MACOS PORT: Check if vertices are connected without crossing incision boundaries
 	bool areVerticesConnectedWithoutCrossingIncisions(int v1, int v2);
@@ -66,9 +77,11 @@ private:
 	remapTetPhysics _rtp;
 	tetCollisions _tetCol;
 	tetSubset _tetSubsets;
-	vnBccTetCutter_tbb _tc;  // multithreaded version using Intel threaded building blocks.  Much faster, but indices of nodes and tets different each run as nondeterministic.
+	vnBccTetCutter_tbb _tc;  // multithreaded version using Intel threaded building blocks.  Much faster, but indices of nodes and tets differ each run unless deterministic numbering is set.
 	pdTetPhysics _ptp;
-	bool _forcesApplied, _tetsModified, _physicsPaused;
+	std::atomic<bool> _forcesApplied, _physicsPaused, _externalStepping;  // set by the GUI thread, read by the simulation thread
+	bool _tetsModified;
+	double _cutterSeconds;
 	float _lowTetWeight;
 	struct boundingBox3{
 		float corners[6];
@@ -80,6 +93,10 @@ private:
 	// MACOS PORT: Track incision boundary vertices to limit hook force propagation
 	std::unordered_set<int> _incisionBoundaryVertices;
 
+	std::mutex _surfaceMutex;  // surface vertex positions are written by the renderer and read by soft collision detection on the simulation thread
+	simulationThread _sim;  // last so it is constructed after and joined before everything its step uses
+	bool physicsStep();  // simulation thread
+	const Vec3f* renderNodePositions();  // GUI thread
 };
 
 #endif // __BCC_TET_SCENE__
\ No newline at end of file
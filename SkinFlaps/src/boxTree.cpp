@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////
+// File: boxTree.cpp
+// Date: 10/16/2026
+// Purpose: Axis aligned box tree over integer items.  See boxTree.h.
+////////////////////////////////////////////////////////////////////////////
+
+#include <float.h>
+#include "boxTree.h"
+
+void boxTree::clear()
+{
+	_nodes.clear();
+	_itemBoxes.clear();
+	_leaves.clear();
+}
+
+void boxTree::build(std::vector<int>& items, const std::vector<Vec3f>& centers)
+{
+	clear();
+	if (items.empty())
+		return;
+	_nodes.reserve((items.size() / _leafSize + 1) * 2);
+	buildNode(items, centers, 0, (int)items.size());
+}
+
+int boxTree::buildNode(std::vector<int>& items, const std::vector<Vec3f>& centers, const int begin, const int end)
+{  // median split along the longest axis of the item centers
+	int nodeIndex = (int)_nodes.size();
+	_nodes.push_back(treeNode());
+	if (end - begin <= _leafSize) {
+		_nodes[nodeIndex].first = begin;
+		_nodes[nodeIndex].count = end - begin;
+		_leaves.push_back(nodeIndex);
+		return nodeIndex;
+	}
+	Vec3f cMin(FLT_MAX, FLT_MAX, FLT_MAX), cMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (int i = begin; i < end; ++i) {
+		const Vec3f& c = centers[items[i]];
+		for (int j = 0; j < 3; ++j) {
+			cMin[j] = std::min(cMin[j], c[j]);
+			cMax[j] = std::max(cMax[j], c[j]);
+		}
+	}
+	int axis = 0;
+	for (int j = 1; j < 3; ++j) {
+		if (cMax[j] - cMin[j] > cMax[axis] - cMin[axis])
+			axis = j;
+	}
+	int mid = (begin + end) >> 1;
+	std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end, [&](const int a, const int b) { return centers[a][axis] < centers[b][axis]; });
+	buildNode(items, centers, begin, mid);
+	int second = buildNode(items, centers, mid, end);
+	_nodes[nodeIndex].first = second;
+	_nodes[nodeIndex].count = 0;
+	return nodeIndex;
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////
+// File: boxTree.h
+// Date: 10/16/2026
+// Purpose: Axis aligned box tree over a caller owned list of integer items (tets, triangles).  build() median splits the items once per
+//     topology change, reordering the list so each leaf holds a contiguous range of it.  refit() recomputes every box in place as the
+//     geometry moves and query() visits the items whose boxes pass a caller supplied test.  Shared by spatialTetBvh and tetCollisions.
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BOX_TREE__
+#define __BOX_TREE__
+
+#include <vector>
+#include <algorithm>
+#include "Vec3f.h"
+#include "tbb/tbb.h"
+
+class boxTree
+{
+public:
+	struct box {
+		float corners[6];  // xmin, ymin, zmin, xmax, ymax, zmax
+		inline void set(const Vec3f& v) {
+			for (int j = 0; j < 3; ++j)
+				corners[j] = corners[j + 3] = v[j];
+		}
+		inline void enlarge(const Vec3f& v) {
+			for (int j = 0; j < 3; ++j) {
+				corners[j] = std::min(corners[j], v[j]);
+				corners[j + 3] = std::max(corners[j + 3], v[j]);
+			}
+		}
+		inline void enlarge(const box& b) {
+			for (int j = 0; j < 3; ++j) {
+				corners[j] = std::min(corners[j], b.corners[j]);
+				corners[j + 3] = std::max(corners[j + 3], b.corners[j + 3]);
+			}
+		}
+		inline bool overlaps(const box& b) const {
+			return corners[0] <= b.corners[3] && corners[1] <= b.corners[4] && corners[2] <= b.corners[5]
+				&& corners[3] >= b.corners[0] && corners[4] >= b.corners[1] && corners[5] >= b.corners[2];
+		}
+		inline bool contains(const Vec3f& v) const {
+			return v.X >= corners[0] && v.Y >= corners[1] && v.Z >= corners[2] && v.X <= corners[3] && v.Y <= corners[4] && v.Z <= corners[5];
+		}
+	};
+
+	void clear();
+	inline bool empty() const { return _nodes.empty(); }
+	// centers is indexed by item value.  Reorders items so each leaf holds a contiguous range.  Topology only, call refit() for the boxes.
+	void build(std::vector<int>& items, const std::vector<Vec3f>& centers);
+	// itemBox(item, box&) sets the box of one item.  Leaves hold nearly all the work, so only they are done in parallel.
+	template <class ItemBox>
+	void refit(const std::vector<int>& items, ItemBox itemBox);
+	// Calls visit(k) for every position k in items whose box passes test(const box&).  Subtrees failing test are skipped.
+	template <class Test, class Visit>
+	void query(Test test, Visit visit) const;
+
+	boxTree() {}
+	~boxTree() {}
+
+private:
+	struct treeNode {
+		box bounds;
+		int first;  // interior node: index of second child, the first being the next node.  Leaf: first position in items.
+		int count;  // 0 for interior nodes
+	};
+	static const int _leafSize = 4;
+	std::vector<treeNode> _nodes;  // depth first order, so children always follow their parent
+	std::vector<box> _itemBoxes;  // parallel to items
+	std::vector<int> _leaves;
+
+	int buildNode(std::vector<int>& items, const std::vector<Vec3f>& centers, const int begin, const int end);
+};
+
+template <class ItemBox>
+void boxTree::refit(const std::vector<int>& items, ItemBox itemBox)
+{
+	if (_nodes.empty())
+		return;
+	_itemBoxes.resize(items.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, _leaves.size()), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			treeNode& leaf = _nodes[_leaves[i]];
+			for (int k = leaf.first; k < leaf.first + leaf.count; ++k) {
+				itemBox(items[k], _itemBoxes[k]);
+				if (k == leaf.first)
+					leaf.bounds = _itemBoxes[k];
+				else
+					leaf.bounds.enlarge(_itemBoxes[k]);
+			}
+		}
+	});
+	for (int i = (int)_nodes.size() - 1; i > -1; --i) {  // children come after their parent
+		treeNode& n = _nodes[i];
+		if (n.count > 0)
+			continue;
+		n.bounds = _nodes[i + 1].bounds;
+		n.bounds.enlarge(_nodes[n.first].bounds);
+	}
+}
+
+template <class Test, class Visit>
+void boxTree::query(Test test, Visit visit) const
+{
+	if (_nodes.empty())
+		return;
+	int stack[64], top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		int ni = stack[--top];
+		const treeNode& n = _nodes[ni];
+		if (!test(n.bounds))
+			continue;
+		if (n.count > 0) {
+			for (int k = n.first; k < n.first + n.count; ++k) {
+				if (test(_itemBoxes[k]))
+					visit(k);
+			}
+		}
+		else {
+			stack[top++] = n.first;
+			stack[top++] = ni + 1;
+		}
+	}
+}
+
+#endif  // __BOX_TREE__
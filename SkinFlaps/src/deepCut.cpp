@@ -409,82 +409,31 @@ bool deepCut::cutDeep()  // interpost connection data already loaded in _deepPos
 }
 
 void deepCut::getDeepCutLine(rayTriangleIntersect &top, rayTriangleIntersect &bot) {
-	Vec3f V, C = Vec3f(top.intersect.xyz), D = Vec3f(bot.intersect.xyz) - C;
+	Vec3f C = Vec3f(top.intersect.xyz), D = Vec3f(bot.intersect.xyz) - C;
 	float len = D.length();
 	int n = (int)(D.length() * _vbt->getTetUnitSizeInv());
 	D /= (float)n;
-	for (int i = 1; i < n - 1; ++i) {
-		V = C + D * (float)i;
-		int tet;
-		Vec3f baryWeight;
-		if (!uniqueSpatialTet(V, tet, baryWeight))
+	std::vector<Vec3f> samples;
+	std::vector<int> tets;
+	std::vector<Vec3f> baryWeights;
+	samples.reserve(n);
+	for (int i = 1; i < n - 1; ++i)
+		samples.push_back(C + D * (float)i);
+	_vbt->spatialTets(samples, tets, baryWeights);
+	for (size_t i = 0; i < samples.size(); ++i) {
+		if (tets[i] < 0)
 			continue;
 		top.dcl.push_back(_mt->addVertices(1));
-		_mt->setVertexCoordinate(top.dcl.back(), V.xyz);  // texture not set
+		_mt->setVertexCoordinate(top.dcl.back(), samples[i].xyz);  // texture not set
 
 		// COURT this was commented out.
 		//  
 		assert(_vbt->_vertexTets.size() == top.dcl.back());
-		_vbt->_vertexTets.push_back(tet);
-		_vbt->_barycentricWeights.push_back(baryWeight);
+		_vbt->_vertexTets.push_back(tets[i]);
+		_vbt->_barycentricWeights.push_back(baryWeights[i]);
 	}
 }
 
-bool deepCut::uniqueSpatialTet(const Vec3f pos, int& tet, Vec3f& baryWeight) {
-
-//	std::chrono::time_point<std::chrono::system_clock> start, end;
-//	start = std::chrono::system_clock::now();
-
-	tet = -1;  // only found once so no write contention.
-	auto tetInside = [&](int tetid, Vec3f& bw) ->bool {
-		boundingBox<float> bb;
-		bb.Empty_Box();
-		Vec3f vp[4];
-		const int* tn = _vbt->tetNodes(tetid);  //  > _tetNodes[i].data();
-		for (int j = 0; j < 4; ++j) {
-			vp[j] = _vbt->_nodeSpatialCoords[tn[j]];
-			bb.Enlarge_To_Include_Point(vp[j].xyz);
-		}
-		if (bb.Outside(pos.xyz))
-			return false;
-		Mat3x3f M;
-		M.Initialize_With_Column_Vectors(vp[1] - vp[0], vp[2] - vp[0], vp[3] - vp[0]);
-		Vec3f R = M.Robust_Solve_Linear_System(pos - vp[0]);
-		if (R[0] <= 0.0f || R[1] <= 0.0f || R[2] <= 0.0f || R[0] >= 1.0f || R[1] >= 1.0f || R[2] >= 1.0f || R[0] + R[1] + R[2] >= 1.0f)
-			return false;
-		bw = R;
-		return true;
-	};
-	for (int i = 0; i < _vbt->_nMegatets; ++i) {  // in this new megatet environment check these largest unique tets first
-		if (tetInside(i, baryWeight)){
-			tet = i;
-			return true;
-		}
-	}
-//	for (int i = _vbt->firstInteriorTet(); i < _vbt->tetNumber(); ++i) {  // Now check the unique interior tets 
-	tbb::parallel_for(tbb::blocked_range<std::size_t>(_vbt->firstInteriorTet(), _vbt->tetNumber()), [&](tbb::blocked_range<size_t> r) {
-		for (int i = r.begin(); i != r.end(); ++i) {
-			Vec3f bw;
-			if (tetInside(i, bw)) {
-				tet = i;
-				baryWeight = bw;
-				break;
-			}
-		}
-		if (tet > -1)
-			oneapi::tbb::task_group_context().cancel_group_execution();
-	});
-
-//	end = std::chrono::system_clock::now();
-//	std::chrono::duration<double> elapsed_seconds = end - start;
-//	std::cout << "interiorSpatialTet() took " << elapsed_seconds.count() << "\n";
-
-	// worst case seems to be 0.008 seconds without tbb. tbb version worst 0.001 but some 15x faster on my desktop
-	if (tet < 0)
-		return false;
-	return true;
-}
-
 bool deepCut::connectOpenEnd(int postNum) {
 	auto &post = _deepPosts[postNum].triIntersects;
 	endPlane *ep = postNum < 1 ? &_endPlanes[0] : &_endPlanes[1];
@@ -869,6 +818,8 @@ void deepCut::makePolygonTriangles(const std::list<int> &polyVerts, const std::l
 	}intPt;
 	std::vector<interiorPoint> ceiVec;
 	ceiVec.reserve(m*n);
+	std::vector<Vec3f> samples;  // spatial tets of interior points located in one batch
+	std::vector<Vec2d> sampleUVs;
 	for (int i = 1; i < n; ++i) {
 		for (int j = 1; j < m; ++j) {
 			V2.X = minC.X + (incr + 5.0e-18) * i;  // Delaunay routines don't like equal edge lengths
@@ -887,24 +838,29 @@ void deepCut::makePolygonTriangles(const std::list<int> &polyVerts, const std::l
 					Nd = blp->P00 + blp->e10 * V2.X + blp->e00 * V2.Y + (blp->e11 - blp->e00) * (V2.X * V2.Y);
 				else 
 					Nd = ep->P + ep->U * V2.X + ep->V * V2.Y;
-				int tet;
-				Vec3f N(Nd.xyz), baryWeight;
-				if (!uniqueSpatialTet(Vec3f(N.xyz), tet, baryWeight))
-					continue;
-				intPt.newV = _mt->addVertices(1);
-				_mt->setVertexCoordinate(intPt.newV, N.xyz);  // texture not set
-				assert(_vbt->_vertexTets.size() == intPt.newV);
-				_vbt->_vertexTets.push_back(tet);
-				_vbt->_barycentricWeights.push_back(baryWeight);
-				intPt.uv = V2;
-				intPt.tx = _mt->addTexture();
-				tex[0] = (float)V2.X;
-				tex[1] = (float)V2.Y;
-				_mt->setTexture(intPt.tx, tex);
-				ceiVec.push_back(intPt);
+				samples.push_back(Vec3f(Nd.xyz));
+				sampleUVs.push_back(V2);
 			}
 		}
 	}
+	std::vector<int> sampleTets;
+	std::vector<Vec3f> baryWeights;
+	_vbt->spatialTets(samples, sampleTets, baryWeights);
+	for (size_t i = 0; i < samples.size(); ++i) {
+		if (sampleTets[i] < 0)
+			continue;
+		intPt.newV = _mt->addVertices(1);
+		_mt->setVertexCoordinate(intPt.newV, samples[i].xyz);  // texture not set
+		assert(_vbt->_vertexTets.size() == intPt.newV);
+		_vbt->_vertexTets.push_back(sampleTets[i]);
+		_vbt->_barycentricWeights.push_back(baryWeights[i]);
+		intPt.uv = sampleUVs[i];
+		intPt.tx = _mt->addTexture();
+		tex[0] = (float)sampleUVs[i].X;
+		tex[1] = (float)sampleUVs[i].Y;
+		_mt->setTexture(intPt.tx, tex);
+		ceiVec.push_back(intPt);
+	}
 	// Using new constrained Delaunay triangulation library. See top of file
 	typedef CDT::V2d<double> V2d;
 	typedef CDT::Triangulation<double> Triangulation;
@@ -153,6 +153,8 @@ void fence::setSpherePos(int postNumber, Vec3f& xyz){
 
 
 void fence::displayRemoveWall() {
+	if (gl3wGraphics::nullGraphics())  // the wall is only drawn
+		return;
 	if (_xyz.size() > 3) {  // valid wall to display
 		if (!_wall) {
 			_wall = std::make_shared<sceneNode>();
@@ -0,0 +1,534 @@
+////////////////////////////////////////////////////////////////////////////
+// File: flatCentroidHash.h
+// Date: 10/16/2026
+// Purpose: Open addressing hash tables keyed on bcc tet centroids and node grid loci.  Both keys are three 16 bit coordinates, so they pack
+//     into 48 bits of a 64 bit integer for hashing.  Entries live in one flat slot array.  A parallel array of control bytes holds 7 bits of
+//     each entry's hash, so a probe mostly reads control bytes and compares keys only when the tag matches.
+//     flatCentroidMap is a drop in for the std::unordered_map subset the tet code uses.  flatCentroidMultimap maps a centroid to tet indices,
+//     keeping the virtual noded duplicates of one centroid contiguous.  concurrentCentroidMap is an insert only table with a TBB like accessor
+//     for the cutter's parallel phases.
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __FLAT_CENTROID_HASH__
+#define __FLAT_CENTROID_HASH__
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "oneapi/tbb/spin_rw_mutex.h"
+
+struct centroidHashKey {
+	enum : unsigned char { EMPTY = 0x80, DELETED = 0xfe, BUSY = 0xff };  // control bytes of full slots are the 7 bit tag of their hash
+	template<class Key>
+	static inline uint64_t pack(const Key& k) {
+		return uint64_t((unsigned short)k[0]) | uint64_t((unsigned short)k[1]) << 16 | uint64_t((unsigned short)k[2]) << 32;
+	}
+	template<class Key>
+	static inline uint64_t hash(const Key& k) {  // murmur3 finalizer.  Neighboring lattice keys differ only in low bits of each coordinate.
+		uint64_t h = pack(k);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return h;
+	}
+	static inline unsigned char tag(const uint64_t h) { return (unsigned char)(h >> 57); }
+	static inline size_t capacityFor(const size_t n) {  // power of 2 with a maximum load of 7/8
+		size_t c = 16;
+		while (c - (c >> 3) < n)
+			c <<= 1;
+		return c;
+	}
+};
+
+template<class Key, class Value>
+class flatCentroidMap
+{
+public:
+	typedef std::pair<Key, Value> value_type;
+
+	template<bool isConst>
+	class iteratorBase {
+	public:
+		typedef typename std::conditional<isConst, const value_type, value_type>::type entry;
+		typedef typename std::conditional<isConst, const flatCentroidMap, flatCentroidMap>::type map;
+		entry& operator*() const { return _map->_slots[_slot]; }
+		entry* operator->() const { return &_map->_slots[_slot]; }
+		iteratorBase& operator++() { ++_slot; skipOpen(); return *this; }
+		bool operator==(const iteratorBase& it) const { return _slot == it._slot; }
+		bool operator!=(const iteratorBase& it) const { return _slot != it._slot; }
+		iteratorBase() : _map(nullptr), _slot(0) {}
+		iteratorBase(map* m, const size_t slot) : _map(m), _slot(slot) {}
+	private:
+		map* _map;
+		size_t _slot;
+		void skipOpen() {
+			while (_slot < _map->_control.size() && _map->_control[_slot] & 0x80)
+				++_slot;
+		}
+		friend class flatCentroidMap;
+	};
+	typedef iteratorBase<false> iterator;
+	typedef iteratorBase<true> const_iterator;
+
+	iterator begin() { iterator it(this, 0); it.skipOpen(); return it; }
+	iterator end() { return iterator(this, _control.size()); }
+	const_iterator begin() const { const_iterator it(this, 0); it.skipOpen(); return it; }
+	const_iterator end() const { return const_iterator(this, _control.size()); }
+	inline size_t size() const { return _size; }
+	inline bool empty() const { return _size < 1; }
+
+	iterator find(const Key& k) { return iterator(this, findSlot(k)); }
+	const_iterator find(const Key& k) const { return const_iterator(this, findSlot(k)); }
+	std::pair<iterator, bool> insert(const value_type& kv) {
+		bool inserted;
+		size_t slot = insertSlot(kv.first, inserted);
+		if (inserted)
+			_slots[slot].second = kv.second;
+		return std::make_pair(iterator(this, slot), inserted);
+	}
+	std::pair<iterator, bool> insert(value_type&& kv) {
+		bool inserted;
+		size_t slot = insertSlot(kv.first, inserted);
+		if (inserted)
+			_slots[slot].second = std::move(kv.second);
+		return std::make_pair(iterator(this, slot), inserted);
+	}
+	Value& operator[](const Key& k) {
+		bool inserted;
+		return _slots[insertSlot(k, inserted)].second;
+	}
+	void erase(iterator it) {
+		_control[it._slot] = centroidHashKey::DELETED;
+		_slots[it._slot].second = Value();
+		--_size;
+		++_deleted;
+	}
+	void reserve(const size_t n) {
+		if (centroidHashKey::capacityFor(n) > _control.size())
+			rehash(centroidHashKey::capacityFor(n));
+	}
+	void clear() {  // keeps capacity as the tables are refilled to similar sizes
+		for (size_t n = _control.size(), i = 0; i < n; ++i) {
+			if (!(_control[i] & 0x80))
+				_slots[i].second = Value();
+			_control[i] = centroidHashKey::EMPTY;
+		}
+		_size = 0;
+		_deleted = 0;
+	}
+
+	flatCentroidMap() : _size(0), _deleted(0) {}
+	flatCentroidMap(const flatCentroidMap&) = default;
+	flatCentroidMap(flatCentroidMap&& m) noexcept : _control(std::move(m._control)), _slots(std::move(m._slots)), _size(m._size), _deleted(m._deleted) { m.reset(); }
+	flatCentroidMap& operator=(const flatCentroidMap&) = default;
+	flatCentroidMap& operator=(flatCentroidMap&& m) noexcept {
+		_control = std::move(m._control);
+		_slots = std::move(m._slots);
+		_size = m._size;
+		_deleted = m._deleted;
+		m.reset();
+		return *this;
+	}
+	~flatCentroidMap() {}
+
+private:
+	std::vector<unsigned char> _control;
+	std::vector<value_type> _slots;
+	size_t _size, _deleted;
+
+	void reset() {  // leaves a moved from table empty
+		_control.clear();
+		_slots.clear();
+		_size = 0;
+		_deleted = 0;
+	}
+
+	size_t findSlot(const Key& k) const {  // _control.size() if not found
+		if (_size < 1)
+			return _control.size();
+		uint64_t h = centroidHashKey::hash(k);
+		unsigned char t = centroidHashKey::tag(h);
+		size_t mask = _control.size() - 1;
+		for (size_t slot = h & mask; ; slot = (slot + 1) & mask) {
+			if (_control[slot] == t && _slots[slot].first == k)
+				return slot;
+			if (_control[slot] == centroidHashKey::EMPTY)
+				return _control.size();
+		}
+	}
+	size_t insertSlot(const Key& k, bool& inserted) {
+		if (_size + _deleted + 1 > _control.size() - (_control.size() >> 3))
+			rehash(centroidHashKey::capacityFor(_size + 1));
+		uint64_t h = centroidHashKey::hash(k);
+		unsigned char t = centroidHashKey::tag(h);
+		size_t mask = _control.size() - 1, firstDeleted = _control.size();
+		for (size_t slot = h & mask; ; slot = (slot + 1) & mask) {
+			if (_control[slot] == t && _slots[slot].first == k) {
+				inserted = false;
+				return slot;
+			}
+			if (_control[slot] == centroidHashKey::DELETED && firstDeleted == _control.size())
+				firstDeleted = slot;
+			else if (_control[slot] == centroidHashKey::EMPTY) {
+				if (firstDeleted < _control.size()) {
+					slot = firstDeleted;
+					--_deleted;
+				}
+				_control[slot] = t;
+				_slots[slot].first = k;
+				++_size;
+				inserted = true;
+				return slot;
+			}
+		}
+	}
+	void rehash(const size_t capacity) {
+		std::vector<unsigned char> control(capacity, centroidHashKey::EMPTY);
+		std::vector<value_type> slots(capacity);
+		size_t mask = capacity - 1;
+		for (size_t n = _control.size(), i = 0; i < n; ++i) {
+			if (_control[i] & 0x80)
+				continue;
+			uint64_t h = centroidHashKey::hash(_slots[i].first);
+			size_t slot = h & mask;
+			while (control[slot] != centroidHashKey::EMPTY)
+				slot = (slot + 1) & mask;
+			control[slot] = _control[i];
+			slots[slot] = std::move(_slots[i]);
+		}
+		_control.swap(control);
+		_slots.swap(slots);
+		_deleted = 0;
+	}
+};
+
+// Maps a key to any number of int values stored contiguously in insertion order, so equal_range() returns a plain pointer range into
+// an entry array.  assign() builds the whole table from a key array in two passes; insert() of a duplicate whose run isn't at the end
+// of the entry array moves the run there, and the holes left behind are compacted once they outnumber live entries.
+template<class Key>
+class flatCentroidMultimap
+{
+public:
+	typedef std::pair<Key, int> value_type;
+	typedef const value_type* const_iterator;
+	typedef const_iterator iterator;
+
+	inline const_iterator end() const { return _entries.data() + _entries.size(); }
+	inline size_t size() const { return _entries.size() - _holes; }
+	inline bool empty() const { return size() < 1; }
+
+	std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
+		size_t slot = findSlot(k);
+		if (slot == _control.size())
+			return std::make_pair(end(), end());
+		const value_type* first = _entries.data() + _runs[slot].first;
+		return std::make_pair(first, first + _runs[slot].count);
+	}
+	const_iterator find(const Key& k) const { return equal_range(k).first; }
+	void insert(const value_type& kv) {
+		if (_runKeys + 1 > _control.size() - (_control.size() >> 3))
+			rehash(centroidHashKey::capacityFor(_runKeys + 1));
+		size_t slot = insertSlot(kv.first);
+		run& r = _runs[slot];
+		if (r.count > 0 && r.first + r.count != (int)_entries.size()) {  // move this run to the end
+			int newFirst = (int)_entries.size();
+			_entries.reserve(_entries.size() + r.count + 1);
+			for (int i = 0; i < r.count; ++i)
+				_entries.push_back(_entries[r.first + i]);
+			_holes += r.count;
+			r.first = newFirst;
+		}
+		else if (r.count < 1)
+			r.first = (int)_entries.size();
+		_entries.push_back(kv);
+		++r.count;
+		if (_holes > 64 && _holes > (_entries.size() >> 1))
+			compact();
+	}
+	void assign(const std::vector<Key>& keys) {  // key i gets value i
+		clear();
+		reserve(keys.size());
+		std::vector<int> keySlots(keys.size());
+		for (size_t n = keys.size(), i = 0; i < n; ++i) {
+			keySlots[i] = (int)insertSlot(keys[i]);
+			++_runs[keySlots[i]].count;
+		}
+		int first = 0;
+		for (size_t n = _control.size(), i = 0; i < n; ++i) {
+			if (_control[i] & 0x80)
+				continue;
+			_runs[i].first = first;
+			first += _runs[i].count;
+			_runs[i].count = 0;
+		}
+		_entries.resize(keys.size());
+		for (size_t n = keys.size(), i = 0; i < n; ++i) {
+			run& r = _runs[keySlots[i]];
+			_entries[r.first + r.count++] = std::make_pair(keys[i], (int)i);
+		}
+	}
+	void reserve(const size_t n) {
+		if (centroidHashKey::capacityFor(n) > _control.size())
+			rehash(centroidHashKey::capacityFor(n));
+		_entries.reserve(n);
+	}
+	void clear() {
+		std::fill(_control.begin(), _control.end(), (unsigned char)centroidHashKey::EMPTY);
+		_entries.clear();
+		_runKeys = 0;
+		_holes = 0;
+	}
+
+	flatCentroidMultimap() : _runKeys(0), _holes(0) {}
+	flatCentroidMultimap(const flatCentroidMultimap&) = default;
+	flatCentroidMultimap(flatCentroidMultimap&& m) noexcept : _control(std::move(m._control)), _runs(std::move(m._runs)), _entries(std::move(m._entries)),
+		_runKeys(m._runKeys), _holes(m._holes) { m.reset(); }
+	flatCentroidMultimap& operator=(const flatCentroidMultimap&) = default;
+	flatCentroidMultimap& operator=(flatCentroidMultimap&& m) noexcept {
+		_control = std::move(m._control);
+		_runs = std::move(m._runs);
+		_entries = std::move(m._entries);
+		_runKeys = m._runKeys;
+		_holes = m._holes;
+		m.reset();
+		return *this;
+	}
+	~flatCentroidMultimap() {}
+
+private:
+	struct run {
+		Key key;
+		int first;
+		int count;
+	};
+	std::vector<unsigned char> _control;
+	std::vector<run> _runs;
+	std::vector<value_type> _entries;
+	size_t _runKeys, _holes;
+
+	void reset() {  // leaves a moved from table empty
+		_control.clear();
+		_runs.clear();
+		_entries.clear();
+		_runKeys = 0;
+		_holes = 0;
+	}
+
+	size_t findSlot(const Key& k) const {
+		if (_runKeys < 1)
+			return _control.size();
+		uint64_t h = centroidHashKey::hash(k);
+		unsigned char t = centroidHashKey::tag(h);
+		size_t mask = _control.size() - 1;
+		for (size_t slot = h & mask; ; slot = (slot + 1) & mask) {
+			if (_control[slot] == t && _runs[slot].key == k)
+				return slot;
+			if (_control[slot] == centroidHashKey::EMPTY)
+				return _control.size();
+		}
+	}
+	size_t insertSlot(const Key& k) {  // capacity must already be available
+		uint64_t h = centroidHashKey::hash(k);
+		unsigned char t = centroidHashKey::tag(h);
+		size_t mask = _control.size() - 1;
+		for (size_t slot = h & mask; ; slot = (slot + 1) & mask) {
+			if (_control[slot] == t && _runs[slot].key == k)
+				return slot;
+			if (_control[slot] == centroidHashKey::EMPTY) {
+				_control[slot] = t;
+				_runs[slot].key = k;
+				_runs[slot].count = 0;
+				++_runKeys;
+				return slot;
+			}
+		}
+	}
+	void rehash(const size_t capacity) {
+		std::vector<unsigned char> control(capacity, centroidHashKey::EMPTY);
+		std::vector<run> runs(capacity);
+		size_t mask = capacity - 1;
+		for (size_t n = _control.size(), i = 0; i < n; ++i) {
+			if (_control[i] & 0x80)
+				continue;
+			size_t slot = centroidHashKey::hash(_runs[i].key) & mask;
+			while (control[slot] != centroidHashKey::EMPTY)
+				slot = (slot + 1) & mask;
+			control[slot] = _control[i];
+			runs[slot] = _runs[i];
+		}
+		_control.swap(control);
+		_runs.swap(runs);
+	}
+	void compact() {
+		std::vector<value_type> entries;
+		entries.reserve(size());
+		for (size_t n = _control.size(), i = 0; i < n; ++i) {
+			if (_control[i] & 0x80)
+				continue;
+			run& r = _runs[i];
+			int first = (int)entries.size();
+			entries.insert(entries.end(), _entries.begin() + r.first, _entries.begin() + r.first + r.count);
+			r.first = first;
+		}
+		_entries.swap(entries);
+		_holes = 0;
+	}
+};
+
+// Insert only map for parallel use.  Inserts share the table under a reader lock and claim empty slots with a compare and swap; growing
+// takes the writer lock.  As in tbb::concurrent_hash_map, an accessor keeps its entry locked, and the table from growing, until released,
+// so a thread should hold only one accessor at a time.  Iteration, clear() and reserve() must not run concurrently with inserts.
+template<class Key, class Value>
+class concurrentCentroidMap
+{
+public:
+	typedef std::pair<Key, Value> value_type;
+
+private:
+	struct slot {
+		std::atomic<unsigned char> control;
+		std::atomic<bool> locked;
+		value_type kv;
+		slot() : control(centroidHashKey::EMPTY), locked(false) {}
+	};
+
+public:
+	class accessor {
+	public:
+		value_type& operator*() const { return _slot->kv; }
+		value_type* operator->() const { return &_slot->kv; }
+		void release() {
+			if (_slot) {
+				_slot->locked.store(false, std::memory_order_release);
+				_slot = nullptr;
+				_tableLock.release();
+			}
+		}
+		accessor() : _slot(nullptr) {}
+		~accessor() { release(); }
+	private:
+		slot* _slot;
+		oneapi::tbb::spin_rw_mutex::scoped_lock _tableLock;
+		friend class concurrentCentroidMap;
+	};
+
+	// Finds or inserts k, a new entry having a value initialized Value.  Returns true if k was inserted.  acc holds the entry locked.
+	bool insert(accessor& acc, const Key& k) {
+		acc.release();
+		uint64_t h = centroidHashKey::hash(k);
+		unsigned char t = centroidHashKey::tag(h);
+		while (true) {
+			acc._tableLock.acquire(_tableMutex, false);
+			// reserve room for k first, so concurrent inserts can never fill the table
+			if (_size.fetch_add(1) + 1 > _capacity - (_capacity >> 3)) {
+				_size.fetch_sub(1);
+				acc._tableLock.release();
+				grow();
+				continue;
+			}
+			size_t mask = _capacity - 1;
+			for (size_t s = h & mask; ; s = (s + 1) & mask) {
+				slot& sl = _slots[s];
+				unsigned char c = sl.control.load(std::memory_order_acquire);
+				if (c == centroidHashKey::EMPTY) {
+					if (!sl.control.compare_exchange_strong(c, centroidHashKey::BUSY, std::memory_order_acq_rel)) {
+						s = (s - 1) & mask;  // lost the race, look at this slot again
+						continue;
+					}
+					sl.kv.first = k;
+					sl.control.store(t, std::memory_order_release);
+					lockSlot(sl);
+					acc._slot = &sl;
+					return true;
+				}
+				while (c == centroidHashKey::BUSY)
+					c = sl.control.load(std::memory_order_acquire);
+				if (c == t && sl.kv.first == k) {
+					_size.fetch_sub(1);
+					lockSlot(sl);
+					acc._slot = &sl;
+					return false;
+				}
+			}
+		}
+	}
+
+	class iterator {
+	public:
+		value_type& operator*() const { return _slots[_slot].kv; }
+		value_type* operator->() const { return &_slots[_slot].kv; }
+		iterator& operator++() { ++_slot; skipOpen(); return *this; }
+		bool operator==(const iterator& it) const { return _slot == it._slot; }
+		bool operator!=(const iterator& it) const { return _slot != it._slot; }
+		iterator(slot* slots, const size_t capacity, const size_t s) : _slots(slots), _capacity(capacity), _slot(s) { skipOpen(); }
+	private:
+		slot* _slots;
+		size_t _capacity, _slot;
+		void skipOpen() {
+			while (_slot < _capacity && _slots[_slot].control.load(std::memory_order_relaxed) & 0x80)
+				++_slot;
+		}
+	};
+	iterator begin() { return iterator(_slots.get(), _capacity, 0); }
+	iterator end() { return iterator(_slots.get(), _capacity, _capacity); }
+	inline size_t size() const { return _size.load(); }
+	inline bool empty() const { return size() < 1; }
+
+	void reserve(const size_t n) {
+		if (centroidHashKey::capacityFor(n) > _capacity)
+			rehash(centroidHashKey::capacityFor(n));
+	}
+	void clear() {
+		for (size_t i = 0; i < _capacity; ++i) {
+			if (!(_slots[i].control.load(std::memory_order_relaxed) & 0x80))
+				_slots[i].kv.second = Value();
+			_slots[i].control.store(centroidHashKey::EMPTY, std::memory_order_relaxed);
+		}
+		_size.store(0);
+	}
+
+	concurrentCentroidMap() : _capacity(0), _size(0) {}
+	~concurrentCentroidMap() {}
+
+private:
+	std::unique_ptr<slot[]> _slots;
+	size_t _capacity;
+	std::atomic<size_t> _size;
+	oneapi::tbb::spin_rw_mutex _tableMutex;
+
+	static void lockSlot(slot& sl) {
+		while (sl.locked.exchange(true, std::memory_order_acquire))
+			;
+	}
+	void grow() {
+		oneapi::tbb::spin_rw_mutex::scoped_lock lock(_tableMutex, true);
+		if (_size.load() + 1 > _capacity - (_capacity >> 3))  // another thread may have grown the table already
+			rehash(centroidHashKey::capacityFor(_size.load() + 1) << 1);
+	}
+	void rehash(const size_t capacity) {  // caller has exclusive access
+		std::unique_ptr<slot[]> slots(new slot[capacity]);
+		size_t mask = capacity - 1;
+		for (size_t i = 0; i < _capacity; ++i) {
+			unsigned char c = _slots[i].control.load(std::memory_order_relaxed);
+			if (c & 0x80)
+				continue;
+			size_t s = centroidHashKey::hash(_slots[i].kv.first) & mask;
+			while (slots[s].control.load(std::memory_order_relaxed) != centroidHashKey::EMPTY)
+				s = (s + 1) & mask;
+			slots[s].control.store(c, std::memory_order_relaxed);
+			slots[s].kv = std::move(_slots[i].kv);
+		}
+		_slots.swap(slots);
+		_capacity = capacity;
+	}
+};
+
+#endif  // __FLAT_CENTROID_HASH__
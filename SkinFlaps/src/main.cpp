@@ -4,8 +4,6 @@
 // Read online: https://github.com/ocornut/imgui/tree/master/docs
 
 #include <stdio.h>
-#include <tbb/task_arena.h>
-#include <atomic>
 #include "surgicalActions.h"
 #include <gl3wGraphics.h>
 #include "FacialFlapsGui.h"
@@ -25,8 +23,7 @@ int main(int, char**)
 	}
 	surgicalActions* sa = ffg.getSurgicalActions();
 	bccTetScene* bts = sa->getBccTetScene();
-	sa->physicsDone = true;
-	bool updateThrow = false;
+	simulationThread* sim = bts->getSimulationThread();
 	while (!glfwWindowShouldClose(ffg.FFwindow))
 	{
 		try {
@@ -57,8 +54,8 @@ int main(int, char**)
 				throw(std::logic_error(err));
 			}
 
-			if (sa->physicsDone) {
-				// draw last physics result before starting a new solve
+			if (sim->commandsDone()) {
+				// No topology change is queued, so draw the newest positions the simulation thread has published while it keeps iterating.
 				// Unfortunately all graphics calls must be executed fom the master thread.
 				if (sa->newTopology) {
 					sa->getSurgGraphics()->setNewTopology();
@@ -80,36 +77,6 @@ int main(int, char**)
 					ffg.getSurgicalActions()->nextHistoryAction();
 					--ffg.nextCounter;
 				}
-				else{
-				// below is from: https://www.intel.com/content/www/us/en/develop/documentation/onetbb-documentation/top/onetbb-developer-guide/design-patterns/gui-thread.html
-					if (bts->forcesApplied() && !bts->isPhysicsPaused()) {  // physicsDone recheck necessary since nextHistoryAction() may have spawned a task that this one would collide with
-						std::cout << "DEBUG: Triggering physics update - forcesApplied=" << bts->forcesApplied() 
-						          << ", physicsPaused=" << bts->isPhysicsPaused() << std::endl;
-						sa->physicsDone = false;
-						tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-							try {
-								std::cout << "DEBUG: Calling updatePhysics()" << std::endl;
-								bts->updatePhysics();
-								sa->physicsDone = true;
-								std::cout << "DEBUG: updatePhysics() completed" << std::endl;
-							}
-							catch (...) {
-								updateThrow = true;
-								sa->taskThreadError = true;
-								sa->taskThreadErrorStr = "Couldn't update physics after last action.";
-							}
-							}
-						);
-					}
-					else {
-						static int debugCounter = 0;
-						if (debugCounter++ % 60 == 0) {  // Print every 60 frames (~1 second)
-							std::cout << "DEBUG: Physics not triggered - forcesApplied=" << bts->forcesApplied() 
-							          << ", physicsPaused=" << bts->isPhysicsPaused() 
-							          << ", physicsDone=" << sa->physicsDone << std::endl;
-						}
-					}
-				}
 			}
 			ffg.getgl3wGraphics()->drawAll();
 
@@ -144,8 +111,8 @@ int main(int, char**)
 		}
 		glfwSwapBuffers(ffg.FFwindow);
 	}
-	while (!updateThrow && !sa->physicsDone)
-		;
+	bts->setPhysicsPause(true);
+	sim->stop();
 	ffg.destroyImguiGlfw();
     return 0;
 }
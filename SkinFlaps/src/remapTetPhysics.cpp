@@ -1,7 +1,11 @@
 #include <assert.h>
-#include <set>
 #include <algorithm>
+#include <atomic>
+#include <climits>
+#include <string>
+#include <stdexcept>
 #include <cfloat>  // For FLT_MAX
+#include "tbb/tbb.h"
 #include "materialTriangles.h"
 #include "remapTetPhysics.h"
 
@@ -22,214 +26,290 @@ void remapTetPhysics::getOldPhysicsData(vnBccTetrahedra *oldVnbt)
 	_oldTetHash.clear();
 	_oldTetHash = std::move(oldVnbt->_tetHash);
 	_oldVnTetTris = std::move(_newVnTetTris);
+	std::sort(_oldVnTetTris.begin(), _oldVnTetTris.end());
+}
+
+const std::vector<int>* remapTetPhysics::findVnTetTris(const std::vector<vnTetTris>& vtt, const int tet) const
+{
+	vnTetTris key;
+	key.tet = tet;
+	auto it = std::lower_bound(vtt.begin(), vtt.end(), key);
+	if (it == vtt.end() || it->tet != tet)
+		return nullptr;
+	return &it->tris;
+}
+
+void remapTetPhysics::vertexSet(materialTriangles* mt, const std::vector<int>& tris, std::vector<int>& verts)
+{
+	verts.clear();
+	verts.reserve(tris.size() * 3);
+	for (auto& tri : tris) {
+		int* tr = mt->triangleVertices(tri);
+		verts.insert(verts.end(), tr, tr + 3);
+	}
+	std::sort(verts.begin(), verts.end());
+	verts.erase(std::unique(verts.begin(), verts.end()), verts.end());
 }
 
 void remapTetPhysics::remapNewPhysicsNodePositions(vnBccTetrahedra *newVnbt)
 {  // with new multires tet formulation all new physics nodes are no longer clones of old ones following decimation.
-	// new low end nodes may be subnodes of larger tets.  Multithread?
-	// Start known one to one tet correspondences and use any nodes to solve for vn multiplicities
+	// new low end nodes may be subnodes of larger tets.
+	// A node takes its position from the first vertex tet, then the first tet in the order megatets, interior tets, surface tets, containing it.
+	// Vertices and tets with a single old tet correspondence are resolved in parallel, each node keeping its lowest ranked claim.
+	// Virtual noded tets then use those settled nodes to solve for vn multiplicities.  They depend on each other, so are finished in order.
 	materialTriangles *mt = newVnbt->getMaterialTriangles();
-	std::vector<char> nodes(newVnbt->_nodeGridLoci.size(), 0x00);
-	auto processTet = [&](int tetIdx) ->bool {
-		auto tc = newVnbt->_tetCentroids[tetIdx];
-		const auto& tn = newVnbt->_tetNodes[tetIdx];
+	std::sort(_newVnTetTris.begin(), _newVnTetTris.end());
+	const int nVerts = (int)_oldVertexTets.size(), nTets = (int)newVnbt->_tetNodes.size(), nMegatets = newVnbt->_nMegatets, firstInteriorTet = newVnbt->_firstInteriorTet;
+	auto tetRank = [&](const int tet) ->int {  // position in the processing order, after all vertices
+		if (tet < nMegatets)
+			return nVerts + tet;
+		if (tet >= firstInteriorTet)
+			return nVerts + nMegatets + tet - firstInteriorTet;
+		return nVerts + nMegatets + nTets - firstInteriorTet + tet - nMegatets;
+	};
+	struct oldMatch {
+		flatCentroidMultimap<bccTetCentroid>::const_iterator first;
+		int count;  // old tets at tc. -1 for a vertex whose old tet has the same centroid.
+		bccTetCentroid tc;  // possibly moved up to the level of the old tet
+		bool sameSize;
+	};
+	auto findOldTets = [&](bccTetCentroid tc, oldMatch& om) {
 		auto pr = _oldTetHash.equal_range(tc);
 		int level = 1;
-		bool sameSize = true;
+		om.sameSize = true;
 		while (pr.first == pr.second && level <= newVnbt->_tetSubdivisionLevels) {
-			sameSize = false;
+			om.sameSize = false;
 			tc = newVnbt->centroidUpOneLevel(tc);
 			++level;
 			pr = _oldTetHash.equal_range(tc);
 		}
 		assert(level < 5);
-		if (std::distance(pr.first, pr.second) > 1) {  // origin was virtual noded level 1 tet.
-			assert(sameSize);  // new tet must also be level 1
-			int j;
-			for (j = 0; j < 4; ++j) {
-				if (nodes[tn[j]])
-					break;
+		om.first = pr.first;
+		om.count = (int)std::distance(pr.first, pr.second);
+		om.tc = tc;
+	};
+	auto interpolate = [&](const int node, const bccTetCentroid& tc, const std::array<int, 4>& oN) {
+		Vec3f nodeLocus((const short(&)[3]) * newVnbt->_nodeGridLoci[node].data());
+		Vec3f bw, C;
+		newVnbt->gridLocusToBarycentricWeight(nodeLocus, tc, bw);
+		C = _oldNodePositions[oN[0]] * (1.0f - bw[0] - bw[1] - bw[2]);
+		C += _oldNodePositions[oN[1]] * bw[0];
+		C += _oldNodePositions[oN[2]] * bw[1];
+		C += _oldNodePositions[oN[3]] * bw[2];
+		newVnbt->_nodeSpatialCoords[node] = C;
+	};
+	std::vector<std::atomic<int> > claims(newVnbt->_nodeGridLoci.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, claims.size()), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i)
+			claims[i].store(INT_MAX, std::memory_order_relaxed);
+	});
+	auto claim = [&](const int node, const int rank) {
+		int c = claims[node].load(std::memory_order_relaxed);
+		while (rank < c && !claims[node].compare_exchange_weak(c, rank, std::memory_order_relaxed));
+	};
+	std::atomic<int> error(0);
+	// claim nodes from vertexTet correspondence
+	std::vector<oldMatch> vertexMatches(nVerts);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, nVerts), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			if (newVnbt->_vertexTets[i] < 0)  // deleted vertex
+				continue;
+			auto& vm = vertexMatches[i];
+			auto tcNew = newVnbt->_tetCentroids[newVnbt->_vertexTets[i]];
+			if (tcNew == _oldTetCentroids[_oldVertexTets[i]])
+				vm.count = -1;
+			else {
+				findOldTets(tcNew, vm);
+				if (vm.count > 1)  // this should be a macrotet which can't virtual node
+					error.store(1);
+				else if (vm.count < 1)
+					error.store(2);
 			}
-			if (j < 4) { // prior one to one correspondence found
-				float dsq, minD = FLT_MAX;
-				int bestTet = -1;
-				while (pr.first != pr.second) {
-					auto& oN = _oldTets[pr.first->second];
-					dsq = (newVnbt->nodeSpatialCoordinate(tn[j]) - _oldNodePositions[oN[j]]).length2();
-					if (dsq < minD) {
-						minD = dsq;
-						bestTet = pr.first->second;
-					}
-					++pr.first;
-				}
-				auto& oN = _oldTets[bestTet];
-				for (int k = 0; k < j; ++k)
-					newVnbt->_nodeSpatialCoords[tn[k]] = _oldNodePositions[oN[k]];
-				for (int k = j + 1; k < 4; ++k) {
-					if (nodes[tn[k]])
-						continue;
-					nodes[tn[k]] = 1;
-					newVnbt->_nodeSpatialCoords[tn[k]] = _oldNodePositions[oN[k]];
-				}
-				return true;
+			for (auto n : newVnbt->_tetNodes[newVnbt->_vertexTets[i]])
+				claim(n, (int)i);
+		}
+	});
+	if (error.load() > 0)
+		throw(std::logic_error("Program error " + std::to_string(error.load()) + " in remapTetPhysics.\n"));
+	// claim nodes of tets with one old tet
+	std::vector<oldMatch> tetMatches(nTets);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, nTets), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			auto& tm = tetMatches[i];
+			findOldTets(newVnbt->_tetCentroids[i], tm);
+			if (tm.count < 1)  // only doing further topo refinements during surgical simulation
+				error.store(5);
+			else if (tm.count < 2) {
+				int rank = tetRank((int)i);
+				for (auto n : newVnbt->_tetNodes[i])
+					claim(n, rank);
 			}
-			// no simple prior correspondence found
-			auto ntl = _newVnTetTris.find(tetIdx);
-			if (ntl == _newVnTetTris.end())
-				throw(std::logic_error("Program error 3 in remapTetPhysics.\n"));
-			std::set<int> newTetV;
-			for (auto& tri : ntl->second) {
-				int* tr = mt->triangleVertices(tri);
-				for (int k = 0; k < 3; ++k)
-					newTetV.insert(tr[k]);
+		}
+	});
+	if (error.load() > 0)
+		throw(std::logic_error("Program error " + std::to_string(error.load()) + " in remapTetPhysics.\n"));
+	// each claimed node is written by its winner
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, nVerts), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			if (newVnbt->_vertexTets[i] < 0)
+				continue;
+			const auto& nNew = newVnbt->_tetNodes[newVnbt->_vertexTets[i]];
+			const auto& nOld = _oldTets[_oldVertexTets[i]];
+			for (int j = 0; j < 4; ++j) {
+				if (claims[nNew[j]].load(std::memory_order_relaxed) != (int)i)
+					continue;
+				if (vertexMatches[i].count < 0)
+					newVnbt->_nodeSpatialCoords[nNew[j]] = _oldNodePositions[nOld[j]];
+				else
+					interpolate(nNew[j], vertexMatches[i].tc, nOld);
 			}
-			int bestTet = -1;
-			auto prStart = pr.first;
-			struct oldTetV {
-				int tetIdx;
-				std::set<int> verts;
-			};
-			std::vector<oldTetV> oldTetVertices;
-			while (prStart != pr.second) {
-				auto otl = _oldVnTetTris.find(prStart->second);
-				if (otl == _oldVnTetTris.end())
-					throw(std::logic_error("Program error 4 in remapTetPhysics.\n"));
-				oldTetVertices.push_back(oldTetV());
-				oldTetVertices.back().tetIdx = prStart->second;
-				auto& otv = oldTetVertices.back().verts;
-				for (auto& triO : otl->second) {
-					int* tr = mt->triangleVertices(triO);
-					for (int k = 0; k < 3; ++k)
-						otv.insert(tr[k]);
+		}
+	});
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, nTets), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			auto& tm = tetMatches[i];
+			if (tm.count > 1)
+				continue;
+			int rank = tetRank((int)i);
+			const auto& tn = newVnbt->_tetNodes[i];
+			auto& oN = _oldTets[tm.first->second];
+			for (int j = 0; j < 4; ++j) {
+				if (claims[tn[j]].load(std::memory_order_relaxed) != rank)
+					continue;
+				if (tm.sameSize)
+					newVnbt->_nodeSpatialCoords[tn[j]] = _oldNodePositions[oN[j]];
+				else
+					interpolate(tn[j], tm.tc, oN);
+			}
+		}
+	});
+	std::vector<char> nodes(claims.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, claims.size()), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i)
+			nodes[i] = claims[i].load(std::memory_order_relaxed) < INT_MAX ? 1 : 0;
+	});
+	claims.clear();
+
+	// Virtual noded tets, whose origin was a virtual noded level 1 tet.  First find in parallel the old tet each would take if it
+	// has no node already settled: the first old tet sharing a surface vertex, else the old tet with the nearest vertex centroid.
+	std::vector<int> vnTets;
+	for (int i = 0; i < nTets; ++i) {  // in processing order
+		int tet = i < nMegatets ? i : (i < nMegatets + nTets - firstInteriorTet ? firstInteriorTet + i - nMegatets : i - nTets + firstInteriorTet);
+		if (tetMatches[tet].count > 1)
+			vnTets.push_back(tet);
+	}
+	struct vnChoice {
+		int oldTet;
+		bool vertexMatch;
+	};
+	std::vector<vnChoice> vnChoices(vnTets.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, vnTets.size()), [&](const tbb::blocked_range<size_t>& r) {
+		std::vector<int> newTetV, oldTetV;
+		std::vector<Vec3f> oldTetPositions;
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			auto& tm = tetMatches[vnTets[i]];
+			assert(tm.sameSize);  // new tet must also be level 1
+			auto ntl = findVnTetTris(_newVnTetTris, vnTets[i]);
+			if (ntl == nullptr) {
+				error.store(3);
+				continue;
+			}
+			vertexSet(mt, *ntl, newTetV);
+			auto& vc = vnChoices[i];
+			vc.oldTet = -1;
+			vc.vertexMatch = false;
+			oldTetPositions.clear();
+			for (int k = 0; k < tm.count; ++k) {
+				int oldTet = tm.first[k].second;
+				auto otl = findVnTetTris(_oldVnTetTris, oldTet);
+				if (otl == nullptr) {
+					error.store(4);
+					break;
 				}
-				auto vit = newTetV.begin();
-				for (; vit != newTetV.end(); ++vit) {
-					if (otv.find(*vit) != otv.end()) {
-						bestTet = prStart->second;
-						break;
-					}
+				vertexSet(mt, *otl, oldTetV);
+				auto nit = newTetV.begin();
+				auto oit = oldTetV.begin();
+				while (nit != newTetV.end() && oit != oldTetV.end() && *nit != *oit) {
+					if (*nit < *oit)
+						++nit;
+					else
+						++oit;
 				}
-				if (bestTet > -1)
+				if (nit != newTetV.end() && oit != oldTetV.end()) {
+					vc.oldTet = oldTet;
+					vc.vertexMatch = true;
 					break;
-				++prStart;
-			}
-			if (bestTet < 0){  // least satisfying choice
-				Vec3f newTetPos = { 0.0f, 0.0f, 0.0f };
-				for (auto& nv : newTetV) {
-					Vec3f tv;
-					mt->getVertexCoordinate(nv, tv.xyz);
-					newTetPos += tv;
 				}
-				newTetPos /= newTetV.size();
-				float dsq, minD = FLT_MAX;
-				for (auto& otv : oldTetVertices) {
-					Vec3f oldTetPos = { 0.0f, 0.0f, 0.0f };
-					for (auto& ov : otv.verts) {
-						Vec3f tv;
-						mt->getVertexCoordinate(ov, tv.xyz);
-						oldTetPos += tv;
-					}
-					oldTetPos /= otv.verts.size();
-					dsq = (newTetPos - oldTetPos).length2();
-					if (minD > dsq) {
-						minD = dsq;
-						bestTet = otv.tetIdx;
-					}
+				Vec3f oldTetPos = { 0.0f, 0.0f, 0.0f };
+				for (auto& ov : oldTetV) {
+					Vec3f tv;
+					mt->getVertexCoordinate(ov, tv.xyz);
+					oldTetPos += tv;
 				}
+				oldTetPos /= oldTetV.size();
+				oldTetPositions.push_back(oldTetPos);
 			}
-			auto& oN = _oldTets[bestTet];
-			for (int j = 0; j < 4; ++j) {
-				if (nodes[tn[j]])
-					continue;
-				if(prStart != pr.second)  // don't record the least satisfying correspondence. This means a vertex correspondence was found.
-					nodes[tn[j]] = 1;
-				newVnbt->_nodeSpatialCoords[tn[j]] = _oldNodePositions[oN[j]];
+			if (vc.vertexMatch || (int)oldTetPositions.size() < tm.count)
+				continue;
+			// least satisfying choice
+			Vec3f newTetPos = { 0.0f, 0.0f, 0.0f };
+			for (auto& nv : newTetV) {
+				Vec3f tv;
+				mt->getVertexCoordinate(nv, tv.xyz);
+				newTetPos += tv;
 			}
-		}
-		else if (pr.first != pr.second) {
-			auto& oN = _oldTets[pr.first->second];
-			if (sameSize) {
-				for (int j = 0; j < 4; ++j) {
-					if (nodes[tn[j]])
-						continue;
-					nodes[tn[j]] = 1;
-					newVnbt->_nodeSpatialCoords[tn[j]] = _oldNodePositions[oN[j]];
+			newTetPos /= newTetV.size();
+			float dsq, minD = FLT_MAX;
+			for (int k = 0; k < tm.count; ++k) {
+				dsq = (newTetPos - oldTetPositions[k]).length2();
+				if (minD > dsq) {
+					minD = dsq;
+					vc.oldTet = tm.first[k].second;
 				}
 			}
-			else {
-				for (int j = 0; j < 4; ++j) {
-					if (nodes[tn[j]])
-						continue;
-					nodes[tn[j]] = 1;
-					Vec3f nodeLocus((const short(&)[3]) * newVnbt->_nodeGridLoci[tn[j]].data());
-					Vec3f bw, C;
-					newVnbt->gridLocusToBarycentricWeight(nodeLocus, tc, bw);
-					C = _oldNodePositions[oN[0]] * (1.0f - bw[0] - bw[1] - bw[2]);
-					C += _oldNodePositions[oN[1]] * bw[0];
-					C += _oldNodePositions[oN[2]] * bw[1];
-					C += _oldNodePositions[oN[3]] * bw[2];
-					newVnbt->_nodeSpatialCoords[tn[j]] = C;
+		}
+	});
+	if (error.load() > 0)
+		throw(std::logic_error("Program error " + std::to_string(error.load()) + " in remapTetPhysics.\n"));
+	for (int n = vnTets.size(), i = 0; i < n; ++i) {
+		const auto& tn = newVnbt->_tetNodes[vnTets[i]];
+		auto& tm = tetMatches[vnTets[i]];
+		int j;
+		for (j = 0; j < 4; ++j) {
+			if (nodes[tn[j]])
+				break;
+		}
+		if (j < 4) { // prior one to one correspondence found
+			float dsq, minD = FLT_MAX;
+			int bestTet = -1;
+			for (int k = 0; k < tm.count; ++k) {
+				auto& oN = _oldTets[tm.first[k].second];
+				dsq = (newVnbt->nodeSpatialCoordinate(tn[j]) - _oldNodePositions[oN[j]]).length2();
+				if (dsq < minD) {
+					minD = dsq;
+					bestTet = tm.first[k].second;
 				}
 			}
-		}
-		else  // only doing further topo refinements during surgical simulation
-			throw(std::logic_error("Program error 5 in remapTetPhysics.\n"));
-		return true;
-	};
-	// get node positions from vertexTet correspondence
-	for (int n = _oldVertexTets.size(), i = 0; i < n; ++i) {
-		if (newVnbt->_vertexTets[i] < 0)  // deleted vertex
-			continue;
-		auto tcNew = newVnbt->_tetCentroids[newVnbt->_vertexTets[i]];
-		auto tcOld = _oldTetCentroids[_oldVertexTets[i]];
-		const auto& nNew = newVnbt->_tetNodes[newVnbt->_vertexTets[i]];
-		const auto& nOld = _oldTets[_oldVertexTets[i]];
-		if (tcNew == tcOld) {
-			for (int j = 0; j < 4; ++j){
-				if(nodes[nNew[j]])
+			auto& oN = _oldTets[bestTet];
+			for (int k = 0; k < j; ++k)
+				newVnbt->_nodeSpatialCoords[tn[k]] = _oldNodePositions[oN[k]];
+			for (int k = j + 1; k < 4; ++k) {
+				if (nodes[tn[k]])
 					continue;
-				newVnbt->_nodeSpatialCoords[nNew[j]] = _oldNodePositions[nOld[j]];
-				nodes[nNew[j]] = 1;
+				nodes[tn[k]] = 1;
+				newVnbt->_nodeSpatialCoords[tn[k]] = _oldNodePositions[oN[k]];
 			}
 			continue;
 		}
-		auto pr = _oldTetHash.equal_range(tcNew);
-		int level = 1;
-		while (pr.first == pr.second && level <= newVnbt->_tetSubdivisionLevels) {
-			tcNew = newVnbt->centroidUpOneLevel(tcNew);
-			++level;
-			pr = _oldTetHash.equal_range(tcNew);
-		}
-		assert(level <= newVnbt->_tetSubdivisionLevels);
-		if (std::distance(pr.first, pr.second) > 1) {  // this should be a macrotet which can't virtual node
-			throw(std::logic_error("Program error 1 in remapTetPhysics.\n"));
-		}
-		else if (pr.first != pr.second) {
-//			assert(_oldVertexTets[i] == pr.first->second);
-			for (int j = 0; j < 4; ++j) {
-				if (nodes[nNew[j]])
-					continue;
-				nodes[nNew[j]] = 1;
-				Vec3f nodeLocus((const short(&)[3]) * newVnbt->_nodeGridLoci[nNew[j]].data());
-				Vec3f bw, C;
-				newVnbt->gridLocusToBarycentricWeight(nodeLocus, tcNew, bw);
-				C = _oldNodePositions[nOld[0]] * (1.0f - bw[0] - bw[1] - bw[2]);
-				C += _oldNodePositions[nOld[1]] * bw[0];
-				C += _oldNodePositions[nOld[2]] * bw[1];
-				C += _oldNodePositions[nOld[3]] * bw[2];
-				newVnbt->_nodeSpatialCoords[nNew[j]] = C;
-			}
+		auto& oN = _oldTets[vnChoices[i].oldTet];
+		for (j = 0; j < 4; ++j) {
+			if (nodes[tn[j]])
+				continue;
+			if (vnChoices[i].vertexMatch)  // don't record the least satisfying correspondence.
+				nodes[tn[j]] = 1;
+			newVnbt->_nodeSpatialCoords[tn[j]] = _oldNodePositions[oN[j]];
 		}
-		else
-			throw(std::logic_error("Program error 2 in remapTetPhysics.\n"));
 	}
-	// following 4 lines guaranteed tp be unique tets
-	for(int i=0; i< newVnbt->_nMegatets; ++i)
-		processTet(i);
-	for (int n = newVnbt->_tetNodes.size(), i = newVnbt->_firstInteriorTet; i < n; ++i) 
-		processTet(i);
-	for (int i = newVnbt->_nMegatets; i < newVnbt->_firstInteriorTet; ++i)
-		processTet(i);
 	_oldNodePositions.clear();
 	_oldTetCentroids.clear();
 	_oldVertexTets.clear();
@@ -15,9 +15,9 @@ class remapTetPhysics
 public:
 	typedef std::array<unsigned short, 3> bccTetCentroid;
 	void getOldPhysicsData(vnBccTetrahedra *oldVnbt);
-	void remapNewPhysicsNodePositions(vnBccTetrahedra *newVnbt);  // done before new physics library made
+	void remapNewPhysicsNodePositions(vnBccTetrahedra *newVnbt);  // done before new physics library made.  Multithreaded.
 	inline void clearVnTetTris() { _newVnTetTris.clear(); }
-	inline void insertVnTetTris(int oldTet, std::vector<int> tris) {_newVnTetTris.insert(std::make_pair(oldTet, tris)); }
+	inline void insertVnTetTris(int tet, std::vector<int> tris) { _newVnTetTris.push_back(vnTetTris()); _newVnTetTris.back().tet = tet; _newVnTetTris.back().tris = std::move(tris); }
 	void clear();  // Clear all data
 	remapTetPhysics();
 	~remapTetPhysics();
@@ -60,14 +60,22 @@ private:
 		int vertex;
 		Vec3f loc;
 	};
-	std::unordered_multimap<int, std::vector<int> > _oldVnTetTris, _newVnTetTris;
+	struct vnTetTris {
+		int tet;
+		std::vector<int> tris;  // sorted
+		bool operator<(const vnTetTris& vt) const { return tet < vt.tet; }
+	};
+	std::vector<vnTetTris> _oldVnTetTris, _newVnTetTris;  // sorted by tet before lookups
 //	std::unordered_multimap<int, vnTetVert> _oldVnTetLocs, _newVnTetLocs;
 	std::vector<Vec3f> _oldNodePositions;
 	std::vector<int> _oldVertexTets;
 	std::vector< bccTetCentroid> _oldTetCentroids;
-	std::unordered_multimap<bccTetCentroid, int, vnBccTetrahedra::bccTetCentroidHasher> _oldTetHash;
+	flatCentroidMultimap<bccTetCentroid> _oldTetHash;
 	std::vector<std::array<int, 4> > _oldTets;
 	std::vector<std::array<short, 3> > _oldNodes;
+
+	const std::vector<int>* findVnTetTris(const std::vector<vnTetTris>& vtt, const int tet) const;
+	static void vertexSet(materialTriangles* mt, const std::vector<int>& tris, std::vector<int>& verts);  // sorted unique vertices of tris
 };
 
 #endif  // __REMAP_TET_PHYSICS__
\ No newline at end of file
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////
+// File: simulationThread.cpp
+// Date: 10/16/2026
+// Purpose: Dedicated physics thread with an ordered command queue and triple buffered node positions.  See simulationThread.h.
+////////////////////////////////////////////////////////////////////////////
+
+#include "simulationThread.h"
+
+void simulationThread::start(std::function<bool()> step)
+{
+	stop();
+	_step = step;
+	_stop = false;
+	_woken = true;
+	_thread = std::thread(&simulationThread::run, this);
+}
+
+void simulationThread::stop()
+{
+	if (!_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wakeCv.notify_one();
+	_thread.join();
+}
+
+std::future<void> simulationThread::submit(std::function<void()> command)
+{
+	std::packaged_task<void()> task(command);
+	std::future<void> ret = task.get_future();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_commands.push_back(std::move(task));
+		++_commandsInFlight;
+	}
+	_wakeCv.notify_one();
+	return ret;
+}
+
+void simulationThread::wake()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_woken = true;
+	}
+	_wakeCv.notify_one();
+}
+
+bool simulationThread::commandsDone()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _commandsInFlight < 1;
+}
+
+bool simulationThread::idle()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _commandsInFlight < 1 && !_busy;
+}
+
+void simulationThread::waitIdle()
+{
+	if (onSimulationThread())  // called from within a command, which is by definition the only thing running
+		return;
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idleCv.wait(lock, [this] { return _commandsInFlight < 1 && !_busy; });
+}
+
+void simulationThread::run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		if (!_commands.empty()) {
+			std::packaged_task<void()> command = std::move(_commands.front());
+			_commands.pop_front();
+			_busy = true;
+			lock.unlock();
+			command();  // packaged_task stores any exception in its future
+			lock.lock();
+			_busy = false;
+			--_commandsInFlight;
+			_idleCv.notify_all();
+			continue;
+		}
+		if (_stop)
+			break;
+		// a command or wake() may have made the step runnable, so always try it once before sleeping
+		_woken = false;
+		_busy = true;
+		lock.unlock();
+		bool moreWork = _step();
+		lock.lock();
+		_busy = false;
+		_idleCv.notify_all();
+		if (!moreWork)
+			_wakeCv.wait(lock, [this] { return _woken || _stop || !_commands.empty(); });
+	}
+}
+
+void simulationThread::publishPositions(const Vec3f* nodeSpatialCoords, const int nNodes)
+{
+	std::lock_guard<std::mutex> lock(_publishMutex);
+	_positions[_write].assign(nodeSpatialCoords, nodeSpatialCoords + nNodes);
+	_write = _ready.exchange(_write | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+const std::vector<Vec3f>& simulationThread::acquirePositions()
+{
+	if (_ready.load(std::memory_order_relaxed) & FRESH)
+		_read = _ready.exchange(_read, std::memory_order_acq_rel) & ~FRESH;
+	return _positions[_read];
+}
+
+simulationThread::simulationThread() : _commandsInFlight(0), _busy(false), _woken(false), _stop(false), _write(0), _read(1), _ready(2)
+{
+}
+
+simulationThread::~simulationThread()
+{
+	stop();
+}
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////
+// File: simulationThread.h
+// Date: 10/16/2026
+// Purpose: Dedicated thread that owns the physics.  It iterates a step function continuously while the step reports work, and runs
+//     commands submitted from the GUI thread in order between iterations, each returning a future.  Node positions published after
+//     a step or command go into a triple buffer, so the renderer takes the newest complete set with one atomic exchange and neither
+//     side ever waits on or tears against the other.
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SIMULATION_THREAD__
+#define __SIMULATION_THREAD__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include "Vec3f.h"
+
+class simulationThread
+{
+public:
+	void start(std::function<bool()> step);  // step returns false when there is nothing to solve, idling the thread until wake() or a new command
+	void stop();  // runs any commands already queued, then joins
+	std::future<void> submit(std::function<void()> command);  // an exception thrown by command is delivered through the future
+	void wake();  // step may have work again
+	bool commandsDone();  // no command queued or running.  On the only submitting thread this stays true until it submits again.
+	bool idle();  // commandsDone() and no step running
+	void waitIdle();  // Blocks until idle().  Stop the step from reporting work first or this may never return.  Returns at once on the simulation thread.
+	inline bool onSimulationThread() const { return std::this_thread::get_id() == _thread.get_id(); }
+
+	void publishPositions(const Vec3f* nodeSpatialCoords, const int nNodes);  // any thread, normally the simulation thread
+	const std::vector<Vec3f>& acquirePositions();  // renderer thread only.  Valid until its next acquirePositions().
+
+	simulationThread();
+	~simulationThread();
+
+private:
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _wakeCv, _idleCv;
+	// below guarded by _mutex
+	std::deque<std::packaged_task<void()> > _commands;
+	int _commandsInFlight;  // queued plus running
+	bool _busy, _woken, _stop;
+	std::function<bool()> _step;
+
+	static const int FRESH = 4;  // or'ed into _ready when it holds a set the renderer hasn't taken
+	std::vector<Vec3f> _positions[3];
+	std::mutex _publishMutex;  // only serializes producers.  The renderer never locks.
+	int _write, _read;
+	std::atomic<int> _ready;
+
+	void run();
+};
+
+#endif  // __SIMULATION_THREAD__
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////
+// File: spatialTetBvh.cpp
+// Date: 10/16/2026
+// Purpose: Bounding volume hierarchy over deformed bcc tets for spatial point location.  See spatialTetBvh.h.
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "Mat3x3f.h"
+#include "tbb/tbb.h"
+#include "spatialTetBvh.h"
+
+void spatialTetBvh::clear()
+{
+	_tree.clear();
+	_tets.clear();
+}
+
+void spatialTetBvh::build(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const int nMegatets, const int firstInteriorTet)
+{
+	clear();
+	int nTets = (int)tetNodes.size();
+	_tets.reserve(nMegatets + nTets - firstInteriorTet);
+	for (int i = 0; i < nMegatets; ++i)
+		_tets.push_back(i);
+	for (int i = std::max(firstInteriorTet, nMegatets); i < nTets; ++i)
+		_tets.push_back(i);
+	if (_tets.empty())
+		return;
+	std::vector<Vec3f> centers(nTets);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, _tets.size()), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i) {
+			const int* tn = tetNodes[_tets[i]].data();
+			Vec3f c = nodeSpatialCoords[tn[0]];
+			for (int j = 1; j < 4; ++j)
+				c += nodeSpatialCoords[tn[j]];
+			centers[_tets[i]] = c * 0.25f;
+		}
+	});
+	_tree.build(_tets, centers);
+	refit(tetNodes, nodeSpatialCoords);
+}
+
+void spatialTetBvh::tetBox(const std::array<int, 4>& tn, const Vec3f* nodeSpatialCoords, boxTree::box& b)
+{
+	b.set(nodeSpatialCoords[tn[0]]);
+	for (int i = 1; i < 4; ++i)
+		b.enlarge(nodeSpatialCoords[tn[i]]);
+}
+
+void spatialTetBvh::refit(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords)
+{
+	_tree.refit(_tets, [&](const int tet, boxTree::box& b) { tetBox(tetNodes[tet], nodeSpatialCoords, b); });
+}
+
+bool spatialTetBvh::insideTet(const std::array<int, 4>& tn, const Vec3f* nodeSpatialCoords, const Vec3f& position, Vec3f& barycentricWeight)
+{
+	const Vec3f& v0 = nodeSpatialCoords[tn[0]];
+	Mat3x3f M;
+	M.Initialize_With_Column_Vectors(nodeSpatialCoords[tn[1]] - v0, nodeSpatialCoords[tn[2]] - v0, nodeSpatialCoords[tn[3]] - v0);
+	Vec3f R = M.Robust_Solve_Linear_System(position - v0);
+	if (R[0] <= 0.0f || R[1] <= 0.0f || R[2] <= 0.0f || R[0] >= 1.0f || R[1] >= 1.0f || R[2] >= 1.0f || R[0] + R[1] + R[2] >= 1.0f)
+		return false;
+	barycentricWeight = R;
+	return true;
+}
+
+int spatialTetBvh::locate(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const Vec3f& position, Vec3f& barycentricWeight) const
+{
+	int tet = -1;
+	_tree.query([&](const boxTree::box& b) { return b.contains(position); }, [&](const int k) {
+		int t = _tets[k];
+		Vec3f bw;
+		if ((tet < 0 || t < tet) && insideTet(tetNodes[t], nodeSpatialCoords, position, bw)) {
+			tet = t;
+			barycentricWeight = bw;
+		}
+	});
+	return tet;
+}
+
+void spatialTetBvh::locate(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const std::vector<Vec3f>& positions,
+	std::vector<int>& tets, std::vector<Vec3f>& barycentricWeights) const
+{
+	tets.assign(positions.size(), -1);
+	barycentricWeights.resize(positions.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, positions.size()), [&](const tbb::blocked_range<size_t>& r) {
+		for (size_t i = r.begin(); i != r.end(); ++i)
+			tets[i] = locate(tetNodes, nodeSpatialCoords, positions[i], barycentricWeights[i]);
+	});
+}
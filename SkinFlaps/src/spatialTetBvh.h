@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////
+// File: spatialTetBvh.h
+// Date: 10/16/2026
+// Purpose: Bounding volume hierarchy over the deformed tets of a vnBccTetrahedra lattice for spatial point location.  Only the megatets and the
+//     unique interior tets are entered as the virtual noded surface tets overlap in space.  Topology is fixed at build(), so the hierarchy
+//     is rebuilt only when the lattice changes and refit() in place when the node spatial coordinates move.
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SPATIAL_TET_BVH__
+#define __SPATIAL_TET_BVH__
+
+#include <vector>
+#include <array>
+#include "Vec3f.h"
+#include "boxTree.h"
+
+class spatialTetBvh
+{
+public:
+	void clear();
+	inline bool empty() { return _tree.empty(); }
+	// tets 0 to nMegatets-1 and firstInteriorTet to the end of tetNodes are entered
+	void build(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const int nMegatets, const int firstInteriorTet);
+	void refit(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords);  // multithreaded
+	// Returns the lowest numbered tet strictly containing position, so megatets take precedence, or -1 if none does.
+	int locate(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const Vec3f& position, Vec3f& barycentricWeight) const;
+	void locate(const std::vector<std::array<int, 4> >& tetNodes, const Vec3f* nodeSpatialCoords, const std::vector<Vec3f>& positions,
+		std::vector<int>& tets, std::vector<Vec3f>& barycentricWeights) const;  // multithreaded
+
+	spatialTetBvh() {}
+	~spatialTetBvh() {}
+
+private:
+	boxTree _tree;
+	std::vector<int> _tets;  // leaf tet ranges
+
+	static void tetBox(const std::array<int, 4>& tn, const Vec3f* nodeSpatialCoords, boxTree::box& b);
+	static bool insideTet(const std::array<int, 4>& tn, const Vec3f* nodeSpatialCoords, const Vec3f& position, Vec3f& barycentricWeight);
+};
+
+#endif  // __SPATIAL_TET_BVH__
@@ -10,11 +10,10 @@
 #include "insidePolygon.h"
 #include "prettyPrintJSON.h"
 #include "surgGraphics.h"
-#include <tbb/task_arena.h>
 #include "FacialFlapsGui.h"
 #include "surgicalActions.h"
 
-surgicalActions::surgicalActions() : _toolState(0), _originalTriangleNumber(0), _sceneDir("0"), _historyDir("0"), _strongHooks(false), physicsDone(true), newTopology(false), taskThreadError(false)
+surgicalActions::surgicalActions() : _toolState(0), _originalTriangleNumber(0), _sceneDir("0"), _historyDir("0"), _strongHooks(false), _showHistorySteps(true), newTopology(false), taskThreadError(false), _hookDragNumber(-1), _hookDragSerial(0), _hookDragQueued(false)
 {
 	_bts.setSurgicalActions(this);
 	_historyArray.Clear();
@@ -80,8 +79,7 @@ bool surgicalActions::rightMouseDown(std::string objectHit, float (&position)[3]
 	if (_toolState > 0) {  // active tool requested by user
 		_bts.setPhysicsPause(true);  // stop doing physics updates
 		// prevent user from doing a new op until previous one is finished
-		while (!physicsDone)  // physics update thread must be complete before doing next op.
-			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 	}
 	if(_toolState==0)	//viewer
 	{
@@ -158,21 +156,7 @@ bool surgicalActions::rightMouseDown(std::string objectHit, float (&position)[3]
 
 			if (!_bts.getPdTetPhysics_2()->solverInitialized()) {  // solver must be initialized to add a hook
 				_bts.setForcesAppliedFlag();
-				physicsDone = false;
-				_ffg->physicsDrag = true;
-				tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-					try {
-						_bts.initPdPhysics();
-						physicsDone = true;
-					}
-					catch (...) {
-						physicsDone = true;
-						_ffg->physicsDrag = false;
-						taskThreadError = true;
-						taskThreadErrorStr = "Couldn't initialize physics after adding hook.";
-					}
-					}
-				);
+				simulationCommand([this]() { _bts.initPdPhysics(); }, "Couldn't initialize physics after adding hook.", false);
 			}
 			_sutures.selectSuture(-1);
 			_hooks.selectHook(hookNum);
@@ -445,22 +429,7 @@ bool surgicalActions::rightMouseDown(std::string objectHit, float (&position)[3]
 		_historyArray.push_back(exciseTitle);
 		_historyIt = _historyArray.end();
 		_incisions.excise(triangle);
-		physicsDone = false;
-		_ffg->physicsDrag = true;
-		tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-			try {
-				_bts.updateOldPhysicsLattice();
-				newTopology = true;
-				physicsDone = true;
-			}
-			catch (...) {
-				physicsDone = true;
-				_ffg->physicsDrag = false;
-				taskThreadError = true;
-				taskThreadErrorStr = "Topological error following excision.";
-			}
-			}
-		);
+		simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Topological error following excision.", true);
 		_bts.setPhysicsPause(false);
 		_hooks.selectHook(-1);
 		_sutures.selectSuture(-1);
@@ -552,7 +521,7 @@ bool surgicalActions::rightMouseUp(std::string objectHit, float (&position)[3],
 		_selectedSurgObject = "";
 	else if (_toolState == 4)	{	// finish applying a suture
 		// prevent user from doing a new op until previous one is finished
-		assert(physicsDone);  // physics update thread must be complete before doing next op.
+		assert(_bts.physicsIdle());  // physics thread must be idle before doing next op.
 		assert(_selectedSurgObject.substr(0,2)=="S_");
 		materialTriangles *tr = NULL;
 		int i = atoi(_selectedSurgObject.c_str()+2);
@@ -568,7 +537,7 @@ bool surgicalActions::rightMouseUp(std::string objectHit, float (&position)[3],
 		float param, uv[2];
 		auto invalidate = [&]() {
 			// prevent user from doing a new op until previous one is finished
-			if (!physicsDone)  // physics update thread must be complete before doing next op.
+			if (!_bts.physicsIdle())  // physics thread must be idle before doing next op.
 				throw(std::logic_error("Trying to invalidate a suture while a physics thread is active.\n"));
 			_sutures.deleteSuture(i);
 			_bts.setPhysicsPause(false);
@@ -672,22 +641,9 @@ bool surgicalActions::rightMouseUp(std::string objectHit, float (&position)[3],
 		}
 		int sRet = _sutures.setSecondEdge(i, tr, eTri, edge, param);
 		_bts.setForcesAppliedFlag();
+		std::future<void> physicsInit;
 		if (!_bts.getPdTetPhysics_2()->solverInitialized()) {  // solver must be initialized to add a suture
-			physicsDone = false;
-			_ffg->physicsDrag = true;
-			tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-				try {
-					_bts.initPdPhysics();
-					physicsDone = true;
-				}
-				catch (...) {
-					physicsDone = true;
-					_ffg->physicsDrag = false;
-					taskThreadError = true;
-					taskThreadErrorStr = "Couldn't initialize physics after adding hook.";
-				}
-				}
-			);
+			physicsInit = simulationCommand([this]() { _bts.initPdPhysics(); }, "Couldn't initialize physics after adding hook.", false);
 		}
 		if (sRet < 1){
 			float pos[3], uv[2] = {0.0f, 0.0f};
@@ -700,25 +656,11 @@ bool surgicalActions::rightMouseUp(std::string objectHit, float (&position)[3],
 				uv[1] = param;
 			}
 			tr->getBarycentricPosition(eTri, uv, pos);
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			if (physicsInit.valid())
+				physicsInit.wait();
 			_sutures.setSecondVertexPosition(i, pos);
 			if (_sutures.isLinked(i)) {
-				physicsDone = false;
-				_ffg->physicsDrag = true;
-				tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-					try {
-						_sutures.laySutureLine(i);
-						physicsDone = true;
-					}
-					catch (...) {
-						physicsDone = true;
-						_ffg->physicsDrag = false;
-						taskThreadError = true;
-						taskThreadErrorStr = "Error in placing a linked suture line";
-					}
-					}
-				);
+				simulationCommand([this, i]() { _sutures.laySutureLine(i); }, "Error in placing a linked suture line", false);
 			}
 		}
 		else if (sRet < 2){
@@ -877,14 +819,21 @@ bool surgicalActions::mouseMotion(float dScreenX, float dScreenY)
 	else if (_toolState != 1 && _selectedSurgObject.substr(0, 2) == "H_")	// hook selected.
 	{
 		int hookNum = atoi(_selectedSurgObject.c_str() + 2);
-		_hooks.getHookPosition(hookNum, xyz.xyz);
+		{
+			std::lock_guard<std::mutex> lock(_hookDragLock);
+			if (_hookDragQueued) {
+				if (_hookDragNumber != hookNum)
+					return false;  // previous hook's last move is still queued
+				xyz = _hookDragXyz;  // continue from the target the simulation thread has not applied yet
+			}
+			else
+				_hooks.getHookPosition(hookNum, xyz.xyz);
+		}
 		_gl3w->getGLmatrices()->getDragVector(dScreenX, dScreenY, xyz.xyz, dv.xyz);
 		
 		// MACOS PORT: Skip physics if no actual movement
-		if (dv.xyz[0] == 0.0f && dv.xyz[1] == 0.0f && dv.xyz[2] == 0.0f) {
-			std::cout << "DEBUG: No movement detected, skipping physics update" << std::endl;
+		if (dv.xyz[0] == 0.0f && dv.xyz[1] == 0.0f && dv.xyz[2] == 0.0f)
 			return false;
-		}
 		
 		// MACOS PORT: If shift key is held, constrain movement along hook axis
 		if (_ffg->CtrlOrShiftKeyIsDown()) {
@@ -905,8 +854,6 @@ bool surgicalActions::mouseMotion(float dScreenX, float dScreenY)
 					// Project the drag vector onto the hook axis
 					float projection = dv * hookAxis;
 					dv = hookAxis * projection;
-					
-					std::cout << "DEBUG: Shift-constrained hook movement along axis" << std::endl;
 				}
 			}
 		}
@@ -920,7 +867,6 @@ bool surgicalActions::mouseMotion(float dScreenX, float dScreenY)
 			dv.xyz[0] *= scale;
 			dv.xyz[1] *= scale;
 			dv.xyz[2] *= scale;
-			std::cout << "DEBUG: Limited hook displacement from " << displacement << " to " << MAX_DISPLACEMENT << std::endl;
 		}
 		
 		// Add damping to smooth movement
@@ -930,20 +876,40 @@ bool surgicalActions::mouseMotion(float dScreenX, float dScreenY)
 		lastDv = dv;
 		
 		xyz += dv;
-		std::cout << "DEBUG: Moving hook " << hookNum << " by (" << dv.xyz[0] << ", " << dv.xyz[1] << ", " << dv.xyz[2] << ")" << std::endl;
 		_bts.setForcesAppliedFlag();  // this is a hook move so forces are applied
-		std::cout << "DEBUG: Forces applied flag set" << std::endl;
-		if (!_bts.isPhysicsPaused() || !physicsDone) {
-			std::cout << "DEBUG: Pausing physics - isPaused=" << _bts.isPhysicsPaused() << ", physicsDone=" << physicsDone << std::endl;
-			_bts.setPhysicsPause(true);  // stop doing physics updates
-			// prevent user from doing a new op until previous one is finished
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		std::lock_guard<std::mutex> lock(_hookDragLock);
+		_hookDragNumber = hookNum;
+		_hookDragXyz = xyz;
+		++_hookDragSerial;
+		if (!_hookDragQueued) {
+			_hookDragQueued = true;
+			simulationCommand([this]() {
+				try {
+					for (;;) {  // apply the newest target until the gui stops replacing it
+						int num;
+						Vec3f target;
+						unsigned int serial;
+						{
+							std::lock_guard<std::mutex> lock(_hookDragLock);
+							num = _hookDragNumber;
+							target = _hookDragXyz;
+							serial = _hookDragSerial;
+						}
+						_hooks.setHookPosition(num, target.xyz);
+						std::lock_guard<std::mutex> lock(_hookDragLock);
+						if (serial == _hookDragSerial) {
+							_hookDragQueued = false;
+							break;
+						}
+					}
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(_hookDragLock);
+					_hookDragQueued = false;
+					throw;
+				}
+			}, "Hook move failed.", false, false);
 		}
-		_hooks.setHookPosition(hookNum, xyz.xyz);
-		std::cout << "DEBUG: Hook position set to (" << xyz.xyz[0] << ", " << xyz.xyz[1] << ", " << xyz.xyz[2] << ")" << std::endl;
-		_bts.setPhysicsPause(false);
-		std::cout << "DEBUG: Physics unpaused" << std::endl;
 	}
 	else
 		;
@@ -983,8 +949,7 @@ void surgicalActions::onKeyDown(int key)
 			int hookNum = atoi(_selectedSurgObject.c_str()+2);
 			// prevent user from doing a new op until previous one is finished
 			_bts.setPhysicsPause(true);  // don't spawn another physics update till complete
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			_hooks.deleteHook(hookNum);
 			_bts.setPhysicsPause(false);
 			if (_historyIt != _historyArray.end()) {
@@ -1013,8 +978,7 @@ void surgicalActions::onKeyDown(int key)
 			int userNum = _sutures.baseToUserSutureNumber(sutNum);
 			_bts.setPhysicsPause(true);  // don't spawn another physics update till complete
 			// prevent user from doing a new op until previous one is finished
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			int linkNum = _sutures.deleteSuture(sutNum);
 			if (userNum < 0) {
 				json::Object lObj;
@@ -1037,33 +1001,18 @@ void surgicalActions::onKeyDown(int key)
 		// prevent user from doing a new op until previous one is finished
 		if (_toolState == 7){	//periosteal undermine mode
 			_bts.setPhysicsPause(true);  // should already be done
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			materialTriangles *mt = _sg.getMaterialTriangles();
 			for (int n = mt->numberOfTriangles(), i = 0; i < n; ++i){
 				if (mt->triangleMaterial(i) == 10)
 					mt->setTriangleMaterial(i, 8);  // 8 is a periosteal triangle that has been undermined
 			}
 			_bts.updateSurfaceDraw();
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
-			physicsDone = false;
-			_ffg->physicsDrag = true;
-			tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-				try {
-					_bts.fixPeriostealPeriferalVertices();
-					_bts.nonTetPhysicsUpdate();
-					newTopology = true;
-					physicsDone = true;
-				}
-				catch (...) {
-					physicsDone = true;
-					_ffg->physicsDrag = false;
-					taskThreadError = true;
-					taskThreadErrorStr = "Periosteal undermine error.";
-				}
-				}
-			);
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
+			simulationCommand([this]() {
+				_bts.fixPeriostealPeriferalVertices();
+				_bts.nonTetPhysicsUpdate();
+			}, "Periosteal undermine error.", true);
 			_bts.setPhysicsPause(false);
 			if (_historyIt != _historyArray.end()) {
 				json::Array tarr;
@@ -1163,25 +1112,9 @@ void surgicalActions::onKeyDown(int key)
 				else {
 					if (_incisions.physicsRecutRequired()){
 						_bts.setPhysicsPause(true);  // don't spawn another physics update till complete
-						while (!physicsDone)  // physics update thread must be complete before doing next op.
-							std::this_thread::sleep_for(std::chrono::milliseconds(20));
+						_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 
-						physicsDone = false;
-						_ffg->physicsDrag = true;
-						tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-							try {
-								_bts.updateOldPhysicsLattice();
-								newTopology = true;
-								physicsDone = true;
-							}
-							catch (...) {
-								physicsDone = true;
-								_ffg->physicsDrag = false;
-								taskThreadErrorStr = "An incision requiring physics recut failed.";
-								taskThreadError = true;
-							}
-							}
-						);
+						simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "An incision requiring physics recut failed.", true);
 					}
 					else {
 						newTopology = true;
@@ -1228,28 +1161,12 @@ void surgicalActions::onKeyDown(int key)
 			_historyArray.push_back(uObj);
 			_historyIt = _historyArray.end();
 			_bts.setPhysicsPause(true);  // should already be done
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			_bts.updateSurfaceDraw();
 			_incisions.undermineSkin();
 			_undermineTriangles.clear();
 
-			physicsDone = false;
-			_ffg->physicsDrag = true;
-			tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-				try {
-					_bts.updateOldPhysicsLattice();
-					newTopology = true;
-					physicsDone = true;
-				}
-				catch (...) {
-					physicsDone = true;
-					_ffg->physicsDrag = false;
-					taskThreadErrorStr = "Topology error after undermine operation.";
-					taskThreadError = true;
-				}
-				}
-			);
+			simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Topology error after undermine operation.", true);
 			_bts.setPhysicsPause(false);
 		}
 		else if (_toolState == 6)	// deep cut mode
@@ -1310,8 +1227,7 @@ void surgicalActions::onKeyDown(int key)
 			_historyIt = _historyArray.end();
 			if (!_bts.isPhysicsPaused())
 				throw(std::logic_error("Physics must be paused before deep cut."));
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			_bts.updateSurfaceDraw();
 			if (!_incisions.cutDeep()) {
 				sendUserMessage("Attempted deepCut failed. Save history to debug.", "PROGRAM ERROR");
@@ -1319,22 +1235,7 @@ void surgicalActions::onKeyDown(int key)
 			}
 			_ffg->user_message_flag = false;
 
-			physicsDone = false;
-			_ffg->physicsDrag = true;
-			tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-				try {
-					_bts.updateOldPhysicsLattice();
-					newTopology = true;
-					physicsDone = true;
-				}
-				catch (...) {
-					physicsDone = true;
-					_ffg->physicsDrag = false;
-					taskThreadErrorStr = "Deep cut failure.";
-					taskThreadError = true;
-				}
-				}
-			);
+			simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Deep cut failure.", true);
 			_fence.clear();
 			_incisions.clearDeepCutter();
 			_bts.setPhysicsPause(false);
@@ -1864,6 +1765,31 @@ void surgicalActions::pausePhysics()
 	_bts.setPhysicsPause(true);
 }
 
+std::future<void> surgicalActions::simulationCommand(std::function<void()> command, const char* failureMessage, const bool topologyChange, const bool showHourglass)
+{
+	if (showHourglass)
+		_ffg->physicsDrag = true;
+	return _bts.getSimulationThread()->submit([this, command, failureMessage, topologyChange]() {
+		try {
+			command();
+			if (topologyChange)
+				newTopology = true;
+		}
+		catch (...) {
+			_ffg->physicsDrag = false;
+			taskThreadErrorStr = failureMessage;
+			taskThreadError = true;
+		}
+	});
+}
+
+std::string surgicalActions::nextHistoryActionName()
+{
+	if (_historyIt == _historyArray.end() || _historyIt->GetType() != json::ObjectVal || _historyIt->ToObject().size() < 1)
+		return std::string();
+	return _historyIt->ToObject().begin()->first;
+}
+
 void surgicalActions::nextHistoryAction()
 {
 	if (_historyIt == _historyArray.end()) {
@@ -1872,9 +1798,9 @@ void surgicalActions::nextHistoryAction()
 	}
 	_bts.setPhysicsPause(true);  // don't spawn another physics update till complete
 	// prevent user from doing a new op until previous one is finished
-	while (!physicsDone)  // physics update thread must be complete before doing next op.
-		std::this_thread::sleep_for(std::chrono::milliseconds(20));
-	_gl3w->drawAll();
+	_bts.waitForPhysics();  // physics thread must be idle before doing next op.
+	if (_showHistorySteps)
+		_gl3w->drawAll();
 	if (_historyIt->HasKey("loadSceneFile"))
 	{
 		const json::Object& fObj = _historyIt->ToObject();
@@ -1932,21 +1858,7 @@ void surgicalActions::nextHistoryAction()
 		{
 			if (!_bts.getPdTetPhysics_2()->solverInitialized()) {  // solver must be initialized to add a hook. Done once.
 				_bts.setForcesAppliedFlag();
-				physicsDone = false;
-				_ffg->physicsDrag = true;
-				tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-					try {
-						_bts.initPdPhysics();
-						physicsDone = true;
-					}
-					catch (...) {
-						physicsDone = true;
-						_ffg->physicsDrag = false;
-						taskThreadError = true;
-						taskThreadErrorStr = "Couldn't initialize physics after adding hook.";
-					}
-					}
-				);
+				simulationCommand([this]() { _bts.initPdPhysics(); }, "Couldn't initialize physics after adding hook.", false);
 			}
 			_sutures.selectSuture(-1);
 			_hooks.selectHook(hookNum);
@@ -2045,23 +1957,7 @@ void surgicalActions::nextHistoryAction()
 		else {
 			if (_incisions.physicsRecutRequired()) {
 				_bts.setForcesAppliedFlag();
-				// Unfortunately this recurring code block doesn't work if put into a lambda. Only Intel knows-
-				physicsDone = false;
-				_ffg->physicsDrag = true;
-				tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-					try {
-						_bts.updateOldPhysicsLattice();
-						newTopology = true;
-						physicsDone = true;
-					}
-					catch (...) {
-						physicsDone = true;
-						_ffg->physicsDrag = false;
-						taskThreadErrorStr = "Couldn't update physics after incision requiring recut.";
-						taskThreadError = true;
-					}
-					}
-				);
+				simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Couldn't update physics after incision requiring recut.", true);
 			}
 			else
 				newTopology = true;
@@ -2098,27 +1994,14 @@ void surgicalActions::nextHistoryAction()
 			}
 			_incisions.addUndermineTriangle(tri, 2, ic);
 		}
-		_gl3w->drawAll();
-		glfwSwapBuffers(_ffg->FFwindow);
-		std::this_thread::sleep_for(std::chrono::milliseconds(800));
+		if (_showHistorySteps) {  // let the user see the undermine region before it is cut
+			_gl3w->drawAll();
+			glfwSwapBuffers(_ffg->FFwindow);
+			std::this_thread::sleep_for(std::chrono::milliseconds(800));
+		}
 		_incisions.undermineSkin();
 		_undermineTriangles.clear();
-		physicsDone = false;
-		_ffg->physicsDrag = true;
-		tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-			try {
-				_bts.updateOldPhysicsLattice();
-				newTopology = true;
-				physicsDone = true;
-			}
-			catch (...) {
-				physicsDone = true;
-				_ffg->physicsDrag = false;
-				taskThreadErrorStr = "Topology error following an undermine.";
-				taskThreadError = true;
-			}
-			}
-		);
+		simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Topology error following an undermine.", true);
 		++_historyIt;
 	}
 	else if (_historyIt->HasKey("excise"))
@@ -2145,22 +2028,7 @@ void surgicalActions::nextHistoryAction()
 		}
 		_incisions.excise(tri);
 
-		physicsDone = false;
-		_ffg->physicsDrag = true;
-		tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-			try {
-				_bts.updateOldPhysicsLattice();
-				newTopology = true;
-				physicsDone = true;
-			}
-			catch (...) {
-				physicsDone = true;
-				_ffg->physicsDrag = false;
-				taskThreadErrorStr = "Topology error found after excision.";
-				taskThreadError = true;
-			}
-			}
-		);
+		simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Topology error found after excision.", true);
 		++_historyIt;
 	}
 	else if (_historyIt->HasKey("addSuture"))
@@ -2283,23 +2151,12 @@ void surgicalActions::nextHistoryAction()
 			_sutures.setLinked(sn, true);
 		int sRet = _sutures.setSecondEdge(sn, tr, eTri, edge, param);
 		_bts.setForcesAppliedFlag();
+		std::future<void> physicsInit;
 		if (!_bts.getPdTetPhysics_2()->solverInitialized()) {  // solver must be initialized to add a suture
-			physicsDone = false;
-			_ffg->physicsDrag = true;
-			tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-				try {
-					_bts.initPdPhysics();
-					physicsDone = true;
-				}
-				catch (...) {
-					physicsDone = true;
-					_ffg->physicsDrag = false;
-					taskThreadError = true;
-					taskThreadErrorStr = "Couldn't initialize physics after adding hook.";
-				}
-				}
-			);
+			physicsInit = simulationCommand([this]() { _bts.initPdPhysics(); }, "Couldn't initialize physics after adding hook.", false);
 		}
+		if (physicsInit.valid())
+			physicsInit.wait();
 		if (sRet < 1)
 			_sutures.setSecondVertexPosition(sn, xyz);
 		else if (sRet < 2) {
@@ -2312,10 +2169,8 @@ void surgicalActions::nextHistoryAction()
 		else
 			assert(false);
 		if(_sutures.isLinked(sn)){
-			physicsDone = false;
 			_ffg->physicsDrag = true;
 			_sutures.laySutureLine(sn);
-			physicsDone = true;
 		}
 		else
 			_sutures.setLinked(sn, false);
@@ -2330,8 +2185,7 @@ void surgicalActions::nextHistoryAction()
 		_selectedSurgObject = s;
 		++_historyIt;
 		if (_historyIt == _historyArray.end()) {  // automatically promote any fake sutures if this is the last one
-			while (!physicsDone)  // physics update thread must be complete before doing next op.
-				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			_bts.waitForPhysics();  // physics thread must be idle before doing next op.
 			_bts.promoteSutures();
 		}
 	}
@@ -2426,7 +2280,6 @@ void surgicalActions::nextHistoryAction()
 			_ffg->setToolState(0);
 			setToolState(0);
 			_bts.setPhysicsPause(false);
-			physicsDone = true;
 			_ffg->physicsDrag = false;
 			return;
 		}
@@ -2436,22 +2289,7 @@ void surgicalActions::nextHistoryAction()
 			taskThreadErrorStr = "Attempted deep cut failed.";
 		}
 
-		physicsDone = false;
-		_ffg->physicsDrag = true;
-		tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-			try {
-				_bts.updateOldPhysicsLattice();
-				newTopology = true;
-				physicsDone = true;
-			}
-			catch (...) {
-				physicsDone = true;
-				_ffg->physicsDrag = false;
-				taskThreadError = true;
-				taskThreadErrorStr = "Topology error found after deepCut.";
-			}
-			}
-		);
+		simulationCommand([this]() { _bts.updateOldPhysicsLattice(); }, "Topology error found after deepCut.", true);
 		_fence.clear();
 		++_historyIt;
 	}
@@ -2487,22 +2325,7 @@ void surgicalActions::nextHistoryAction()
 		// all periosteal undermine triangles now marked as material 10
 		_incisions.clearCurrentUndermine(8);  // set all periosteal undermined triangles to material 8 and reset.
 		_bts.fixPeriostealPeriferalVertices();
-		physicsDone = false;
-		_ffg->physicsDrag = true;
-		tbb::task_arena(tbb::task_arena::attach()).enqueue([&]() {
-			try {
-				_bts.nonTetPhysicsUpdate();
-				newTopology = true;
-				physicsDone = true;
-			}
-			catch (...) {
-				physicsDone = true;
-				_ffg->physicsDrag = false;
-				taskThreadError = true;
-				taskThreadErrorStr = "Error occurred after a periosteal undermine";
-			}
-			}
-		);
+		simulationCommand([this]() { _bts.nonTetPhysicsUpdate(); }, "Error occurred after a periosteal undermine", true);
 		++_historyIt;
 	}
 	else if (_historyIt->HasKey("promoteSutureApproximations"))
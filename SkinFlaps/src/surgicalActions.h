@@ -4,6 +4,10 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <functional>
 #include "hooks.h"
 #include "sutures.h"
 #include "surgGraphics.h"
@@ -45,6 +49,9 @@ public:
 	bool loadHistory(const char *historyDir, const char *historyFile);
 	void nextHistoryAction();
 	bool historyEmpty()	{return _historyArray.size()<1;}
+	bool historyFinished() { return _historyIt == _historyArray.end(); }
+	std::string nextHistoryActionName();  // key of the action nextHistoryAction() will do, empty at the end
+	inline void setShowHistorySteps(const bool show) { _showHistorySteps = show; }  // false skips display pauses during batch replay
 	bool setHistoryAttachPoint(const int triangle, const float(&uv)[2], int &material, float(&historyTexture)[2], Vec3f &historyVec);
 	// Input an attach point in current environment. Outputs a material, texture, and displacement for storage in a history file.
 	bool getHistoryAttachPoint(const int material, const float(&historyTexture)[2], const Vec3f &displacement, int &triangle, float(&uv)[2], bool findEdge);
@@ -58,7 +65,7 @@ public:
 	void promoteFakeSutures();
 	void pausePhysics();
 	bool _strongHooks;  // COURT - hack for collision cheating purposes
-	std::atomic<bool> physicsDone, newTopology, taskThreadError;
+	std::atomic<bool> newTopology, taskThreadError;
 	std::string taskThreadErrorStr;
 	bccTetScene _bts;
 	
@@ -98,7 +105,16 @@ private:
 	json::Array _historyArray;
 	json::Array::ValueVector::iterator _historyIt;	// current history command
 	std::string _sceneDir, _historyDir;
+	bool _showHistorySteps;
 	void historyAttachFailure(std::string& errorDescription);  // report failure and truncate history at just before this action.
+	// Queue command to run on the simulation thread between solver iterations.  A failure is reported through taskThreadError.
+	std::future<void> simulationCommand(std::function<void()> command, const char* failureMessage, const bool topologyChange, const bool showHourglass = true);
+	// Hook drags leave their newest target here.  At most one simulation command is queued to apply it, so the gui never waits on the solver.
+	std::mutex _hookDragLock;
+	int _hookDragNumber;
+	Vec3f _hookDragXyz;
+	unsigned int _hookDragSerial;
+	bool _hookDragQueued;
 
 	// next are temporary move variables set by ascii keys
 	float _x,_y,_z,_u,_f,_r;
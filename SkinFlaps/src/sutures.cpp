@@ -330,8 +330,7 @@ int sutures::deleteSuture(int sutureNumber)
 		_userSutures.erase(usit);
 		delSut();
 	}
-	while (!_surgAct->physicsDone)
-		;
+	_surgAct->getBccTetScene()->waitForPhysics();
 	_ptp->initializePhysics();
 	return ret;
 }
@@ -101,25 +101,30 @@ void tetCollisions::initSoftCollisions(materialTriangles* mt, vnBccTetrahedra* v
 		bedR.N = N * _rest[bedR.restIdx] * bedR.materialNormal;
 		bedR.materialNormal *= rayDepth(bedR.P, bedR.N) * 0.75f;  // scale
 	}
+	_flapTree.clear();
+	if (!_flapBotTris.empty()) {
+		std::vector<Vec3f> centers(_mt->numberOfTriangles());
+		for (auto ft : _flapBotTris) {
+			int* tr = _mt->triangleVertices(ft);
+			Vec3f v, c(0.0f, 0.0f, 0.0f);
+			for (int j = 0; j < 3; ++j) {
+				_mt->getVertexCoordinate(tr[j], v.xyz);
+				c += v;
+			}
+			centers[ft] = c;  // scale irrelevant for splitting
+		}
+		_flapTree.build(_flapBotTris, centers);
+	}
 	// _bedRay crossover ignored since will only use shortest one
 	tets.erase(-1);
  	if (!tets.empty()) {
-		// TEMPORARY: Disable soft collision on macOS to avoid Pardiso dependency
-		#ifndef __APPLE__
 		std::vector<int> tetras;
 		tetras.assign(tets.begin(), tets.end());
 		_ptp->addSoftCollisionTets(tetras);
-		#endif
 	}
 }
 
 void tetCollisions::findSoftCollisionPairs() {
-	// TEMPORARY: Disable soft collision on macOS to avoid Pardiso dependency
-	#ifdef __APPLE__
-	_ptp->clearSoftCollisions();
-	return;
-	#endif
-	
 	if (_flapBotTris.empty())
 		return;
 
@@ -134,15 +139,16 @@ void tetCollisions::findSoftCollisionPairs() {
 		Mat3x3f N(cols[0], cols[1], cols[2]);
 		bv.N = N * _rest[bv.restIdx] * bv.materialNormal;
 	}
-	std::vector<boundingBox<float> > flapBox;
-	boundingBox<float> bb;
-	bb.Empty_Box();
-	flapBox.assign(_flapBotTris.size(), bb);
-	for (size_t n = _flapBotTris.size(), i = 0; i < n; ++i) {
-		int* tr = _mt->triangleVertices(_flapBotTris[i]);
-		for (int j = 0; j < 3; ++j)
-			flapBox[i].Enlarge_To_Include_Point(reinterpret_cast<const float(&)[3]>(*_mt->vertexCoordinate(tr[j])));
-	}
+	_flapTree.refit(_flapBotTris, [&](const int tri, boxTree::box& b) {
+		int* tr = _mt->triangleVertices(tri);
+		Vec3f v;
+		_mt->getVertexCoordinate(tr[0], v.xyz);
+		b.set(v);
+		for (int j = 1; j < 3; ++j) {
+			_mt->getVertexCoordinate(tr[j], v.xyz);
+			b.enlarge(v);
+		}
+	});
 	std::vector<int> topTets, bottomTets;
 	topTets.assign(_bedRays.size(), -1);
 	bottomTets.assign(_bedRays.size(), -1);
@@ -157,33 +163,30 @@ void tetCollisions::findSoftCollisionPairs() {
 				//	for (int n = _bedRays.size(), j = 0; j < n; ++j) {  // serial version
 				float nearT = FLT_MAX;
 				vertexRay& b = _bedRays[j];
-				boundingBox<float> bedBox;
-				bedBox.Empty_Box();
-				bedBox.Enlarge_To_Include_Point(b.P.xyz);
-				bedBox.Enlarge_To_Include_Point((b.P - b.N).xyz);  // normal negated for bed rays
+				boxTree::box bedBox;
+				bedBox.set(b.P);
+				bedBox.enlarge(b.P - b.N);  // normal negated for bed rays
 				int nearV = -1;
-				for (size_t n = _flapBotTris.size(), i = 0; i < n; ++i) {
-					if (bedBox.Intersection(flapBox[i])) {
-						Vec3f tri[3];
-						int* tr = _mt->triangleVertices(_flapBotTris[i]);
-						for (int k = 0; k < 3; ++k)
-							_mt->getVertexCoordinate(tr[k], tri[k].xyz);
-						Mat3x3f C(tri[1] - tri[0], tri[2] - tri[0], b.N);
-						Vec3f R = C.Robust_Solve_Linear_System(b.P - tri[0]);
-						if (R[0] < 1e-6f || R[1] < 1e-6f || R[2] < 1e-4f || R[0] + R[1] > 1.0f || R[0] > 1.0f || R[1] > 1.0f || R[2] > 1.0f)  // R[2] determines how deep the collision must go before processing triggered. Bigger makes less sticky.
-							continue;
-						if (nearT > R[2]) {
-							nearT = R[2];
-							if (R[0] + R[1] < 0.66667f)
-								nearV = tr[0];
-							else if (R[0] > R[1])
-								nearV = tr[1];
-							else
-								nearV = tr[2];
-							collisionsFound = true;
-						}
+				_flapTree.query([&](const boxTree::box& fb) { return bedBox.overlaps(fb); }, [&](const int i) {
+					Vec3f tri[3];
+					int* tr = _mt->triangleVertices(_flapBotTris[i]);
+					for (int k = 0; k < 3; ++k)
+						_mt->getVertexCoordinate(tr[k], tri[k].xyz);
+					Mat3x3f C(tri[1] - tri[0], tri[2] - tri[0], b.N);
+					Vec3f R = C.Robust_Solve_Linear_System(b.P - tri[0]);
+					if (R[0] < 1e-6f || R[1] < 1e-6f || R[2] < 1e-4f || R[0] + R[1] > 1.0f || R[0] > 1.0f || R[1] > 1.0f || R[2] > 1.0f)  // R[2] determines how deep the collision must go before processing triggered. Bigger makes less sticky.
+						return;
+					if (nearT > R[2]) {
+						nearT = R[2];
+						if (R[0] + R[1] < 0.66667f)
+							nearV = tr[0];
+						else if (R[0] > R[1])
+							nearV = tr[1];
+						else
+							nearV = tr[2];
+						collisionsFound = true;
 					}
-				}
+				});
 				if (nearV < 0)
 					continue;
 				// found soft-soft collision pair
@@ -233,7 +236,6 @@ void tetCollisions::findSoftCollisionPairs() {
 	_ptp->currentSoftCollisionPairs(topTets, topBarys, bottomTets, bottomBarys, collisionNormals);
 }
 
-
 float tetCollisions::inverse_rsqrt(float number)
 {  // usual Quake cheat
 	const float threehalfs = 1.5F;
@@ -259,8 +261,6 @@ void tetCollisions::addFixedCollisionSet(const std::string& levelSetFile, std::v
 void tetCollisions::updateFixedCollisions(materialTriangles *mt, vnBccTetrahedra *vnt) {  // call after every topo change
 	_mt = mt;
 	_vnt = vnt;
-	// TEMPORARY: Disable fixed collision on macOS to avoid Pardiso dependency
-	#ifndef __APPLE__
 	for (auto& fc : _fixedCollisionSets) {
 		std::vector<int> tets;
 		std::vector<std::array<float, 3> > weights;
@@ -277,7 +277,6 @@ void tetCollisions::updateFixedCollisions(materialTriangles *mt, vnBccTetrahedra
 		}
 		_ptp->addFixedCollisionSet(fc.levelSetFilename, tets, weights);
 	}
-	#endif
 }
 
 float tetCollisions::rayDepth(const Vec3f &vtx, const Vec3f &nrm) {  // depth of a ray from vertex to nearest deep surface
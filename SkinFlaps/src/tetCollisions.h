@@ -6,6 +6,7 @@
 #include "Vec2f.h"
 #include "Vec3f.h"
 #include "Mat3x3f.h"
+#include "boxTree.h"
 
 // forward declarations
 class materialTriangles;
@@ -42,6 +43,7 @@ private:
 	};
 	std::vector<vertexRay> _bedRays;
 	std::vector<int> _flapBotTris;
+	boxTree _flapTree;  // over _flapBotTris, which it reorders.  Built after every topo change and refit every physics iteration.
 
 	struct fixedCollisionSet {
 		std::string levelSetFilename;
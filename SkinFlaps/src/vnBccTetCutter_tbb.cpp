@@ -73,8 +73,13 @@ void vnBccTetCutter_tbb::addNewMultiresIncision() {
 			_megatetTetTris.erase(mtit);
 		}
 	};
-	for (auto& ct : _centTris) {
-		auto tc = ct.first;
+	std::vector<bccTetCentroid> incisCentroids;
+	incisCentroids.reserve(_centTris.size());
+	for (auto& ct : _centTris)
+		incisCentroids.push_back(ct.first);
+	if (_deterministic)
+		tbb::parallel_sort(incisCentroids.begin(), incisCentroids.end(), [](const bccTetCentroid& a, const bccTetCentroid& b) { return centroidHashKey::pack(a) < centroidHashKey::pack(b); });
+	for (auto tc : incisCentroids) {
 		for (int j = 1; j < _vbt->_tetSubdivisionLevels; ++j)
 			tc = _vbt->centroidUpOneLevel(tc);
 		if(incisMegaCentroids.insert(tc).second)
@@ -124,6 +129,7 @@ void vnBccTetCutter_tbb::addNewMultiresIncision() {
 
 	_surfaceCentroids.clear();
 	_surfaceTetTris.clear();
+	// Every microtet and micronode is discarded and recut below, so tet and node indices past the megatets change with each incision.
 	_vbt->_tetNodes.erase(_vbt->_tetNodes.begin() + _vbt->_nMegatets, _vbt->_tetNodes.end());
 	_vbt->_tetCentroids.erase(_vbt->_tetCentroids.begin() + _vbt->_nMegatets, _vbt->_tetCentroids.end());
 	_vbt->_nodeGridLoci.erase(_vbt->_nodeGridLoci.begin() + _meganodeSize, _vbt->_nodeGridLoci.end());
@@ -136,10 +142,7 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 	pack();  // removes all tets and nodes marked for deletion leaving only megatets
 	_vbt->_nMegatets = _vbt->_tetNodes.size();  // reduced after pack
 	_meganodeSize = _vbt->_nodeGridLoci.size();
-	_vbt->_tetHash.clear();
-	_vbt->_tetHash.reserve(_vbt->_nMegatets * 1.5);
-	for (int n = _vbt->_tetCentroids.size(), i = 0; i < n; ++i)
-		_vbt->_tetHash.insert(std::make_pair(_vbt->_tetCentroids[i], i));  // at this time only hash unique megatets
+	_vbt->_tetHash.assign(_vbt->_tetCentroids);  // at this time only hash unique megatets
 	// get unique tet faces at the boundary of object and of the virtual noded tets that were removed in contact with tets that remain.
 	_megatetBounds.clear();
 	_megatetBounds.reserve(_vnCentroids.size() << 2);  // COURT check rough guess later
@@ -175,7 +178,7 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 		}
 	}
 	_boundingNodeData.clear();
-	_boundingNodeData.reserve(bnTris.size() * 1.1f);
+	_boundingNodeData.reserve(bnTris.size());
 	for (auto& bnt : bnTris) {
 		auto pr = _boundingNodeData.insert(std::make_pair(_vbt->_nodeGridLoci[bnt.first], boundingNodeTris()));
 		pr.first->second.node = bnt.first;
@@ -198,37 +201,56 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 	// build microtets in deleted solid
 	// now need all interior nodes inside the recut volume.  Unfortunately bounding tris of that recut volume may be partially empty.
 	// So must get all interior nodes from entire volume and keep only those inside the recut volume.
-	for (auto& vnc : _vnCentroids)
+	int recutXy[4] = { INT_MAX, INT_MIN, INT_MAX, INT_MIN };  // XY grid bounds of the recut volume
+	for (auto& vnc : _vnCentroids) {
 		addCentroidMicronodesZ(vnc);
+		short gl[4][3];
+		_vbt->centroidToNodeLoci(vnc, gl);
+		for (int j = 0; j < 4; ++j) {
+			recutXy[0] = std::min(recutXy[0], (int)gl[j][0]);
+			recutXy[1] = std::max(recutXy[1], (int)gl[j][0]);
+			recutXy[2] = std::min(recutXy[2], (int)gl[j][1]);
+			recutXy[3] = std::max(recutXy[3], (int)gl[j][1]);
+		}
+	}
+	// Only Z lines holding candidate micronodes of the recut volume need surface intersects, so triangles outside its XY bounds are skipped
+	// and hits on lines without candidates dropped.  This keeps the pass proportional to the recut volume rather than the whole model.
 	_zIntr.clear();
-	// COURT time this to see if multithreading worth it.
-	for (int n = _mt->numberOfTriangles(), i = 0; i < n; ++i) {
+	auto zIntersectRecutTriangle = [&](size_t i) {
 		if (_mt->triangleMaterial(i) < 0)
-			continue;
+			return;
 		Vec3d triVec[3];
 		int* tr = _mt->triangleVertices(i);
-		for (int i = 0; i < 3; ++i)
-			triVec[i] = _vMatCoords[tr[i]];
+		for (int j = 0; j < 3; ++j)
+			triVec[j] = _vMatCoords[tr[j]];
+		for (int k = 0; k < 2; ++k) {
+			double tMin = std::min(std::min(triVec[0][k], triVec[1][k]), triVec[2][k]), tMax = std::max(std::max(triVec[0][k], triVec[1][k]), triVec[2][k]);
+			if (tMax < recutXy[k << 1] || tMin > recutXy[(k << 1) + 1])
+				return;
+		}
 		zIntersectTriangleTbb(triVec, true, _zIntr);
-	}
+	};
+#if defined( _DEBUG )
+	for (size_t i = 0; i < _mt->numberOfTriangles(); ++i)
+		zIntersectRecutTriangle(i);
+#else
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>(0, _mt->numberOfTriangles()),
+		[&](tbb::blocked_range<size_t> r) {
+			for (size_t i = r.begin(); i != r.end(); ++i)
+				zIntersectRecutTriangle(i);
+		});
+#endif
+	if (_deterministic)
+		sortZIntersects();
 	for (auto ziv : _zIntr) {
-		if (ziv.flags.odd)
-			oddXy[ziv.x][ziv.y].insert(std::make_pair(ziv.zInt, ziv.flags));
-		else
-			evenXy[ziv.x][ziv.y].insert(std::make_pair(ziv.zInt, ziv.flags));
+		auto& zLine = ziv.flags.odd ? oddXy[ziv.x][ziv.y] : evenXy[ziv.x][ziv.y];
+		if (!zLine.empty())  // a line with no candidate micronodes can't create interior nodes
+			zLine.insert(std::make_pair(ziv.zInt, ziv.flags));
 	}
 	_zIntr.clear();
 	std::vector<tetTriangles> tetTriVec;
-	tetTriVec.reserve(_centTris.size());
-	_surfaceCentroids.clear();
-	_surfaceCentroids.reserve(_centTris.size());
-	for (auto ctit = _centTris.begin(); ctit != _centTris.end(); ++ctit) {
-		_surfaceCentroids.insert(std::make_pair(ctit->first, std::vector<int>()));
-		tetTriVec.push_back(tetTriangles());
-		tetTriVec.back().tc = ctit->first;
-		tetTriVec.back().tris = std::move(ctit->second);
-	}
-	_centTris.clear();
+	collectCentroidTriangles(tetTriVec);
 	_interiorNodes.clear();
 	createInteriorMicronodes();
 	// Some of the _tetTris may be invalid if they are outside the recut volume.
@@ -239,7 +261,8 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 		if (_megatetTetTris.find(tc) != _megatetTetTris.end())
 			tetTriVec[i].tc[0] = USHRT_MAX;
 	}
-	_nSurfaceTets.store(_vbt->_tetNodes.size());  // this atomic must not step on any megatets that have already been created. Atomic used to multithread next section
+	int firstSurfaceTet = _vbt->_tetNodes.size();
+	_nSurfaceTets.store(firstSurfaceTet);  // this atomic must not step on any megatets that have already been created. Atomic used to multithread next section
 	_newTets.clear();
 	_ntsHash.clear();
 #if defined( _DEBUG )
@@ -260,6 +283,9 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 		});
 #endif
 	tetTriVec.clear();
+	std::vector<int> newTetIndex;
+	if (_deterministic)
+		sortNewTets(firstSurfaceTet, newTetIndex);
 
 	// vbt->_tetCentroids has the megatets remaining
 	int incr = _nSurfaceTets - _vbt->_tetCentroids.size();
@@ -278,10 +304,6 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 	}
 	_newTets.clear();
 	// _centroidTriangles will be used later for vertex tetId and multires version, so don't delete
-	struct extNodeLoc {
-		std::array<short, 3> loc;
-		std::list<nodeTetSegment> tetNodes;
-	};
 	std::vector<extNodeLoc> extNodeLocs;
 	extNodeLocs.reserve(_ntsHash.size());
 	for (auto& ns : _ntsHash) {
@@ -291,6 +313,8 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 		extNodeLocs.push_back(enl);
 	}
 	_ntsHash.clear();
+	if (_deterministic)
+		sortExteriorNodeLocs(extNodeLocs, firstSurfaceTet, newTetIndex);
 
 	_firstNewExteriorNode = _vbt->_nodeGridLoci.size();
 	oneapi::tbb::concurrent_vector<extNode> eNodes;
@@ -305,6 +329,8 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 				assignExteriorTetNodes(extNodeLocs[i].loc, extNodeLocs[i].tetNodes, eNodes);
 		});
 #endif
+	if (_deterministic)
+		sortExteriorNodes(eNodes);
 	for (auto& en : eNodes) {
 		int eNode = _vbt->_nodeGridLoci.size();
 		_vbt->_nodeGridLoci.push_back(std::move(en.loc));
@@ -317,10 +343,7 @@ void vnBccTetCutter_tbb::macrotetRecutCore() {
 	fillInteriorMicroTets(_vnCentroids);
 	// wed seams between macrotets and recut microtet regions with T junctions
 	linkMicrotetsToMegatets();
-	_vbt->_tetHash.clear();
-	_vbt->_tetHash.reserve(_vbt->_tetNodes.size());
-	for (int n = _vbt->_tetNodes.size(), i = 0; i < n; ++i)  // firstInteriorTet
-		_vbt->_tetHash.insert(std::make_pair(_vbt->_tetCentroids[i], i));
+	_vbt->_tetHash.assign(_vbt->_tetCentroids);
 	// now reconnect stranded vertices to their new barycentric tet loci
 	for (int n = _vbt->_vertexTets.size(), v = 0; v < n; ++v) {
 		// _vertexTetCentroids[v] already converted to lowest microtet centroid values
@@ -549,16 +572,9 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 		});
 #endif
 	std::vector<tetTriangles> tetTriVec;
-	tetTriVec.assign(_centTris.size(), tetTriangles());
-	_surfaceCentroids.clear();
-	_surfaceCentroids.reserve(_centTris.size());
-	int count = 0;
-	for (auto ctit = _centTris.begin(); ctit != _centTris.end(); ++ctit) {
-		_surfaceCentroids.insert(std::make_pair(ctit->first, std::vector<int>()));
-		tetTriVec[count].tc = ctit->first;
-		tetTriVec[count++].tris = std::move(ctit->second);
-	}
-	_centTris.clear();
+	collectCentroidTriangles(tetTriVec);
+	if (_deterministic)
+		sortZIntersects();
 	for (auto ziv : _zIntr) {
 		if (ziv.flags.odd)
 			oddXy[ziv.x][ziv.y].insert(std::make_pair(ziv.zInt, ziv.flags));
@@ -587,6 +603,9 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 				getConnectedComponents(tetTriVec[i], _newTets, _ntsHash);  // for this centroid split its triangles into solid connected components
 		});
 #endif
+	std::vector<int> newTetIndex;
+	if (_deterministic)
+		sortNewTets(0, newTetIndex);
 
 	_vbt->_tetCentroids.assign(_nSurfaceTets, bccTetCentroid());
 	_vbt->_tetNodes.assign(_nSurfaceTets, std::array<int, 4>());
@@ -602,10 +621,6 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 	}
 	_newTets.clear();
 	// _centroidTriangles will be used later for vertex tetId and multires version, so don't delete
-	struct extNodeLoc {
-		std::array<short, 3> loc;
-		std::list<nodeTetSegment> tetNodes;
-	};
 	std::vector<extNodeLoc> extNodeLocs;
 	extNodeLocs.reserve(_ntsHash.size());
 	for (auto& ns : _ntsHash) {
@@ -615,6 +630,8 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 		extNodeLocs.push_back(enl);
 	}
 	_ntsHash.clear();
+	if (_deterministic)
+		sortExteriorNodeLocs(extNodeLocs, 0, newTetIndex);
 	// get tets where vertices reside
 	_vbt->_vertexTets.clear();
 	_vbt->_vertexTets.assign(_mt->numberOfVertices(), -1);
@@ -658,6 +675,8 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 				assignExteriorTetNodes(extNodeLocs[i].loc, extNodeLocs[i].tetNodes, eNodes);
 		});
 #endif
+	if (_deterministic)
+		sortExteriorNodes(eNodes);
 
 	for (auto& en : eNodes) {
 		int eNode = _vbt->_nodeGridLoci.size();
@@ -672,13 +691,85 @@ bool vnBccTetCutter_tbb::makeFirstVnTets(materialTriangles* mt, vnBccTetrahedra*
 	_interiorNodes.clear();  // COURT perhaps keep this and delete vn tet interiors
 	_vbt->_tetNodes.shrink_to_fit();
 	_vbt->_tetCentroids.shrink_to_fit();
-	_vbt->_tetHash.clear();
-	_vbt->_tetHash.reserve(_vbt->_tetCentroids.size());
-	for (int n = _vbt->_tetCentroids.size(), i = 0; i < n; ++i)
-		_vbt->_tetHash.insert(std::make_pair(_vbt->_tetCentroids[i], i));
+	_vbt->_tetHash.assign(_vbt->_tetCentroids);
 	return true;
 }
 
+void vnBccTetCutter_tbb::collectCentroidTriangles(std::vector<tetTriangles>& tetTriVec) {
+	tetTriVec.clear();
+	tetTriVec.reserve(_centTris.size());
+	for (auto ctit = _centTris.begin(); ctit != _centTris.end(); ++ctit) {
+		tetTriVec.push_back(tetTriangles());
+		tetTriVec.back().tc = ctit->first;
+		tetTriVec.back().tris = std::move(ctit->second);
+	}
+	_centTris.clear();
+	if (_deterministic) {  // table order and the order of each centroid's triangles depend on the order threads inserted
+		tbb::parallel_sort(tetTriVec.begin(), tetTriVec.end(), [](const tetTriangles& a, const tetTriangles& b) { return centroidHashKey::pack(a.tc) < centroidHashKey::pack(b.tc); });
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, tetTriVec.size()), [&](tbb::blocked_range<size_t> r) {
+			for (size_t i = r.begin(); i != r.end(); ++i)
+				std::sort(tetTriVec[i].tris.begin(), tetTriVec[i].tris.end());
+			});
+	}
+	_surfaceCentroids.clear();
+	_surfaceCentroids.reserve(tetTriVec.size());
+	for (auto& tt : tetTriVec)
+		_surfaceCentroids.insert(std::make_pair(tt.tc, std::vector<int>()));
+}
+
+void vnBccTetCutter_tbb::sortZIntersects() {
+	// coincident hits enter a Z line multimap in _zIntr order
+	tbb::parallel_sort(_zIntr.begin(), _zIntr.end(), [](const zIntrsct& a, const zIntrsct& b) {
+		if (a.flags.odd != b.flags.odd)
+			return a.flags.odd < b.flags.odd;
+		if (a.x != b.x)
+			return a.x < b.x;
+		if (a.y != b.y)
+			return a.y < b.y;
+		if (a.zInt != b.zInt)
+			return a.zInt < b.zInt;
+		if (a.flags.solidBegin != b.flags.solidBegin)
+			return a.flags.solidBegin < b.flags.solidBegin;
+		return a.flags.macroNode < b.flags.macroNode;
+	});
+}
+
+void vnBccTetCutter_tbb::sortNewTets(const int firstTet, std::vector<int>& newTetIndex) {
+	// _newTets drew their indices from _nSurfaceTets in thread order.  Renumber them in centroid order.  The tets of one centroid were
+	// numbered in increasing order by a single getConnectedComponents() call, so they keep that order.
+	tbb::parallel_sort(_newTets.begin(), _newTets.end(), [](const newTet& a, const newTet& b) {
+		uint64_t ka = centroidHashKey::pack(a.tc), kb = centroidHashKey::pack(b.tc);
+		return ka < kb || (ka == kb && a.tetIdx < b.tetIdx);
+	});
+	newTetIndex.assign(_newTets.size(), -1);
+	for (int n = _newTets.size(), i = 0; i < n; ++i) {
+		newTetIndex[_newTets[i].tetIdx - firstTet] = firstTet + i;
+		_newTets[i].tetIdx = firstTet + i;
+	}
+}
+
+void vnBccTetCutter_tbb::sortExteriorNodeLocs(std::vector<extNodeLoc>& extNodeLocs, const int firstTet, const std::vector<int>& newTetIndex) {
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>(0, extNodeLocs.size()),
+		[&](tbb::blocked_range<size_t> r) {
+			for (size_t i = r.begin(); i != r.end(); ++i) {
+				auto& tetNodes = extNodeLocs[i].tetNodes;
+				for (auto& nts : tetNodes)
+					nts.tetIdx = newTetIndex[nts.tetIdx - firstTet];
+				tetNodes.sort([](const nodeTetSegment& a, const nodeTetSegment& b) { return a.tetIdx < b.tetIdx; });  // a tet has only one node at a locus
+			}
+		});
+	tbb::parallel_sort(extNodeLocs.begin(), extNodeLocs.end(), [](const extNodeLoc& a, const extNodeLoc& b) { return centroidHashKey::pack(a.loc) < centroidHashKey::pack(b.loc); });
+}
+
+void vnBccTetCutter_tbb::sortExteriorNodes(oneapi::tbb::concurrent_vector<extNode>& eNodes) {
+	// the tets sharing a virtual node at a locus are disjoint from those of any other node there
+	tbb::parallel_sort(eNodes.begin(), eNodes.end(), [](const extNode& a, const extNode& b) {
+		uint64_t ka = centroidHashKey::pack(a.loc), kb = centroidHashKey::pack(b.loc);
+		return ka < kb || (ka == kb && a.tiPairs.front().first < b.tiPairs.front().first);
+	});
+}
+
 void vnBccTetCutter_tbb::pack(){
 	int tnNow = 0;
 	std::vector<int> tnArr;
@@ -800,6 +891,32 @@ void vnBccTetCutter_tbb::linkMicrotetsToMegatets(){
 		t.M.x[2] = t.M.x[1];
 		bt.push_back(std::move(t));
 	}
+	// Bin the bounding triangles on a grid the size of the largest one so a node only tests the few triangles near it.  Bins list their
+	// triangles in ascending order, so the first hit is the same one a search of all of bt would find.
+	float binSize = 1.0f;
+	for (auto& b : bt) {
+		for (int j = 0; j < 3; ++j)
+			binSize = std::max(binSize, std::max(std::fabs(b.tv[1][j]), std::max(std::fabs(b.tv[2][j]), std::fabs(b.tv[2][j] - b.tv[1][j]))));
+	}
+	float binSizeInv = 1.0f / binSize;
+	flatCentroidMap<std::array<short, 3>, std::vector<int> > triBins;
+	triBins.reserve(bt.size() * 2);
+	for (int n = bt.size(), i = 0; i < n; ++i) {
+		auto& b = bt[i];
+		int binMin[3], binMax[3];
+		for (int j = 0; j < 3; ++j) {
+			float tMin = b.tv[0][j] + std::min(0.0f, std::min(b.tv[1][j], b.tv[2][j])), tMax = b.tv[0][j] + std::max(0.0f, std::max(b.tv[1][j], b.tv[2][j]));
+			binMin[j] = (int)std::floor((tMin - 1e-3f) * binSizeInv);
+			binMax[j] = (int)std::floor((tMax + 1e-3f) * binSizeInv);
+		}
+		std::array<short, 3> bin;
+		for (bin[0] = binMin[0]; bin[0] <= binMax[0]; ++bin[0]) {
+			for (bin[1] = binMin[1]; bin[1] <= binMax[1]; ++bin[1]) {
+				for (bin[2] = binMin[2]; bin[2] <= binMax[2]; ++bin[2])
+					triBins[bin].push_back(i);
+			}
+		}
+	}
 	auto addTJunction = [&](const int node, int& tri, Vec2f& bary) {
 		auto dnc = _vbt->_tJunctionConstraints.insert(std::make_pair(node, vnBccTetrahedra::decimatedFaceNode()));
 		if (dnc.second) {
@@ -834,7 +951,14 @@ void vnBccTetCutter_tbb::linkMicrotetsToMegatets(){
 	};
 	auto isTjunct = [&](const int node, int& tri, Vec2f& bary, std::vector<int>* triTest) ->bool {
 		Vec3f P = (short(&)[3]) * _vbt->_nodeGridLoci[node].data();
-		for (tri = 0; tri < bt.size(); ++tri) {
+		std::array<short, 3> bin;
+		for (int j = 0; j < 3; ++j)
+			bin[j] = (short)std::floor(P[j] * binSizeInv);
+		auto tbit = triBins.find(bin);
+		if (tbit == triBins.end())
+			return false;
+		for (int binTri : tbit->second) {
+			tri = binTri;
 			auto& b = bt[tri];
 			if (fabs(P * b.N - b.d) < 1e-8f) {
 				Vec3f V = P - b.tv[0];
@@ -1797,7 +1921,7 @@ void vnBccTetCutter_tbb::getConnectedComponents(const tetTriangles& tt, oneapi::
 			if (p.tetNodes[i] < 0) {
 				if (enNotEntered) {
 					std::array<short, 3> loc = { gl[i][0], gl[i][1], gl[i][2] };
-					local_nts.insert(acc, std::make_pair(loc, std::list<nodeTetSegment>()));
+					local_nts.insert(acc, loc);
 					enNotEntered = false;
 				}
 				nodeTetSegment nts;
@@ -2078,9 +2202,8 @@ void vnBccTetCutter_tbb::inputTriangleTetsTbb(const int& surfaceTriangle, CENTtr
 	}
 	for (auto& tt : triTetsS) {
 		CENTtris::accessor acc;
-		bool result = centTris.insert(acc, std::make_pair(tt, std::vector<int>({ surfaceTriangle })));
-		if(!result)
-			acc->second.push_back(surfaceTriangle);
+		centTris.insert(acc, tt);
+		acc->second.push_back(surfaceTriangle);
 	}
 }
 
@@ -12,10 +12,10 @@
 #include <unordered_set>
 #include <algorithm>
 
-#include "oneapi/tbb/concurrent_hash_map.h"
 #include "oneapi/tbb/concurrent_vector.h"
 #include "oneapi/tbb/blocked_range.h"
 #include "oneapi/tbb/parallel_for.h"
+#include "oneapi/tbb/parallel_sort.h"
 
 // #include <atomic>
 #include "materialTriangles.h"
@@ -30,13 +30,18 @@ public:
 	void createFirstMacroTets(materialTriangles* mt, vnBccTetrahedra* vbt, const int nLevels, const int maximumDimensionMacroSubdivs);  // creates initial macro tet environment
 	void addNewMultiresIncision();  // after have done createFirstMacroTets() and possibly made other incisions, this routine inputs new incision(s) and creates new tet structure.
 	inline void setRemapTetPhysics(remapTetPhysics* rtp) { _rtp = rtp; }  // for use in surgical simulation project to reset spatial coords after a topo change.  Can be ignored elsewhere if desired.
-	vnBccTetCutter_tbb(void) { _rtp = nullptr; }
+	// Multithreaded cutting numbers surface tets and exterior nodes in thread order, so indices differ run to run.  Deterministic numbering
+	// sorts them by centroid and grid locus after each parallel phase so the same input always produces the same lattice.
+	inline void setDeterministicNumbering(const bool deterministic) { _deterministic = deterministic; }
+	inline bool deterministicNumbering() const { return _deterministic; }
+	vnBccTetCutter_tbb(void) { _rtp = nullptr; _deterministic = false; }
 	~vnBccTetCutter_tbb(void){}
 
 private:
 	materialTriangles* _mt;
 	vnBccTetrahedra* _vbt;
 	remapTetPhysics* _rtp;
+	bool _deterministic;
 	std::vector<Vec3f> _vMatCoords;  // material coordinates of surface vertices
 
 	std::unordered_set<int> _vnTris;
@@ -46,14 +51,9 @@ private:
 		std::array<unsigned short, 3> tc;
 		unsigned short pad;
 	};
-	struct signed3 {
-		std::array<short, 3> ss3;
-		short pad;
-	};
 	union btHash {
 		uint64_t ll;
 		unsigned3 us3;
-		signed3 ss3;
 	};
 	struct bccTetCentroidHasher {
 		std::size_t operator()(const std::array<unsigned short, 3>& k) const
@@ -65,18 +65,8 @@ private:
 			return hash_funct(bh.ll);
 		}
 	};
-	struct arrayShort3Hasher {
-		std::size_t operator()(const std::array<short, 3>& k) const
-		{  // hash function
-			btHash bh;
-			bh.ss3.ss3 = k;
-			bh.ss3.pad = 0;
-			std::hash<long long> hash_funct;
-			return hash_funct(bh.ll);
-		}
-	};
-	std::unordered_map<std::array<short, 3>, int, arrayShort3Hasher> _interiorNodes;
-	std::unordered_map<bccTetCentroid, std::vector<int>, bccTetCentroidHasher> _surfaceCentroids;
+	flatCentroidMap<std::array<short, 3>, int> _interiorNodes;
+	flatCentroidMap<bccTetCentroid, std::vector<int> > _surfaceCentroids;
 	std::atomic<int> _nSurfaceTets;
 	int _meganodeSize;  // size of largest macro nodes at beginning of node arrays. _megatetSize size of the largest macrotets at the beginning of the tet arrays is now kept in _vbt.
 	int _firstNewExteriorNode;  // Index of first new exterior micronode to be created. This is _meganodeSize plus size of new interior micronodes.
@@ -86,15 +76,17 @@ private:
 	};
 	std::vector<tetTris> _surfaceTetTris;  // COURT could be expanded to handle megatet tris as well.
 	// COURT with new data structure is next variable necessary since is filled with empty tris as well.  Could add above variable to pack().
-	std::unordered_map<bccTetCentroid, tetTris, bccTetCentroidHasher> _megatetTetTris;  // megatets don't virtual node and may or may not have triangles passing through them.
-	typedef std::unordered_map<bccTetCentroid, tetTris, bccTetCentroidHasher>::const_iterator MTTIT;
+	// megatets don't virtual node and may or may not have triangles passing through them.  _boundingNodeData and _megatetBounds point into this
+	// table, which stays valid as erase() leaves its entries in place, but not across inserts that may grow it.
+	flatCentroidMap<bccTetCentroid, tetTris> _megatetTetTris;
+	typedef flatCentroidMap<bccTetCentroid, tetTris>::const_iterator MTTIT;
 
 	std::vector<bccTetCentroid> _vertexTetCentroids;
 	struct boundingNodeTris {
 		int node;
 		std::vector<tetTris*> megaTetTris;  // each is guaranteed to be a sorted vector
 	};
-	std::unordered_map<std::array<short, 3>, boundingNodeTris, arrayShort3Hasher> _boundingNodeData;
+	flatCentroidMap<std::array<short, 3>, boundingNodeTris> _boundingNodeData;
 	struct megatetFace {
 		std::array<int, 3> nodes;
 		std::vector<int> *tris;  // must be sorted
@@ -134,37 +126,11 @@ private:
 		std::vector<std::pair<int, int> > tiPairs;  // first is tetrahedron number, second is its node index 0-3
 	};
 
-	struct ss3HashCompare {
-		static size_t hash(const std::array<short, 3>& ss3) {
-			btHash bh;
-			bh.ss3.ss3 = ss3;
-			bh.ss3.pad = 0;
-			std::hash<long long> hash_funct;
-			return hash_funct(bh.ll);
-		}
-		//! True if strings are equal
-		static bool equal(const std::array<short, 3>& x, const std::array<short, 3>& y) {
-			return x == y;
-		}
-	};
-	struct btcHashCompare {
-		static size_t hash(const bccTetCentroid& tc) {
-			btHash bh;
-			bh.us3.tc = tc;
-			bh.us3.pad = 0;
-			std::hash<long long> hash_funct;
-			return hash_funct(bh.ll);
-		}
-		//! True if strings are equal
-		static bool equal(const bccTetCentroid& x, const bccTetCentroid& y) {
-			return x == y;
-		}
-	};
 	struct tetTriangles {
 		bccTetCentroid tc;
 		std::vector<int> tris;
 	};
-	typedef oneapi::tbb::concurrent_hash_map<bccTetCentroid, std::vector<int>, btcHashCompare> CENTtris;
+	typedef concurrentCentroidMap<bccTetCentroid, std::vector<int> > CENTtris;
 	CENTtris _centTris;
 	oneapi::tbb::concurrent_vector<zIntrsct> _zIntr;
 	struct nodeTetSegment {
@@ -172,8 +138,12 @@ private:
 		int tetIdx;
 		int tetNodeIndex;
 	};
-	typedef oneapi::tbb::concurrent_hash_map<std::array<short, 3>, std::list<nodeTetSegment>, ss3HashCompare> NTS_HASH;
+	typedef concurrentCentroidMap<std::array<short, 3>, std::list<nodeTetSegment> > NTS_HASH;
 	NTS_HASH _ntsHash;
+	struct extNodeLoc {
+		std::array<short, 3> loc;
+		std::list<nodeTetSegment> tetNodes;
+	};
 
 	inline bool sortedVectorsIntersect(const std::vector<int>& v0, const std::vector<int>& v1) {
 		auto i0 = v0.begin();
@@ -221,6 +191,12 @@ private:
 	void addCentroidMicronodesZ(const bccTetCentroid& tc);
 	void linkMicrotetsToMegatets();
 	void pack();
+	// deterministic numbering
+	void collectCentroidTriangles(std::vector<tetTriangles>& tetTriVec);  // empties _centTris into tetTriVec and _surfaceCentroids
+	void sortZIntersects();
+	void sortNewTets(const int firstTet, std::vector<int>& newTetIndex);
+	void sortExteriorNodeLocs(std::vector<extNodeLoc>& extNodeLocs, const int firstTet, const std::vector<int>& newTetIndex);
+	void sortExteriorNodes(oneapi::tbb::concurrent_vector<extNode>& eNodes);
 
 };
 #endif	// #ifndef _VN_BCC_TET_CUTTER_TBB_
@@ -39,6 +39,8 @@ void vnBccTetrahedra::clear()
 	_tetHash.clear();
 	_vertexTets.clear();
 	_barycentricWeights.clear();
+	_spatialBvh.clear();
+	_spatialBvhState = SPATIAL_BVH_INVALID;
 }
 
 void vnBccTetrahedra::centroidToNodeLoci(const bccTetCentroid& centroid, short (&gridLoci)[4][3]) {
@@ -681,6 +683,28 @@ void vnBccTetrahedra::materialCoordsToNodeSpatialVector()
 		vp *= (float)_unitSpacing;
 		vp += _minCorner;
 	}
+	spatialCoordinatesMoved();
+}
+
+void vnBccTetrahedra::updateSpatialBvh()
+{  // physics thread may mark a move while this runs. Then the next query refits again.
+	int state = _spatialBvhState.exchange(SPATIAL_BVH_CURRENT);
+	if (state == SPATIAL_BVH_INVALID)
+		_spatialBvh.build(_tetNodes, getNodeSpatialCoordPointer(), _nMegatets, _firstInteriorTet);
+	else if (state == SPATIAL_BVH_MOVED)
+		_spatialBvh.refit(_tetNodes, getNodeSpatialCoordPointer());
+}
+
+int vnBccTetrahedra::spatialTet(const Vec3f& position, Vec3f& barycentricWeight)
+{
+	updateSpatialBvh();
+	return _spatialBvh.locate(_tetNodes, _nodeSpatialCoords, position, barycentricWeight);
+}
+
+void vnBccTetrahedra::spatialTets(const std::vector<Vec3f>& positions, std::vector<int>& tets, std::vector<Vec3f>& barycentricWeights)
+{
+	updateSpatialBvh();
+	_spatialBvh.locate(_tetNodes, _nodeSpatialCoords, positions, tets, barycentricWeights);
 }
 
 bool vnBccTetrahedra::insideTet(const bccTetCentroid& tc, const Vec3f& gridLocus) {
@@ -1023,7 +1047,7 @@ const bccTetCentroid vnBccTetrahedra::centroidUpOneLevel(const bccTetCentroid& t
 	return tcUp;
 }
 
-vnBccTetrahedra::vnBccTetrahedra() : _nodeSpatialCoords(nullptr), _firstInteriorTet(-1)
+vnBccTetrahedra::vnBccTetrahedra() : _nodeSpatialCoords(nullptr), _firstInteriorTet(-1), _nMegatets(0), _spatialBvhState(SPATIAL_BVH_INVALID)
 {
 	_tJunctionConstraints.clear();
 }
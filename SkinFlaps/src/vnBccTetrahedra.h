@@ -23,6 +23,8 @@
 #include <stdexcept>
 #include "Vec3f.h"
 #include "Mat3x3f.h"
+#include "spatialTetBvh.h"
+#include "flatCentroidHash.h"
 
 #pragma warning (disable : 4267)
 
@@ -97,6 +99,14 @@ public:
 			position += _nodeSpatialCoords[n[i]] * barycentricWeight[i - 1];
 	}
 
+	inline void getBarycentricTetPosition(const Vec3f* nodeSpatialCoords, const int tet, const Vec3f &barycentricWeight, Vec3f &position)
+	{  // same as above using a copy of the node spatial coordinates, such as the renderer's
+		const int *n = _tetNodes[tet].data();
+		position.set(nodeSpatialCoords[n[0]] * (1.0f - barycentricWeight.X - barycentricWeight.Y - barycentricWeight.Z));
+		for (int i = 1; i < 4; ++i)
+			position += nodeSpatialCoords[n[i]] * barycentricWeight[i - 1];
+	}
+
 	inline void vertexBarycentricPosition(const int vertex, Vec3f &position)
 	{
 		const int *n = _tetNodes[_vertexTets[vertex]].data();
@@ -106,8 +116,13 @@ public:
 			position += _nodeSpatialCoords[n[i]] * bw[i - 1];
 	}
 
-	void setNodeSpatialCoordinatePointer(std::array<float, 3> *spatialCoordPtr) { _nodeSpatialCoords = reinterpret_cast<Vec3f*>(spatialCoordPtr); }  // assumes vector of coords created elsewhere
-	void setNodeSpatialCoordinatePointer(Vec3f *spatialCoordPtr) { _nodeSpatialCoords = spatialCoordPtr; }  // assumes vector of coords created elsewhere
+	void setNodeSpatialCoordinatePointer(std::array<float, 3> *spatialCoordPtr) { _nodeSpatialCoords = reinterpret_cast<Vec3f*>(spatialCoordPtr); _spatialBvhState = SPATIAL_BVH_INVALID; }  // assumes vector of coords created elsewhere
+	void setNodeSpatialCoordinatePointer(Vec3f *spatialCoordPtr) { _nodeSpatialCoords = spatialCoordPtr; _spatialBvhState = SPATIAL_BVH_INVALID; }  // assumes vector of coords created elsewhere
+	// Spatial point location in the megatets and unique interior tets.  Returns the containing tet, megatets first, or -1 if none.
+	// Uses a bvh rebuilt on first use after a new lattice, and refit on first use after spatialCoordinatesMoved().
+	int spatialTet(const Vec3f& position, Vec3f& barycentricWeight);
+	void spatialTets(const std::vector<Vec3f>& positions, std::vector<int>& tets, std::vector<Vec3f>& barycentricWeights);  // multithreaded batch of above
+	inline void spatialCoordinatesMoved() { int current = SPATIAL_BVH_CURRENT; _spatialBvhState.compare_exchange_strong(current, SPATIAL_BVH_MOVED); }  // call after every physics step
 	const Vec3f* getNodeSpatialCoordPointer() { if (_nodeSpatialCoords == nullptr) throw(std::logic_error("Trying to access nodeSpatialCoordinate vector before it has been allocated and assigned")); return _nodeSpatialCoords; }
 	// next set of routines traverse topological paths through the bcc data
 	int edgeCircumCentroids(bccTetCentroid tc, int edge, bccTetCentroid(&circumCentroids)[6]);  // gets centroids of same size as tc surrounding edge. Edges listed as sequential pairs from nodes 0 to 3, then 0 to 2, then 1 to 3.
@@ -195,26 +210,8 @@ protected:
 	std::vector<std::array<int, 4> > _tetNodes;
 	std::vector<bccTetCentroid> _tetCentroids;
 
-	struct unsigned3 {
-		std::array<unsigned short, 3> tc;
-		unsigned short pad;
-	};
-	union btHash {
-		uint64_t ll;
-		unsigned3 us3;
-	};
-	struct bccTetCentroidHasher {
-		std::size_t operator()(const std::array<unsigned short, 3>& k) const
-		{  // hash function
-			btHash bh;
-			bh.us3.tc = k;
-			bh.us3.pad = 0;
-			std::hash<long long> hash_funct;
-			return hash_funct(bh.ll);
-		}
-	};
-	std::unordered_multimap<bccTetCentroid, int, bccTetCentroidHasher> _tetHash;  // bccTetCenter and index into _tetNodes
-	typedef std::unordered_multimap<bccTetCentroid, int, bccTetCentroidHasher>::iterator THIT;
+	flatCentroidMultimap<bccTetCentroid> _tetHash;  // bccTetCenter and index into _tetNodes.  Virtual noded duplicates of a centroid are contiguous.
+	typedef flatCentroidMultimap<bccTetCentroid>::const_iterator THIT;
 	materialTriangles *_mt;  // embedded surface
 	std::vector<int> _vertexTets;
 	std::vector<Vec3f> _barycentricWeights;
@@ -226,6 +223,10 @@ protected:
 	int _firstInteriorTet;  // first tet of all unique interior tets. Goes to end of list.
 	int _nMegatets;  // number of unique largest level megatets.  Guaranteed to go from 0 to this number in the tet vectors _tetNodes and _tetCentroids.
 	static Mat3x3f _barycentricInverses[6];
+	enum { SPATIAL_BVH_INVALID, SPATIAL_BVH_CURRENT, SPATIAL_BVH_MOVED };
+	std::atomic<int> _spatialBvhState;
+	spatialTetBvh _spatialBvh;
+	void updateSpatialBvh();
 	struct decimatedFaceNode {
 		std::vector<int> faceNodes;
 		std::vector<float> faceBarys;
@@ -15,6 +15,7 @@
 
 bool gl3wGraphics::mouseWheelZoom = true;
 float gl3wGraphics::mouseWheelLevel = 500.0f;
+bool gl3wGraphics::_nullGraphics = false;
 
 bool gl3wGraphics::addCustomSceneNode(std::shared_ptr<sceneNode>& sn, std::vector<int> &txIds, const GLchar *vertexShader, const GLchar *fragmentShader, std::vector<std::string> &attributes)
 {  // assumes textures loaded already and input in txIds
@@ -62,11 +63,13 @@ void gl3wGraphics::initializeGraphics()
 {
 	// initializing GL3 now done by GLFW
 	_shapes.setGl3wGraphics(this);
+	_tBall.computeQuat(_rotQuat,0.0f,0.0f,0.0f,0.0f);
+	if (_nullGraphics)
+		return;
 	// Background
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f );
 	glEnable(GL_DEPTH_TEST);
 	glDisable(GL_CULL_FACE);
-	_tBall.computeQuat(_rotQuat,0.0f,0.0f,0.0f,0.0f);
 }
 
 void gl3wGraphics::setViewport(unsigned short x, unsigned short y, unsigned short xSize, unsigned short ySize)
@@ -77,7 +80,8 @@ void gl3wGraphics::setViewport(unsigned short x, unsigned short y, unsigned shor
 	    // It's up to the application code to update the OpenGL viewport settings.
     // In order to avoid extensive context switching, consider doing this in
     // OnPaint() rather than here, though.
-    glViewport(0, 0, (GLint) xSize, (GLint) ySize);
+	if (!_nullGraphics)
+		glViewport(0, 0, (GLint) xSize, (GLint) ySize);
 	_glM.setView(0.7f,(float)xSize/ySize);
 }
 
@@ -126,6 +130,8 @@ void gl3wGraphics::drawAll()
 	// This next line is normally only necessary if there is more than one wxGLCanvas
     // or more than one wxGLContext in the application.
     //SetCurrent(*m_glRC);
+	if (_nullGraphics)
+		return;
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
     GLfloat m[4][4];
     _tBall.build_rotmatrix( m,_rotQuat);
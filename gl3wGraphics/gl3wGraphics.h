@@ -51,6 +51,9 @@ public:
 	sceneNode* getNodePtr(std::string &name);
 	void clear();	// empties all graphics
 	void zeroViewRotations() { _rotQuat[0] = 0.0f; _rotQuat[1] = 0.0f; _rotQuat[2] = 0.0f; _rotQuat[3] = 1.0f;}
+	// Null graphics keeps all scene data (nodes, matrices, bounds, texture ids) but makes no GL calls.  Batch runs use it with no GL context.  Set before initializeGraphics().
+	static void setNullGraphics(const bool nullGraphics) { _nullGraphics = nullGraphics; }
+	static inline bool nullGraphics() { return _nullGraphics; }
 	gl3wGraphics();
 	~gl3wGraphics();
 
@@ -71,6 +74,7 @@ private:
 	GLuint  texture;
 	static bool mouseWheelZoom;
 	static float mouseWheelLevel;
+	static bool _nullGraphics;
 };
 
 #endif	// __WX_OPENGL_H__
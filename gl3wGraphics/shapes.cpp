@@ -51,9 +51,11 @@ std::shared_ptr<sceneNode>  shapes::addShape(const sceneNode::nodeType& type, ch
 	}
 	else
 		return NULL;
-	GLuint program = _gl3w->getLightsShaders()->getOrCreateColorProgram();
-	sn->setGlslProgramNumber(program);
-	sn->setColorLocation(glGetUniformLocation(program, "objectColor"));
+	if (!gl3wGraphics::nullGraphics()) {
+		GLuint program = _gl3w->getLightsShaders()->getOrCreateColorProgram();
+		sn->setGlslProgramNumber(program);
+		sn->setColorLocation(glGetUniformLocation(program, "objectColor"));
+	}
 	sn->setName(name);
 	_gl3w->addSceneNode(sn);
 	return sn;
@@ -227,6 +229,8 @@ void shapes::drawCone()
 void shapes::getOrCreateCylinderGraphic()
 { // creates cylinder at origin with diameter 1.0, from z=-1 to z=1
 	// Create the buffer objects once
+	if (gl3wGraphics::nullGraphics())
+		return;
 	if(!_cylinderVertexArrayBufferObject)
 		glGenVertexArrays(1,&_cylinderVertexArrayBufferObject);
 	else
@@ -311,6 +315,8 @@ void shapes::getOrCreateCylinderGraphic()
 void shapes::getOrCreateSphereGraphic()
 { // creates sphere at origin with a radius of 1.0
 	// Create the buffer objects once
+	if (gl3wGraphics::nullGraphics())
+		return;
 	if (!_sphereVertexArrayBufferObject)
 		glGenVertexArrays(1, &_sphereVertexArrayBufferObject);
 	else
@@ -398,6 +404,8 @@ void shapes::getOrCreateSphereGraphic()
 void shapes::getOrCreateConeGraphic()
 {
 	// Create the buffer objects once
+	if (gl3wGraphics::nullGraphics())
+		return;
 	if(!_coneVertexArrayBufferObject)
 		glGenVertexArrays(1,&_coneVertexArrayBufferObject);
 	else
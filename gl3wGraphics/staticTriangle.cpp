@@ -147,6 +147,12 @@ bool staticTriangle::createStaticProgram() {
 std::shared_ptr<sceneNode> staticTriangle::createStaticSceneNode(materialTriangles* mt, std::vector<int> &textureIds)
 {  // must be set first
 	_mt = mt;
+	if (gl3wGraphics::nullGraphics()) {  // bounds only, used to frame the scene
+		_snNow = std::make_shared<sceneNode>();
+		_snNow->setType(sceneNode::nodeType::STATIC_TRIANGLES);
+		computeLocalBounds();
+		return _snNow;
+	}
 	if (_staticProgram < 1) {
 		if (!createStaticProgram())
 			return nullptr;
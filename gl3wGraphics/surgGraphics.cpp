@@ -10,12 +10,14 @@
 //////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <cstring>
 #include <set>
 #include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <assert.h>
 #include "Vec3f.h"
+#include "tbb/tbb.h"
 #include "lightsShaders.h"
 #include "boundingBox.h"
 #include "gl3wGraphics.h"
@@ -23,6 +25,13 @@
 
 GLuint incisionLines::_incisionBufferObjects[2] = { 0xffffffff, 0xffffffff };
 GLuint incisionLines::_incisionVertexArrayBufferObject = 0xffffffff;
+GLintptr incisionLines::_incisionVertexOffset = 0;
+const int vertexStream::_components[vertexStream::N_STREAMS] = { 4, 3, 3 };
+
+#ifndef GL_MAP_PERSISTENT_BIT  // GL 4.4 and ARB_buffer_storage, beyond the gl3w headers
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
 
 
 const GLchar *surgGraphics::skinVertexShader = "#version 150 core\n"
@@ -287,22 +296,22 @@ bool surgGraphics::setTextureFilesCreateProgram(std::vector<int> &textureIds, co
 	_sn->setType(sceneNode::nodeType::MATERIAL_TRIANGLES);
 	_sn->visible = true;
 	_sn->setSurgGraphics(this);
+	if (gl3wGraphics::nullGraphics()) {  // no program or buffers, setNewTopology() still builds the triangle data
+		_gl3w->addSceneNode(_sn);
+		return true;
+	}
 	bool ret = _gl3w->addCustomSceneNode(_sn, textureIds, vShd.c_str(), fShd.c_str(), att);
 	if(!ret)
 		return ret;
 //	_gl3w->getLightsShaders()->useGlslProgram(_sn->glslProgram);  // must be current program. This routine sets other uniforms.
 	if (_sn->bufferObjects.size() != 5) {
 		_sn->bufferObjects.assign(5, 0);
-		glGenBuffers(5, &_sn->bufferObjects[0]);
-	}
-	// Vertex data - allocate reasonable initial size (will be resized in setNewTopology)
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[0]);	// VERTEX_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 65536, NULL, GL_DYNAMIC_DRAW);  // 65K vertices * 4 floats
-	// Normal data
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[1]);	// NORMAL_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 3 * 65536, NULL, GL_DYNAMIC_DRAW);  // 65K normals * 3 floats
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[2]);	// TANGENT_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 3 * 65536, NULL, GL_DYNAMIC_DRAW);  // 65K tangents * 3 floats
+		glGenBuffers(2, &_sn->bufferObjects[3]);
+	}
+	// Vertex, normal and tangent data are streamed. Reasonable initial size, grown in setNewTopology().
+	_stream.reserve(65536);
+	for (int i = 0; i < vertexStream::N_STREAMS; ++i)
+		_sn->bufferObjects[i] = _stream.buffer((vertexStream::streamType)i);
 	// Texture coordinates
 	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[3]);	// TEXTURE_DATA
 	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 2 * 65536, NULL, GL_DYNAMIC_DRAW);  // 65K texcoords * 2 floats
@@ -311,19 +320,8 @@ bool surgGraphics::setTextureFilesCreateProgram(std::vector<int> &textureIds, co
 	if (_sn->vertexArrayBufferObject == 0xffffffff)
 		glGenVertexArrays(1,&_sn->vertexArrayBufferObject);
 	// now make vertex array
+	bindStreamAttributes();  // position, normal and tangent data
 	glBindVertexArray(_sn->vertexArrayBufferObject);
-    // Position data
-    glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[0]);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
-    // Normal data
-    glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[1]);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
-	// Tangent data
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[2]);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, 0);
 	// Texture coordinates
 	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[3]);	// TEXTURE_DATA
 	glEnableVertexAttribArray(3);
@@ -376,22 +374,28 @@ void surgGraphics::setNewTopology()
 		}
 	}
 	getTextureSeams();
-	// Vertex data
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[0]);	// VERTEX_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*_xyz1.size(), &(_xyz1[0]), GL_DYNAMIC_DRAW);
-	// Normal data
-	std::vector<GLfloat> tnVec;
-	tnVec.assign((_uv.size() >> 1) * 3, 0.0f);;
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[1]);	// NORMAL_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * tnVec.size(), &(tnVec[0]), GL_DYNAMIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[2]);	// TANGENT_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * tnVec.size(), &(tnVec[0]), GL_DYNAMIC_DRAW);
-	// Texture coordinates
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[3]);	// TEXTURE_DATA
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*_uv.size(), &(_uv[0]), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _sn->bufferObjects[4]);	// INDEX_DATA
-	// Eliminate deleted triangles from viewing, but to keep the numbering send to graphics card
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*_tris.size(), &(_tris[0]), GL_STATIC_DRAW);
+	getVertexTriangles();
+	// Vertex, normal and tangent data
+	int nVerts = (int)_uvPos.size();
+	if (_stream.reserve(nVerts)) {
+		for (int i = 0; i < vertexStream::N_STREAMS; ++i)
+			_sn->bufferObjects[i] = _stream.buffer((vertexStream::streamType)i);
+	}
+	_normals.assign(nVerts * 3, 0.0f);
+	_tangents.assign(nVerts * 3, 0.0f);
+	_stream.beginFrame();
+	_stream.upload(vertexStream::POSITIONS, _xyz1.data(), nVerts);
+	_stream.upload(vertexStream::NORMALS, _normals.data(), nVerts);
+	_stream.upload(vertexStream::TANGENTS, _tangents.data(), nVerts);
+	bindStreamAttributes();
+	if (!gl3wGraphics::nullGraphics()) {
+		// Texture coordinates
+		glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[3]);	// TEXTURE_DATA
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*_uv.size(), &(_uv[0]), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _sn->bufferObjects[4]);	// INDEX_DATA
+		// Eliminate deleted triangles from viewing, but to keep the numbering send to graphics card
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*_tris.size(), &(_tris[0]), GL_STATIC_DRAW);
+	}
 	getSkinIncisionLines();  // do this last as needs the vertex position buffer to paint incision lines.
 }
 
@@ -447,121 +451,192 @@ void surgGraphics::getSkinIncisionLines() {
 		}
 		_incisionLines.push_back(0xffffffff);
 	}
-	if (!_incisionLines.empty()) {
+	if (!_incisionLines.empty() && !gl3wGraphics::nullGraphics()) {
 		if (!_incis.isInitialized()) {
 			_incis.setGl3wGraphics(_gl3w);
 			float color[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
 			_incis.setColor(color);
 		}
 		assert(_sn->bufferObjects[0] > 0);
-		_incis.sendVertexCoordBuffer(_sn->bufferObjects[0]);
+		_incis.sendVertexCoordBuffer(_stream.buffer(vertexStream::POSITIONS), _stream.offset(vertexStream::POSITIONS));
 		_incis.addUpdateIncisions(_incisionLines);
 	}
 }
 
 void surgGraphics::updatePositionsNormalsTangents()  // bool doTangents now always true
 {
-	for (int m = (int)_uvPos.size(), i = 0; i < m; ++i) {
-		if (_uvPos[i] < 0)
-			continue;
-		float* fp = _mt.vertexCoordinate(_uvPos[i]);
-		for (int j = 0; j < 3; ++j)
-			_xyz1[(i << 2) + j] = fp[j];
-	}
-	std::vector<GLfloat> normals, tangents;
-	normals.assign((_uv.size() >> 1) * 3, 0.0f);
-	tangents.assign(normals.size(), 0.0f);
-	int i=0,j,k,n;
-	GLfloat *gv[3], *tv[3];
-	n = (unsigned int)_tris.size();
-	Vec3f nrmV,tanV,dXyz[2];
-	float d2,dTx[2][2];
-	for(i=0; i<n; i+=3) {
-		if (_tris[i]>0xfffffffe)
-			continue;
-		for(j=0; j<3; ++j) {
-			nrmV[j]=0.0f;
-			gv[j] = &_xyz1[_tris[i+j] << 2];
-			tv[j] = &_uv[_tris[i + j] << 1];
-		}
-		for(j=0; j<3; ++j) {
-			dXyz[0][j] = gv[1][j]-gv[0][j];
-			dXyz[1][j] = gv[2][j]-gv[0][j];
-		}
-		for (j = 0; j<2; ++j) {
-			dTx[0][j] = tv[1][j] - tv[0][j];
-			dTx[1][j] = tv[2][j] - tv[0][j];
-		}
-		d2 = dTx[0][0] * dTx[1][1] - dTx[1][0] * dTx[0][1];
-		if (fabs(d2) < 1e-16f)
-			tanV.set(0.0f, 0.0f, 0.0f);
-		else
-			tanV = (dXyz[0] * dTx[1][1] - dXyz[1] * dTx[0][1]) / d2;
-		nrmV = dXyz[0] ^ dXyz[1];
-		for (j = 0; j < 3; ++j) {
-			k = _tris[i + j] * 3;
-			normals[k] += nrmV[0];
-			normals[k + 1] += nrmV[1];
-			normals[k + 2] += nrmV[2];
-			tangents[k] += tanV[0];
-			tangents[k + 1] += tanV[1];
-			tangents[k + 2] += tanV[2];
+	int nVerts = (int)_uvPos.size(), nTris = (int)_tris.size() / 3;
+	_stream.beginFrame();
+	tbb::parallel_for(tbb::blocked_range<int>(0, nVerts), [&](const tbb::blocked_range<int>& r) {
+		for (int i = r.begin(); i != r.end(); ++i) {
+			if (_uvPos[i] < 0)
+				continue;
+			float* fp = _mt.vertexCoordinate(_uvPos[i]);
+			for (int j = 0; j < 3; ++j)
+				_xyz1[(i << 2) + j] = fp[j];
 		}
-	}
-	for(auto &txs : _textureSeams){
-		GLfloat ns[3] = { 0.0f, 0.0f, 0.0f }, ts[3] = { 0.0f, 0.0f, 0.0f };
-		for (auto &bv : txs.second) {
+	});
+	// face normals and tangents first, then each vertex gathers its own so no two threads write the same vertex
+	_triNormals.resize(nTris * 3);
+	_triTangents.resize(nTris * 3);
+	tbb::parallel_for(tbb::blocked_range<int>(0, nTris), [&](const tbb::blocked_range<int>& r) {
+		GLfloat* gv[3], * tv[3];
+		Vec3f nrmV, tanV, dXyz[2];
+		float d2, dTx[2][2];
+		for (int t = r.begin(); t != r.end(); ++t) {
+			const GLuint* tr = &_tris[t * 3];
+			if (tr[0] > 0xfffffffe)
+				continue;
 			for (int j = 0; j < 3; ++j) {
-				ns[j] += normals[bv * 3 + j];
-				ts[j] += tangents[bv * 3 + j];
+				gv[j] = &_xyz1[tr[j] << 2];
+				tv[j] = &_uv[tr[j] << 1];
 			}
-		}
-		for (auto& bv : txs.second) {
 			for (int j = 0; j < 3; ++j) {
-				normals[bv * 3 + j] = ns[j];
-				tangents[bv * 3 + j] = ts[j];
+				dXyz[0][j] = gv[1][j] - gv[0][j];
+				dXyz[1][j] = gv[2][j] - gv[0][j];
+			}
+			for (int j = 0; j < 2; ++j) {
+				dTx[0][j] = tv[1][j] - tv[0][j];
+				dTx[1][j] = tv[2][j] - tv[0][j];
+			}
+			d2 = dTx[0][0] * dTx[1][1] - dTx[1][0] * dTx[0][1];
+			if (fabs(d2) < 1e-16f)
+				tanV.set(0.0f, 0.0f, 0.0f);
+			else
+				tanV = (dXyz[0] * dTx[1][1] - dXyz[1] * dTx[0][1]) / d2;
+			nrmV = dXyz[0] ^ dXyz[1];
+			for (int j = 0; j < 3; ++j) {
+				_triNormals[t * 3 + j] = nrmV[j];
+				_triTangents[t * 3 + j] = tanV[j];
 			}
 		}
-	}
+	});
 	auto invSqrt = [](float x) ->float{ // Steve Pizer's version of the Quake algorithm
 		GLuint i = 0x5F1F1412 - (*(GLuint*)&x >> 1);
 		float tmp = *(float*)&i;
 		return tmp * (1.69000231f - 0.714158168f * x * tmp * tmp);
 	};
-	n = (int)normals.size();
-	for (i = 0; i < n; i += 3) {
-		if (_tris[i]>0xfffffffe)
-			continue;
-		d2 = normals[i] * normals[i] + normals[i + 1] * normals[i + 1] + normals[i + 2] * normals[i + 2];
-		if (d2 < 1e-16f) {
-			normals[i] = 0.0f; normals[i + 1] = 0.0f; normals[i + 2] = 1.0f;
-		}
-		else {
-			d2 = invSqrt(d2);
-			normals[i] *= d2; normals[i + 1] *= d2; normals[i + 2] *= d2;
-		}
-		d2 = tangents[i] * tangents[i] + tangents[i + 1] * tangents[i + 1] + tangents[i + 2] * tangents[i + 2];
-		if (d2 < 1e-16f) {
-			tangents[i] = 1.0f; tangents[i + 1] = 0.0f; tangents[i + 2] = 0.0f;
+	_stream.upload(vertexStream::POSITIONS, _xyz1.data(), nVerts);
+	// with persistent mapping normals and tangents go straight into the GPU buffer, so each is written exactly once and never read back
+	GLfloat* normals = _stream.mapped(vertexStream::NORMALS), * tangents = _stream.mapped(vertexStream::TANGENTS);
+	if (!normals) {
+		_normals.resize(nVerts * 3);
+		_tangents.resize(nVerts * 3);
+		normals = _normals.data();
+		tangents = _tangents.data();
+	}
+	tbb::parallel_for(tbb::blocked_range<int>(0, nVerts), [&](const tbb::blocked_range<int>& r) {
+		for (int i = r.begin(); i != r.end(); ++i) {
+			GLfloat nrm[3] = { 0.0f, 0.0f, 0.0f }, tan[3] = { 0.0f, 0.0f, 0.0f };
+			for (int k = _vertexTriangleOffsets[i]; k < _vertexTriangleOffsets[i + 1]; ++k) {
+				int t = _vertexTriangles[k] * 3;
+				for (int j = 0; j < 3; ++j) {
+					nrm[j] += _triNormals[t + j];
+					tan[j] += _triTangents[t + j];
+				}
+			}
+			float d2 = nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2];
+			if (d2 < 1e-16f) {
+				nrm[0] = 0.0f; nrm[1] = 0.0f; nrm[2] = 1.0f;
+			}
+			else {
+				d2 = invSqrt(d2);
+				nrm[0] *= d2; nrm[1] *= d2; nrm[2] *= d2;
+			}
+			d2 = tan[0] * tan[0] + tan[1] * tan[1] + tan[2] * tan[2];
+			if (d2 < 1e-16f) {
+				tan[0] = 1.0f; tan[1] = 0.0f; tan[2] = 0.0f;
+			}
+			else {
+				d2 = invSqrt(d2);
+				tan[0] *= d2; tan[1] *= d2; tan[2] *= d2;
+			}
+			for (int j = 0; j < 3; ++j) {
+				normals[i * 3 + j] = nrm[j];
+				tangents[i * 3 + j] = tan[j];
+			}
 		}
-		else {
-			d2 = invSqrt(d2);
-			tangents[i] *= d2; tangents[i + 1] *= d2; tangents[i + 2] *= d2;
+	});
+	if (_stream.persistent())
+		bindStreamAttributes();  // now drawing from this frame's region
+	else {
+		_stream.upload(vertexStream::NORMALS, _normals.data(), nVerts);
+		_stream.upload(vertexStream::TANGENTS, _tangents.data(), nVerts);
+	}
+}
+
+void surgGraphics::bindStreamAttributes()
+{  // with persistent mapping the region drawn from moves every frame
+	if (gl3wGraphics::nullGraphics())
+		return;
+	glBindVertexArray(_sn->vertexArrayBufferObject);
+	for (int i = 0; i < vertexStream::N_STREAMS; ++i) {
+		vertexStream::streamType st = (vertexStream::streamType)i;
+		glBindBuffer(GL_ARRAY_BUFFER, _stream.buffer(st));
+		glEnableVertexAttribArray(i);
+		glVertexAttribPointer(i, vertexStream::components(st), GL_FLOAT, GL_FALSE, 0, (const GLvoid*)_stream.offset(st));
+	}
+	// never unbind a GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER inside a vertexArrayBuffer
+	glBindVertexArray(0);
+	if (_incis.isInitialized())
+		_incis.sendVertexCoordBuffer(_stream.buffer(vertexStream::POSITIONS), _stream.offset(vertexStream::POSITIONS));
+}
+
+void surgGraphics::getVertexTriangles()
+{  // vertex to incident valid triangle lists, with every member of a texture seam getting the triangles of the whole seam
+	int nVerts = (int)_uvPos.size(), nTris = (int)_tris.size() / 3;
+	std::vector<int> offsets(nVerts + 1, 0), tris;
+	for (int i = 0; i < nTris; ++i) {
+		if (_tris[i * 3] > 0xfffffffe)
+			continue;
+		for (int j = 0; j < 3; ++j)
+			++offsets[_tris[i * 3 + j] + 1];
+	}
+	for (int i = 0; i < nVerts; ++i)
+		offsets[i + 1] += offsets[i];
+	tris.resize(offsets[nVerts]);
+	std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+	for (int i = 0; i < nTris; ++i) {
+		if (_tris[i * 3] > 0xfffffffe)
+			continue;
+		for (int j = 0; j < 3; ++j)
+			tris[fill[_tris[i * 3 + j]]++] = i;
+	}
+	std::vector<const std::list<int>*> seam(nVerts, nullptr);
+	for (auto& txs : _textureSeams) {
+		for (auto bv : txs.second)
+			seam[bv] = &txs.second;
+	}
+	_vertexTriangleOffsets.resize(nVerts + 1);
+	_vertexTriangleOffsets[0] = 0;
+	for (int i = 0; i < nVerts; ++i) {
+		int count = 0;
+		if (seam[i]) {
+			for (auto bv : *seam[i])
+				count += offsets[bv + 1] - offsets[bv];
 		}
+		else
+			count = offsets[i + 1] - offsets[i];
+		_vertexTriangleOffsets[i + 1] = _vertexTriangleOffsets[i] + count;
 	}
-	// Vertex data
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[0]);	// VERTEX_DATA
-	// now copy data into memory  glBufferSubdata() appears to be faster than memcopy into mapped buffer
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * _xyz1.size(), &(_xyz1[0]));
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[1]);	// NORMAL_DATA
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * normals.size(), &(normals[0]));
-	glBindBuffer(GL_ARRAY_BUFFER, _sn->bufferObjects[2]);	// TANGENT_DATA
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * tangents.size(), &(tangents[0]));
+	_vertexTriangles.resize(_vertexTriangleOffsets[nVerts]);
+	tbb::parallel_for(tbb::blocked_range<int>(0, nVerts), [&](const tbb::blocked_range<int>& r) {
+		for (int i = r.begin(); i != r.end(); ++i) {
+			int* vt = &_vertexTriangles[_vertexTriangleOffsets[i]];
+			if (seam[i]) {
+				for (auto bv : *seam[i])
+					vt = std::copy(tris.begin() + offsets[bv], tris.begin() + offsets[bv + 1], vt);
+			}
+			else
+				std::copy(tris.begin() + offsets[i], tris.begin() + offsets[i + 1], vt);
+		}
+	});
 }
 
 void surgGraphics::getTextureSeams() {
 	// vertex positions with multiple textures of same material (2 or 5 guaranteed exclusive) associated with them for normal and tangent blending
 //	_mt.findAdjacentTriangles(true);  // not necessary. done in calling routine
+	_textureSeams.clear();
 	auto addSeamVert = [&](int vPos, int tex0, int tex1) {
 		auto pr = _textureSeams.insert(std::make_pair(vPos, std::list<int>()));
 		if (tex0 > tex1) { int tmp = tex1; tex1 = tex0; tex0 = tmp; }
@@ -680,9 +755,12 @@ surgGraphics::surgGraphics() : _undermineTriangles(NULL), _sn(nullptr)
 
 surgGraphics::~surgGraphics(void)
 {
-	if (!_sn)
+	if (!_sn || gl3wGraphics::nullGraphics())
 		return;
+	_stream.release();
 	if (!_sn->bufferObjects.empty()) {
+		for (int i = 0; i < vertexStream::N_STREAMS; ++i)
+			_sn->bufferObjects[i] = 0;
 		glDeleteBuffers((GLsizei)_sn->bufferObjects.size(), &_sn->bufferObjects[0]);
 		_sn->bufferObjects.clear();
 	}
@@ -723,7 +801,7 @@ void incisionLines::addUpdateIncisions(const std::vector<GLuint> &lines){
 		// Vertex data
 		glBindBuffer(GL_ARRAY_BUFFER, _isn->bufferObjects[1]);	// VERTEX DATA
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)_incisionVertexOffset);
 		// Unbind to anybody
 		glBindVertexArray(0);
 		_gl3w->addSceneNode(_isn);
@@ -738,4 +816,113 @@ void incisionLines::addUpdateIncisions(const std::vector<GLuint> &lines){
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void incisionLines::sendVertexCoordBuffer(GLuint vertCoordBuf, GLintptr offset)
+{
+	_incisionBufferObjects[1] = vertCoordBuf;
+	_incisionVertexOffset = offset;
+	if (!isInitialized())
+		return;
+	_isn->bufferObjects[1] = vertCoordBuf;
+	glBindVertexArray(_incisionVertexArrayBufferObject);
+	glBindBuffer(GL_ARRAY_BUFFER, vertCoordBuf);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)offset);
+	glBindVertexArray(0);
+}
 
+bool vertexStream::reserve(const int nVertices)
+{
+	if ((_buffers[0] && nVertices <= _capacity) || gl3wGraphics::nullGraphics())
+		return false;
+	int capacity = std::max(nVertices, _capacity + (_capacity >> 1));
+	release();
+	if (!_storageChecked) {
+		_storageChecked = true;
+		bool supported = gl3wIsSupported(4, 4) != 0;
+		GLint nExt = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &nExt);
+		for (GLint i = 0; i < nExt && !supported; ++i) {
+			const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			supported = ext && strcmp(ext, "GL_ARB_buffer_storage") == 0;
+		}
+		if (supported)
+			_bufferStorage = (bufferStorageProc)gl3wGetProcAddress("glBufferStorage");
+	}
+	_persistent = _bufferStorage != nullptr;
+	glGenBuffers(N_STREAMS, _buffers);
+	for (int i = 0; i < N_STREAMS; ++i) {
+		glBindBuffer(GL_ARRAY_BUFFER, _buffers[i]);
+		GLsizeiptr bytes = sizeof(GLfloat) * capacity * _components[i];
+		if (_persistent) {
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			_bufferStorage(GL_ARRAY_BUFFER, bytes * _regions, nullptr, flags);
+			_mapped[i] = (GLfloat*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes * _regions, flags);
+			if (!_mapped[i]) {  // driver claimed support but won't map. Never try again.
+				std::cerr << "Persistent mapping of surface vertex buffers failed. Using glBufferSubData().\n";
+				_bufferStorage = nullptr;
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+				release();
+				return reserve(nVertices);
+			}
+		}
+		else
+			glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_DYNAMIC_DRAW);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	_capacity = capacity;
+	_region = 0;
+	return true;
+}
+
+void vertexStream::beginFrame()
+{
+	if (!_persistent)
+		return;
+	// everything drawn since the last frame read the current region
+	if (_fences[_region])
+		glDeleteSync(_fences[_region]);
+	_fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	_region = (_region + 1) % _regions;
+	if (_fences[_region]) {  // normally long signaled with three regions
+		GLenum ret;
+		do
+			ret = glClientWaitSync(_fences[_region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (ret == GL_TIMEOUT_EXPIRED);
+		glDeleteSync(_fences[_region]);
+		_fences[_region] = nullptr;
+	}
+}
+
+void vertexStream::upload(const streamType stream, const GLfloat* data, const size_t nVertices)
+{
+	if (nVertices < 1 || !_buffers[0])  // no buffers with null graphics
+		return;
+	size_t nFloats = nVertices * _components[stream];
+	if (_persistent) {
+		GLfloat* dst = mapped(stream);
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, nFloats, 1 << 16), [&](const tbb::blocked_range<size_t>& r) {
+			std::copy(data + r.begin(), data + r.end(), dst + r.begin());
+		});
+	}
+	else {
+		glBindBuffer(GL_ARRAY_BUFFER, _buffers[stream]);
+		// glBufferSubdata() appears to be faster than memcopy into a buffer mapped each frame
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * nFloats, data);
+	}
+}
+
+void vertexStream::release()
+{
+	for (int i = 0; i < _regions; ++i) {
+		if (_fences[i])
+			glDeleteSync(_fences[i]);
+		_fences[i] = nullptr;
+	}
+	if (_buffers[0])  // deleting also unmaps
+		glDeleteBuffers(N_STREAMS, _buffers);
+	for (int i = 0; i < N_STREAMS; ++i) {
+		_buffers[i] = 0;
+		_mapped[i] = nullptr;
+	}
+	_capacity = 0;
+	_region = 0;
+}
@@ -27,7 +27,7 @@ class incisionLines
 {
 public:
 	bool isInitialized(){ return _isn && !_isn->bufferObjects.empty(); }
-	void sendVertexCoordBuffer(GLuint vertCoordBuf){ _incisionBufferObjects[1] = vertCoordBuf; }  // must be called before addIncisions()
+	void sendVertexCoordBuffer(GLuint vertCoordBuf, GLintptr offset = 0);  // must be called before addIncisions() and again whenever the surface stream moves
 	void addUpdateIncisions(const std::vector<GLuint> &lines);  // 0xffffffff is primitive restart index
 	void setGl3wGraphics(gl3wGraphics *gl3w) { _gl3w = gl3w; }
 	void setSurgGraphics(surgGraphics* sg) { _sg = sg; }
@@ -42,9 +42,42 @@ private:
 	surgGraphics *_sg;
 	static GLuint _incisionBufferObjects[2];
 	static GLuint _incisionVertexArrayBufferObject;
+	static GLintptr _incisionVertexOffset;
 };
 
 
+// Streams the per frame positions, normals and tangents of the deformable surface to the GPU. Given GL 4.4 or ARB_buffer_storage each goes in
+// a persistently mapped buffer holding three frames, a region being rewritten only after a fence shows the GPU has finished drawing from it.
+// Otherwise falls back to glBufferSubData() into a single region. Buffers grow with the surface.
+class vertexStream
+{
+public:
+	enum streamType { POSITIONS = 0, NORMALS, TANGENTS, N_STREAMS };
+	bool reserve(const int nVertices);  // true if the buffer objects were replaced, so vertex attributes must be rebound
+	void beginFrame();  // call before writing a frame. May wait on the GPU.
+	inline GLfloat* mapped(const streamType stream) { return _persistent ? _mapped[stream] + (size_t)_region * _capacity * _components[stream] : nullptr; }
+	void upload(const streamType stream, const GLfloat* data, const size_t nVertices);  // copies into the current region
+	inline GLuint buffer(const streamType stream) const { return _buffers[stream]; }
+	inline GLintptr offset(const streamType stream) const { return (GLintptr)sizeof(GLfloat) * _region * _capacity * _components[stream]; }
+	inline bool persistent() const { return _persistent; }
+	static inline int components(const streamType stream) { return _components[stream]; }
+	void release();
+	vertexStream() : _persistent(false), _capacity(0), _region(0) {}
+	~vertexStream() {}
+
+private:
+	static const int _components[N_STREAMS];
+	static const int _regions = 3;
+	bool _persistent;
+	int _capacity, _region;
+	GLuint _buffers[N_STREAMS] = { 0, 0, 0 };
+	GLfloat* _mapped[N_STREAMS] = { nullptr, nullptr, nullptr };
+	GLsync _fences[_regions] = { nullptr, nullptr, nullptr };
+	bool _storageChecked = false;
+	typedef void (APIENTRYP bufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+	bufferStorageProc _bufferStorage = nullptr;
+};
+
 class surgGraphics
 {
 public:
@@ -74,6 +107,14 @@ private:
 	std::vector<GLuint> _incisionLines;  // indexes into incision lines. 0xffffffff is primitive restart index.
 	incisionLines _incis;
 	std::map<int, std::list<int> > _textureSeams;  // vertex positions with multiple textures of same material (2 or 5 guaranteed exclusive) associated with them for normal and tangent blending
+	// Valid triangles whose normals and tangents each texture vertex sums, texture seam partners included. Built in setNewTopology() so
+	// updatePositionsNormalsTangents() can gather per vertex in parallel without write conflicts.
+	std::vector<int> _vertexTriangleOffsets, _vertexTriangles;
+	std::vector<GLfloat> _triNormals, _triTangents, _normals, _tangents;  // kept between frames. Normals and tangents only used without persistent mapping.
+	vertexStream _stream;
+
+	void getVertexTriangles();
+	void bindStreamAttributes();
 
 	void getSkinIncisionLines();
 	void getTextureSeams();
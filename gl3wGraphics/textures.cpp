@@ -24,6 +24,7 @@
 #include "stb_image.h"  // above defines needed
 
 #include "Bitmap.h"
+#include "gl3wGraphics.h"
 #include "textures.h"
 
 // Macro for handling little-endian word conversion
@@ -42,8 +43,9 @@ textures::~textures() {
 
 void textures::clear() {	// clears textures from graphics card
     std::map<int,tex>::iterator tit;
-    for(tit=_textures.begin(); tit!=_textures.end(); ++tit)	{
-        glDeleteTextures(1, &(tit->second.texture));
+    if (!gl3wGraphics::nullGraphics()) {
+        for (tit = _textures.begin(); tit != _textures.end(); ++tit)
+            glDeleteTextures(1, &(tit->second.texture));
     }
     _textures.clear();
 }
@@ -71,6 +73,8 @@ int textures::loadTexture(int txId, const char *fileName)	{
 	if (!pr.second)
 		return 0;
 	pr.first->second.name = fileName;
+	if (gl3wGraphics::nullGraphics())  // keep the id so textureExists() works, nothing to upload to
+		return pr.first->first;
 	glGenTextures(1, &(pr.first->second.texture));
 	glBindTexture(GL_TEXTURE_2D, pr.first->second.texture);
 	bool ret;
@@ -52,8 +52,17 @@
 
 #if defined(ENABLE_MIC_INSTRUCTION_SET)
 #include <immintrin.h>
+#ifdef __INTEL_COMPILER
 #include <zmmintrin.h>
 #endif
+#endif
+
+#if defined(ENABLE_NEON_INSTRUCTION_SET)
+#if !defined(__aarch64__) && !defined(_M_ARM64)
+#error "Number<SIMDArchitectureNEON> needs AArch64 (float64x2_t, vsqrtq, vrsqrteq_f64)"
+#endif
+#include <arm_neon.h>
+#endif
 
 //#include "NumberPolicy.h"
 #include "Mask.h"
@@ -99,6 +108,15 @@ struct VTYPE_POLICY<__m512>{
 #endif
 
 
+#if defined(ENABLE_NEON_INSTRUCTION_SET)
+template <>
+struct VTYPE_POLICY<float32x4_t>{
+    const static int V_WIDTH=4;
+};
+#include "arch/arm64/Number.NEON.h"
+#endif
+
+
 // Define Architecture Specific Helper Macros and Miscellanious
 
 #if defined(ENABLE_AVX_INSTRUCTION_SET)
@@ -149,6 +167,13 @@ struct widetype<T,1>{
 #define INSTANCE_KERNEL_SIMD_MIC_FLOAT(KERNEL,DATA_WIDTH)
 #define INSTANCE_KERNEL_SIMD_MIC_DOUBLE(KERNEL,DATA_WIDTH)
 #endif
+#ifdef ENABLE_NEON_INSTRUCTION_SET
+#define INSTANCE_KERNEL_SIMD_NEON_FLOAT(KERNEL,DATA_WIDTH) template void KERNEL<SIMDArchitectureNEON<float>,WIDETYPE(float,DATA_WIDTH)>( INSTANCE_KERNEL_ ## KERNEL(DATA_WIDTH, float) );
+#define INSTANCE_KERNEL_SIMD_NEON_DOUBLE(KERNEL,DATA_WIDTH) template void KERNEL<SIMDArchitectureNEON<double>,WIDETYPE(double,DATA_WIDTH)>( INSTANCE_KERNEL_ ## KERNEL(DATA_WIDTH, double) );
+#else
+#define INSTANCE_KERNEL_SIMD_NEON_FLOAT(KERNEL,DATA_WIDTH)
+#define INSTANCE_KERNEL_SIMD_NEON_DOUBLE(KERNEL,DATA_WIDTH)
+#endif
 #define INSTANCE_KERNEL( KERNEL )                \
     INSTANCE_KERNEL_SCALAR_FLOAT( KERNEL, 1 )    \
     INSTANCE_KERNEL_SIMD_FLOAT( KERNEL, 4 )      \
@@ -0,0 +1,320 @@
+//#####################################################################
+//  Copyright (c) 2011-2019 Nathan Mitchell, Eftychios Sifakis, Yutian Tao, Qisi Wang.
+//  This file is covered by the FreeBSD license. Please refer to the
+//  license.txt file for more information.
+//#####################################################################
+
+#pragma once
+
+#include "arch/arm64/SIMDArchitectureNEON.h"
+namespace SIMD_Numeric_Kernel {
+//==============================================================//
+//                                                              //
+//                      CONSTRUCTORS                            //
+//                                                              //
+//==============================================================//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>>::Number()
+{value=vdupq_n_f32(0.f);}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>>::Number()
+{value=vdupq_n_f64(0.);}
+
+
+//==============================================================//
+//                                                              //
+//                      BASIC OPERATIONS                        //
+//                                                              //
+//==============================================================//
+
+
+//------------------------------------//
+//             ADDITION               //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator+(const Number& other) const
+{Number<SIMDArchitectureNEON<float>> result;result.value=vaddq_f32(value,other.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator+(const Number& other) const
+{Number<SIMDArchitectureNEON<double>> result;result.value=vaddq_f64(value,other.value);return result;}
+
+
+//------------------------------------//
+//           MULTIPLICATION           //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator*(const Number& other) const
+{Number<SIMDArchitectureNEON<float>> result;result.value=vmulq_f32(value,other.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator*(const Number& other) const
+{Number<SIMDArchitectureNEON<double>> result;result.value=vmulq_f64(value,other.value);return result;}
+
+
+//------------------------------------//
+//           SUBTRACTION              //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator-(const Number& other) const
+{Number<SIMDArchitectureNEON<float>> result;result.value=vsubq_f32(value,other.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator-(const Number& other) const
+{Number<SIMDArchitectureNEON<double>> result;result.value=vsubq_f64(value,other.value);return result;}
+
+
+//==============================================================//
+//                                                              //
+//                      COMPARISON OPERATIONS                   //
+//                                                              //
+//==============================================================//
+
+//------------------------------------//
+//             LESS THAN              //
+//------------------------------------//
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator<(const Number& other) const
+{Mask<Tarch> result;result.value=vcltq_f32(value,other.value);return result;}
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator<(const Number& other) const
+{Mask<Tarch> result;result.value=vcltq_f64(value,other.value);return result;}
+
+
+//------------------------------------//
+//             LESS EQUALS            //
+//------------------------------------//
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator<=(const Number& other) const
+{Mask<Tarch> result;result.value=vcleq_f32(value,other.value);return result;}
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator<=(const Number& other) const
+{Mask<Tarch> result;result.value=vcleq_f64(value,other.value);return result;}
+
+
+//------------------------------------//
+//             GREATER EQUALS         //
+//------------------------------------//
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator>=(const Number& other) const
+{Mask<Tarch> result;result.value=vcgeq_f32(value,other.value);return result;}
+
+
+template<> inline
+Mask<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator>=(const Number& other) const
+{Mask<Tarch> result;result.value=vcgeq_f64(value,other.value);return result;}
+
+
+//==============================================================//
+//                                                              //
+//                      BITWISE  OPERATIONS                     //
+//                                                              //
+//==============================================================//
+
+//------------------------------------//
+//             BITWISE XOR            //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::operator^(const Number& other) const
+{Number<Tarch> result;result.value=vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(value),vreinterpretq_u32_f32(other.value)));return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::operator^(const Number& other) const
+{Number<Tarch> result;result.value=vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(value),vreinterpretq_u64_f64(other.value)));return result;}
+
+
+//==============================================================//
+//                                                              //
+//                  ADVANCED OPERATIONS                         //
+//                                                              //
+//==============================================================//
+
+//------------------------------------//
+//              SQUARE ROOT           //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::sqrt() const
+{Number<Tarch> result;result.value=vsqrtq_f32(value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::sqrt() const
+{Number<Tarch> result;result.value=vsqrtq_f64(value);return result;}
+
+
+//------------------------------------//
+//       RECIPROCAL SQUARE ROOT       //
+//------------------------------------//
+
+// vrsqrte only gives ~8 bits; one vrsqrts step brings it past the ~12 bits of
+// _mm256_rsqrt_ps, which the Newton step in the SVD kernels assumes.
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::rsqrt() const
+{
+    Number<Tarch> result;
+    float32x4_t estimate=vrsqrteq_f32(value);
+    estimate=vmulq_f32(estimate,vrsqrtsq_f32(vmulq_f32(value,estimate),estimate));
+    result.value=estimate;
+    return result;
+}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::rsqrt() const
+{
+    Number<Tarch> result;
+    float64x2_t estimate=vrsqrteq_f64(value);
+    estimate=vmulq_f64(estimate,vrsqrtsq_f64(vmulq_f64(value,estimate),estimate));
+    result.value=estimate;
+    return result;
+}
+
+
+//------------------------------------//
+//               MINIMUM              //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> min(const Number<SIMDArchitectureNEON<float>>& A, const Number<SIMDArchitectureNEON<float>>& B)
+{Number<SIMDArchitectureNEON<float>> result;result.value=vminq_f32(A.value, B.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> min(const Number<SIMDArchitectureNEON<double>>& A, const Number<SIMDArchitectureNEON<double>>& B)
+{Number<SIMDArchitectureNEON<double>> result;result.value=vminq_f64(A.value, B.value);return result;}
+
+
+//------------------------------------//
+//               MAXIMUM              //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> max(const Number<SIMDArchitectureNEON<float>>& A, const Number<SIMDArchitectureNEON<float>>& B)
+{Number<SIMDArchitectureNEON<float>> result;result.value=vmaxq_f32(A.value, B.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> max(const Number<SIMDArchitectureNEON<double>>& A, const Number<SIMDArchitectureNEON<double>>& B)
+{Number<SIMDArchitectureNEON<double>> result;result.value=vmaxq_f64(A.value, B.value);return result;}
+
+
+//------------------------------------//
+//      Masked assignment (blend)     //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> blend(const Mask<SIMDArchitectureNEON<float>>& mask, const Number<SIMDArchitectureNEON<float>>& A, const Number<SIMDArchitectureNEON<float>>& B)
+{Number<SIMDArchitectureNEON<float>> result;result.value=vbslq_f32(mask.value,B.value,A.value);return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> blend(const Mask<SIMDArchitectureNEON<double>>& mask, const Number<SIMDArchitectureNEON<double>>& A, const Number<SIMDArchitectureNEON<double>>& B)
+{Number<SIMDArchitectureNEON<double>> result;result.value=vbslq_f64(mask.value,B.value,A.value);return result;}
+
+
+//------------------------------------//
+//      Masked assignment (mask)      //
+//------------------------------------//
+
+
+template<> inline
+Number<SIMDArchitectureNEON<float>> Number<SIMDArchitectureNEON<float>>::mask(const Mask<Tarch>& mask) const
+{Number<Tarch> result;result.value=vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(value),mask.value));return result;}
+
+
+template<> inline
+Number<SIMDArchitectureNEON<double>> Number<SIMDArchitectureNEON<double>>::mask(const Mask<Tarch>& mask) const
+{Number<Tarch> result;result.value=vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(value),mask.value));return result;}
+
+
+//==============================================================//
+//                                                              //
+//                  LOADS AND STORES                            //
+//                                                              //
+//==============================================================//
+
+//------------------------------------//
+//           ALIGNED LOADS            //
+//------------------------------------//
+
+
+template<> inline
+void Number<SIMDArchitectureNEON<float>>::Load_Aligned(const float* data)
+{value=vld1q_f32(data);}
+
+
+template<> inline
+void Number<SIMDArchitectureNEON<double>>::Load_Aligned(const double* data)
+{value=vld1q_f64(data);}
+
+
+template<> inline
+void Number<SIMDArchitectureNEON<float>>::Load_Aligned(const float& data)
+{value=vld1q_f32(&data);}
+
+
+template<> inline
+void Number<SIMDArchitectureNEON<double>>::Load_Aligned(const double& data)
+{value=vld1q_f64(&data);}
+
+
+//------------------------------------//
+//             STORES                 //
+//------------------------------------//
+
+
+template<> inline
+void Store(float* data,const Number<SIMDArchitectureNEON<float>>& number)
+{vst1q_f32(data,number.value);}
+
+
+template<> inline
+void Store(double* data,const Number<SIMDArchitectureNEON<double>>& number)
+{vst1q_f64(data,number.value);}
+
+
+template<> inline
+void Store(float& data,const Number<SIMDArchitectureNEON<float>>& number)
+{vst1q_f32(&data,number.value);}
+
+
+template<> inline
+void Store(double& data,const Number<SIMDArchitectureNEON<double>>& number)
+{vst1q_f64(&data,number.value);}
+
+//==============================================================//
+//==============================================================//
+
+}
@@ -0,0 +1,34 @@
+//#####################################################################
+//  Copyright (c) 2011-2019 Nathan Mitchell, Eftychios Sifakis, Yutian Tao, Qisi Wang.
+//  This file is covered by the FreeBSD license. Please refer to the
+//  license.txt file for more information.
+//#####################################################################
+
+#pragma once
+
+namespace SIMD_Numeric_Kernel {
+    template<class T>
+        struct SIMDArchitectureNEON;
+
+    template<>
+        struct SIMDArchitectureNEON<float>
+    {
+        static constexpr int Width = 4;
+        using Scalar = float;
+        using ScalarRegister = float32x4_t;
+        using MaskRegister = uint32x4_t;
+        static_assert(sizeof(ScalarRegister)/sizeof(Scalar) == Width, "size not matching");
+        static_assert(sizeof(ScalarRegister)%sizeof(Scalar) == 0, "size needs to be multiples");
+    };
+
+    template<>
+        struct SIMDArchitectureNEON<double>
+    {
+        static constexpr int Width = 2;
+        using Scalar = double;
+        using ScalarRegister = float64x2_t;
+        using MaskRegister = uint64x2_t;
+        static_assert(sizeof(ScalarRegister)/sizeof(Scalar) == Width, "size not matching");
+        static_assert(sizeof(ScalarRegister)%sizeof(Scalar) == 0, "size needs to be multiples");
+    };
+}